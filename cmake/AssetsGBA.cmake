@@ -0,0 +1,44 @@
+# Asset archives:
+# Pack files into one archive in ROM for the runtime in src/assets.h. Uses the host tool assetpack from tools/assetpack.
+# assetpack is taken from your PATH or ASSETPACK_EXECUTABLE, else it is built from tools/assetpack, see HostToolsGBA.cmake.
+
+# Pack files into archive NAME and add it to TARGET. Generates NAME.bin, NAME.h and NAME.s in the current binary directory.
+# Include "NAME.h" and call Assets::init(NAME_archive). The asset ids are in namespace NAME. Files are given as
+# path or path=assetname after the keyword for how to store them. SPEED is the LZ4 speed weight, see tools/lz4pack. Example:
+# gba_add_assets(demo.elf demo_assets SPEED 0.05 LZ4 data/title.bin data/font.bin=font RAW data/sine.bin)
+function(gba_add_assets TARGET NAME)
+	cmake_parse_arguments(ASSETS "" "SPEED" "RAW;LZ4;RANS;LZ4RANS;AUTO;BIOS" ${ARGN})
+	gba_find_host_tool(assetpack ASSETPACK_EXECUTABLE)
+	set(OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/${NAME})
+	set(PACK_ARGS "")
+	if(ASSETS_SPEED)
+		list(APPEND PACK_ARGS --speed ${ASSETS_SPEED})
+	endif()
+	list(APPEND PACK_ARGS ${OUTPUT})
+	set(PACK_DEPENDS "")
+	foreach(MODE RAW LZ4 RANS LZ4RANS AUTO BIOS)
+		if(ASSETS_${MODE})
+			string(TOLOWER ${MODE} MODE_FLAG)
+			list(APPEND PACK_ARGS --${MODE_FLAG})
+			foreach(ASSET ${ASSETS_${MODE}})
+				# split off optional asset name
+				set(ASSET_NAME "")
+				if(ASSET MATCHES "^(.+)=([^=/\\\\]+)$")
+					set(ASSET ${CMAKE_MATCH_1})
+					set(ASSET_NAME "=${CMAKE_MATCH_2}")
+				endif()
+				get_filename_component(ASSET_PATH ${ASSET} ABSOLUTE)
+				list(APPEND PACK_ARGS ${ASSET_PATH}${ASSET_NAME})
+				list(APPEND PACK_DEPENDS ${ASSET_PATH})
+			endforeach()
+		endif()
+	endforeach()
+	add_custom_command(
+		OUTPUT ${OUTPUT}.bin ${OUTPUT}.h ${OUTPUT}.s
+		COMMAND ${ASSETPACK_EXECUTABLE} ${PACK_ARGS}
+		DEPENDS ${PACK_DEPENDS} ${ASSETPACK_EXECUTABLE_DEPENDS}
+		COMMENT "Packing asset archive ${NAME}"
+		VERBATIM)
+	target_sources(${TARGET} PRIVATE ${OUTPUT}.s ${OUTPUT}.h)
+	target_include_directories(${TARGET} PRIVATE ${CMAKE_CURRENT_BINARY_DIR})
+endfunction()
@@ -0,0 +1,57 @@
+# Headless test runs:
+# Run a test ROM in mGBA without a window from CTest. Uses mgba-rom-test from your PATH or MGBA_ROM_TEST_EXECUTABLE.
+# mgba-rom-test is built with mGBA when configured with -DBUILD_ROM_TEST=ON. The ROM must print its results with
+# Debug::printf() as "Results: ok" or "Results: FAILED", then print "All tests done" and call SWI 03h (Stop) to end the run.
+# This file is also the script CTest runs, see the end of the file.
+
+set(GBA_EMULATOR_TEST_SCRIPT ${CMAKE_CURRENT_LIST_FILE})
+set(GBA_TESTS_DONE "All tests done")
+
+# Add a CTest test NAME that runs TARGET in mgba-rom-test. The test fails if a result line says FAILED or the ROM does
+# not finish within TIMEOUT seconds (default 300). Skipped with a message if mgba-rom-test is not found. Example:
+# gba_add_emulator_test(tests.elf tests TIMEOUT 120)
+function(gba_add_emulator_test TARGET NAME)
+	cmake_parse_arguments(EMULATOR "" "TIMEOUT" "" ${ARGN})
+	if(NOT EMULATOR_TIMEOUT)
+		set(EMULATOR_TIMEOUT 300)
+	endif()
+	if(NOT MGBA_ROM_TEST_EXECUTABLE)
+		find_program(MGBA_ROM_TEST_EXECUTABLE mgba-rom-test)
+	endif()
+	if(NOT MGBA_ROM_TEST_EXECUTABLE)
+		message(STATUS "mgba-rom-test not found, not adding headless test ${NAME}")
+		return()
+	endif()
+	add_test(NAME ${NAME}
+		COMMAND ${CMAKE_COMMAND}
+			-DEMULATOR=${MGBA_ROM_TEST_EXECUTABLE}
+			-DROM=$<TARGET_FILE:${TARGET}>
+			-DTIMEOUT=${EMULATOR_TIMEOUT}
+			-P ${GBA_EMULATOR_TEST_SCRIPT})
+	# CTest must not kill the run before the script can print the log
+	math(EXPR CTEST_TIMEOUT "${EMULATOR_TIMEOUT} + 30")
+	set_tests_properties(${NAME} PROPERTIES TIMEOUT ${CTEST_TIMEOUT})
+endfunction()
+
+# Script mode: Run ROM in EMULATOR and check the log
+if(CMAKE_SCRIPT_MODE_FILE AND ROM)
+	# stop at SWI 03h, log everything including the mGBA debug output at level 4
+	execute_process(
+		COMMAND ${EMULATOR} -S 3 -l 31 ${ROM}
+		TIMEOUT ${TIMEOUT}
+		RESULT_VARIABLE EMULATOR_RESULT
+		OUTPUT_VARIABLE EMULATOR_LOG
+		ERROR_VARIABLE EMULATOR_LOG)
+	message("${EMULATOR_LOG}")
+	string(REGEX MATCHALL "Results: ok" PASSED "${EMULATOR_LOG}")
+	string(REGEX MATCHALL "Results: FAILED" FAILED "${EMULATOR_LOG}")
+	list(LENGTH PASSED NR_OF_PASSED)
+	list(LENGTH FAILED NR_OF_FAILED)
+	if(NOT EMULATOR_LOG MATCHES "${GBA_TESTS_DONE}")
+		message(FATAL_ERROR "${ROM} did not finish (${EMULATOR_RESULT}). ${NR_OF_PASSED} test(s) ok, ${NR_OF_FAILED} failed before")
+	endif()
+	if(NR_OF_FAILED GREATER 0 OR NR_OF_PASSED EQUAL 0)
+		message(FATAL_ERROR "${NR_OF_PASSED} test(s) ok, ${NR_OF_FAILED} failed")
+	endif()
+	message("${NR_OF_PASSED} test(s) ok")
+endif()
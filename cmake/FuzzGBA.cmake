@@ -0,0 +1,29 @@
+# Decoder test vectors:
+# Generate random and pathological inputs for the LZ4, rANS and ADPCM decoders into ROM for Test::fuzz() in test/gba.
+# Uses the host tool fuzzpack from your PATH or FUZZPACK_EXECUTABLE, else it is built from tools/fuzzpack, see
+# HostToolsGBA.cmake.
+
+# Generate vectors NAME and add them to TARGET. Generates NAME.bin, NAME.h and NAME.s in the current binary directory.
+# Include "NAME.h" to get NAME_vectors. SEED, COUNT and SIZE are passed to fuzzpack. Example:
+# gba_add_fuzz_vectors(tests.elf fuzz SEED 1 COUNT 32)
+function(gba_add_fuzz_vectors TARGET NAME)
+	cmake_parse_arguments(FUZZ "" "SEED;COUNT;SIZE" "" ${ARGN})
+	gba_find_host_tool(fuzzpack FUZZPACK_EXECUTABLE)
+	set(OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/${NAME})
+	set(PACK_ARGS "")
+	foreach(OPTION SEED COUNT SIZE)
+		if(FUZZ_${OPTION})
+			string(TOLOWER ${OPTION} OPTION_FLAG)
+			list(APPEND PACK_ARGS --${OPTION_FLAG} ${FUZZ_${OPTION}})
+		endif()
+	endforeach()
+	list(APPEND PACK_ARGS ${OUTPUT})
+	add_custom_command(
+		OUTPUT ${OUTPUT}.bin ${OUTPUT}.h ${OUTPUT}.s
+		COMMAND ${FUZZPACK_EXECUTABLE} ${PACK_ARGS}
+		DEPENDS ${FUZZPACK_EXECUTABLE_DEPENDS}
+		COMMENT "Generating decoder test vectors ${NAME}"
+		VERBATIM)
+	target_sources(${TARGET} PRIVATE ${OUTPUT}.s ${OUTPUT}.h)
+	target_include_directories(${TARGET} PRIVATE ${CMAKE_CURRENT_BINARY_DIR})
+endfunction()
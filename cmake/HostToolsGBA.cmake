@@ -0,0 +1,40 @@
+# Host tools used during the GBA build:
+# The asset and test vector helpers run host tools from tools/. A tool is taken from the PATH or from the variable
+# given, e.g. ASSETPACK_EXECUTABLE. If it is not found there, it is built from tools/NAME with the host compiler as
+# an external project, so configuring the GBA build does not need the host tools to be built first.
+include(ExternalProject)
+
+set(GBA_HOST_TOOLS_DIR ${CMAKE_CURRENT_LIST_DIR}/../tools)
+
+# Set VARIABLE to the executable of host tool NAME and VARIABLE_DEPENDS to what commands running it must depend on.
+# Example:
+# gba_find_host_tool(assetpack ASSETPACK_EXECUTABLE)
+function(gba_find_host_tool NAME VARIABLE)
+	if(NOT ${VARIABLE})
+		find_program(${VARIABLE} ${NAME})
+	endif()
+	if(${VARIABLE})
+		set(${VARIABLE}_DEPENDS ${${VARIABLE}} PARENT_SCOPE)
+		return()
+	endif()
+	set(TOOL_TARGET host_${NAME})
+	set(TOOL_BINARY_DIR ${CMAKE_BINARY_DIR}/host_tools/${NAME})
+	set(TOOL_EXECUTABLE ${TOOL_BINARY_DIR}/${NAME})
+	if(CMAKE_HOST_WIN32)
+		set(TOOL_EXECUTABLE ${TOOL_EXECUTABLE}.exe)
+	endif()
+	# build the tool only once, even if several targets use it
+	if(NOT TARGET ${TOOL_TARGET})
+		message(STATUS "${NAME} not found, building it from tools/${NAME} with the host compiler")
+		ExternalProject_Add(${TOOL_TARGET}
+			SOURCE_DIR ${GBA_HOST_TOOLS_DIR}/${NAME}
+			BINARY_DIR ${TOOL_BINARY_DIR}
+			CMAKE_ARGS -DCMAKE_BUILD_TYPE=Release
+			# rebuild when the tool or the framework sources it compiles change, so generated data stays current
+			BUILD_ALWAYS ON
+			BUILD_BYPRODUCTS ${TOOL_EXECUTABLE}
+			INSTALL_COMMAND "")
+	endif()
+	set(${VARIABLE} ${TOOL_EXECUTABLE} PARENT_SCOPE)
+	set(${VARIABLE}_DEPENDS ${TOOL_TARGET} ${TOOL_EXECUTABLE} PARENT_SCOPE)
+endfunction()
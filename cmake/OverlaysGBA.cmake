@@ -0,0 +1,17 @@
+# IWRAM code overlays:
+# The devkitARM linker script provides 10 overlay sections .iwram0 - .iwram9. Their code is stored in ROM
+# and all of them are linked to the same IWRAM region, so only one can be loaded at a time with Memory::loadOverlay().
+# Use IWRAM_OVERLAY_FUNC(nr) from sys/base.h to put single functions into an overlay or use the helper below.
+
+# Put functions of source files into IWRAM overlay NR. The files are compiled to ARM code and the
+# functions tagged with IWRAM_OVERLAY_CODE go into the overlay. Example:
+# gba_iwram_overlay(3 effect_fire.cpp effect_water.cpp)
+function(gba_iwram_overlay NR)
+	if(NR LESS 0 OR NR GREATER 9)
+		message(FATAL_ERROR "IWRAM overlay number must be in [0,9], but is ${NR}")
+	endif()
+	foreach(SOURCE_FILE ${ARGN})
+		set_property(SOURCE ${SOURCE_FILE} APPEND PROPERTY COMPILE_DEFINITIONS IWRAM_OVERLAY_NR=${NR})
+		set_property(SOURCE ${SOURCE_FILE} APPEND_STRING PROPERTY COMPILE_FLAGS " -marm")
+	endforeach()
+endfunction()
@@ -0,0 +1,203 @@
+#include "affineslots.h"
+
+#include "sys/base.h"
+
+namespace Sprites
+{
+
+    struct AffineSlotTable
+    {
+        AffineData data[NrOfAffineSlots];   // Shadow copy of matrix data. Stays valid after a slot is released
+        uint32_t hash[NrOfAffineSlots];     // Hash of matrix data
+        int32_t params[NrOfAffineSlots][3]; // Raw angle, sx and sy the matrix was calculated from
+        uint32_t used;                      // Bit n set if slot n is used in this frame
+        uint32_t reserved;                  // Bit n set if slot n is reserved for exclusive use
+        uint32_t dirty;                     // Bit n set if slot n needs to be uploaded
+        uint32_t hasParams;                 // Bit n set if params of slot n are valid
+    } __attribute__((aligned(4), packed));
+
+    EWRAM_BSS AffineSlotTable m_slots;
+
+    inline uint32_t hashMatrix(const AffineData &matrix)
+    {
+        const uint32_t *words = reinterpret_cast<const uint32_t *>(&matrix);
+        return (words[0] * 0x9E3779B1) ^ words[1];
+    }
+
+    inline bool isEqual(const AffineData &a, const AffineData &b)
+    {
+        const uint32_t *wa = reinterpret_cast<const uint32_t *>(&a);
+        const uint32_t *wb = reinterpret_cast<const uint32_t *>(&b);
+        return wa[0] == wb[0] && wa[1] == wb[1];
+    }
+
+    void beginAffineFrame()
+    {
+        m_slots.used = m_slots.reserved;
+    }
+
+    int32_t acquireAffineSlot(const AffineData &matrix)
+    {
+        const uint32_t hash = hashMatrix(matrix);
+        // check if a slot used in this frame has the same data
+        int32_t freeSlot = -1;
+        int32_t freeSlotSameData = -1;
+        for (uint32_t i = 0; i < NrOfAffineSlots; ++i)
+        {
+            const uint32_t bit = 1U << i;
+            if (m_slots.reserved & bit)
+            {
+                continue;
+            }
+            const bool sameData = m_slots.hash[i] == hash && isEqual(m_slots.data[i], matrix);
+            if (m_slots.used & bit)
+            {
+                if (sameData)
+                {
+                    return i;
+                }
+            }
+            else
+            {
+                freeSlot = freeSlot < 0 ? i : freeSlot;
+                freeSlotSameData = (freeSlotSameData < 0 && sameData) ? i : freeSlotSameData;
+            }
+        }
+        // prefer a free slot that still has the same data, so we don't need to upload
+        if (freeSlotSameData >= 0)
+        {
+            m_slots.used |= 1U << freeSlotSameData;
+            return freeSlotSameData;
+        }
+        if (freeSlot >= 0)
+        {
+            const uint32_t bit = 1U << freeSlot;
+            m_slots.data[freeSlot] = matrix;
+            m_slots.hash[freeSlot] = hash;
+            m_slots.used |= bit;
+            m_slots.dirty |= bit;
+            m_slots.hasParams &= ~bit;
+        }
+        return freeSlot;
+    }
+
+    int32_t acquireAffineSlot(Math::fp1616_t angle, Math::fp1616_t sx, Math::fp1616_t sy)
+    {
+        // check if a slot was calculated from the same parameters, so we can skip the trigonometry
+        int32_t freeSlotSameParams = -1;
+        uint32_t candidates = m_slots.hasParams & ~m_slots.reserved;
+        while (candidates != 0)
+        {
+            const uint32_t i = __builtin_ctz(candidates);
+            candidates &= ~(1U << i);
+            if (m_slots.params[i][0] == angle.raw() && m_slots.params[i][1] == sx.raw() && m_slots.params[i][2] == sy.raw())
+            {
+                if (m_slots.used & (1U << i))
+                {
+                    return i;
+                }
+                freeSlotSameParams = freeSlotSameParams < 0 ? i : freeSlotSameParams;
+            }
+        }
+        if (freeSlotSameParams >= 0)
+        {
+            // a different angle may have produced the same matrix and already be in use this frame
+            return acquireAffineSlot(m_slots.data[freeSlotSameParams]);
+        }
+        const int32_t slot = acquireAffineSlot(calculateAffineData(angle, sx, sy));
+        if (slot >= 0)
+        {
+            m_slots.params[slot][0] = angle.raw();
+            m_slots.params[slot][1] = sx.raw();
+            m_slots.params[slot][2] = sy.raw();
+            m_slots.hasParams |= 1U << slot;
+        }
+        return slot;
+    }
+
+    bool assignAffineSlot(Sprite2D &sprite, Math::fp1616_t angle, Math::fp1616_t sx, Math::fp1616_t sy)
+    {
+        const int32_t slot = acquireAffineSlot(angle, sx, sy);
+        if (slot < 0)
+        {
+            return false;
+        }
+        sprite.matrixIndex = slot;
+        sprite.matrix = m_slots.data[slot];
+        return true;
+    }
+
+    int32_t reserveAffineSlot()
+    {
+        // take slots from the end, so shared slots stay low
+        for (int32_t i = NrOfAffineSlots - 1; i >= 0; --i)
+        {
+            const uint32_t bit = 1U << i;
+            if ((m_slots.used & bit) == 0)
+            {
+                m_slots.used |= bit;
+                m_slots.reserved |= bit;
+                m_slots.hasParams &= ~bit;
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void releaseAffineSlot(uint32_t slot)
+    {
+        if (slot < NrOfAffineSlots)
+        {
+            const uint32_t bit = 1U << slot;
+            m_slots.used &= ~bit;
+            m_slots.reserved &= ~bit;
+        }
+    }
+
+    void updateAffineSlot(uint32_t slot, const AffineData &matrix)
+    {
+        if (slot < NrOfAffineSlots)
+        {
+            const uint32_t hash = hashMatrix(matrix);
+            if (m_slots.hash[slot] != hash || !isEqual(m_slots.data[slot], matrix))
+            {
+                m_slots.data[slot] = matrix;
+                m_slots.hash[slot] = hash;
+                m_slots.dirty |= 1U << slot;
+            }
+            m_slots.hasParams &= ~(1U << slot);
+        }
+    }
+
+    void clearAffineSlots()
+    {
+        // clearOAM() zeroes all matrices, so the shadow copy must be zero too. a matrix acquired again is then uploaded again
+        for (uint32_t i = 0; i < NrOfAffineSlots; ++i)
+        {
+            m_slots.data[i] = {0, 0, 0, 0};
+            m_slots.hash[i] = 0;
+        }
+        m_slots.used = 0;
+        m_slots.reserved = 0;
+        m_slots.dirty = 0;
+        m_slots.hasParams = 0;
+    }
+
+    void uploadAffineSlots()
+    {
+        uint32_t dirty = m_slots.dirty;
+        while (dirty != 0)
+        {
+            const uint32_t slot = __builtin_ctz(dirty);
+            setMatrixOAM(slot, m_slots.data[slot]);
+            dirty &= ~(1U << slot);
+        }
+        m_slots.dirty = 0;
+    }
+
+    uint32_t usedAffineSlots()
+    {
+        return __builtin_popcount(m_slots.used);
+    }
+
+} // namespace Sprites
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "math/fp32.h"
+#include "sprites.h"
+
+#include <cstdint>
+
+// Management of the 32 affine matrices in OAM.
+// Identical matrices share a slot, so rotating sprite swarms need less trigonometry and OAM writes.
+// Call beginAffineFrame() before assigning the matrices of a frame. Slots not acquired again are recycled.
+// Matrix data is kept in a shadow copy and only changed slots are written with setMatrixOAM() in uploadAffineSlots().
+namespace Sprites
+{
+
+    /// @brief Number of affine matrices in OAM.
+    constexpr uint32_t NrOfAffineSlots = 32;
+
+    /// @brief Start a new frame. Releases all slots except reserved ones, but keeps their contents,
+    /// so an identical matrix acquired again gets the same slot and needs no upload.
+    void beginAffineFrame();
+
+    /// @brief Get a slot containing the matrix. Reuses a slot with identical contents if possible.
+    /// @return Returns the slot index for Sprite2D::matrixIndex or -1 if all slots are in use.
+    int32_t acquireAffineSlot(const AffineData &matrix);
+
+    /// @brief Get a slot containing the matrix for rotation angle and scale.
+    /// Only calls calculateAffineData() if no slot was set up with the same parameters in this or the last frame.
+    /// @return Returns the slot index for Sprite2D::matrixIndex or -1 if all slots are in use.
+    int32_t acquireAffineSlot(Math::fp1616_t angle, Math::fp1616_t sx = 1, Math::fp1616_t sy = 1);
+
+    /// @brief Acquire a slot for rotation angle and scale and store slot index and matrix in sprite.
+    /// @return Returns false if all slots are in use. The sprite is not changed then.
+    bool assignAffineSlot(Sprite2D &sprite, Math::fp1616_t angle, Math::fp1616_t sx = 1, Math::fp1616_t sy = 1);
+
+    /// @brief Reserve a slot for exclusive use. Reserved slots are not shared or recycled in beginAffineFrame().
+    /// @return Returns the slot index or -1 if all slots are in use.
+    int32_t reserveAffineSlot();
+
+    /// @brief Release a slot reserved with reserveAffineSlot().
+    void releaseAffineSlot(uint32_t slot);
+
+    /// @brief Change the matrix of a reserved slot. Only uploaded if the contents actually changed.
+    void updateAffineSlot(uint32_t slot, const AffineData &matrix);
+
+    /// @brief Release all slots, including reserved ones, and forget their contents.
+    /// Called by clearOAM(), because that sets all matrices in OAM to zero.
+    void clearAffineSlots();
+
+    /// @brief Write changed slots to (shadow) OAM using setMatrixOAM().
+    /// Call once per frame after all matrices have been acquired, before uploadOAM().
+    void uploadAffineSlots();
+
+    /// @brief Number of slots currently used.
+    uint32_t usedAffineSlots();
+
+} // namespace Sprites
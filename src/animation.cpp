@@ -1,6 +1,7 @@
 #include "animation.h"
 
 #include "memory/memory.h"
+#include "memory/pool.h"
 #include "sys/base.h"
 
 //#define DEBUG_ANIMATION
@@ -25,9 +26,16 @@ namespace Animation
         bool active;                                                    /// True if the sequence is active
     } __attribute__((packed));
 
+    /// @brief Keyframe storage for one sequence
+    struct KeyframeBlock
+    {
+        Keyframe keyframes[MaxKeyframes];
+    };
+
 #define MAX_SEQUENCES 16
     Sequence sequences[MAX_SEQUENCES] EWRAM_DATA;
     uint16_t nrOfSequences EWRAM_DATA = 0;
+    Memory::Pool<KeyframeBlock, MAX_SEQUENCES> keyframeBlocks EWRAM_BSS;
 
     uint32_t addSequence(Math::fp1616_t startTime, void (*updateFunc)(Math::fp1616_t, const void *, const void *), uint8_t nrOfKeyframes, RepeatMode repeatMode, uint8_t repeatCount, bool start)
     {
@@ -36,7 +44,8 @@ namespace Animation
             auto &sequence = sequences[nrOfSequences];
             sequence.startTime = startTime;
             sequence.updateFunc = updateFunc;
-            sequence.keyframes = Memory::malloc_EWRAM<Keyframe>(nrOfKeyframes);
+            // sequences with more keyframes than fit into a block fall back to the heap
+            sequence.keyframes = nrOfKeyframes <= MaxKeyframes ? keyframeBlocks.acquire()->keyframes : Memory::malloc_EWRAM<Keyframe>(nrOfKeyframes);
             sequence.nrOfKeyframes = 0;
             sequence.maxKeyframes = nrOfKeyframes;
             sequence.direction = DirectionMode::Forward;
@@ -133,9 +142,14 @@ namespace Animation
 #ifdef DEBUG_ANIMATION
                 printf("Sequence %d - Keyframes %x", uint32_t(i), sequences[i].keyframes);
 #endif
-                // free memory
-                Memory::free(sequences[i].keyframes);
+                // free keyframes that did not fit into a block
+                if (!keyframeBlocks.contains(reinterpret_cast<const KeyframeBlock *>(sequences[i].keyframes)))
+                {
+                    Memory::free(sequences[i].keyframes);
+                }
             }
+            // return all keyframe blocks at once
+            keyframeBlocks.clear();
             Memory::memset32(sequences, 0, nrOfSequences * sizeof(Sequence) / 4);
             nrOfSequences = 0;
         }
@@ -43,12 +43,16 @@ namespace Animation
         bool isEmpty;          /// True if empty. Usefull to pause an animation
     } __attribute__((packed));
 
+    /// @brief Maximum number of keyframes per sequence that are stored in a fixed-size block from a pool,
+    /// so the memory for them can not fragment the heap. Sequences with more keyframes allocate them on the heap.
+    constexpr uint8_t MaxKeyframes = 16;
+
     /// @brief Add an animation sequence.
     /// @param startTime Global start time for sequence.
     /// @param updateFunc Function to be called every update().
     /// This will pass the time from the startTime of this keyframe to the current position inside the keyframe [0,1].
     /// Additionally the current and the next "data" pointers are passed.
-    /// @param nrOfKeyframe Maximum number of all keyframes in sequence.
+    /// @param nrOfKeyframe Maximum number of all keyframes in sequence. Up to MaxKeyframes keyframes come from a pool.
     /// @param repeatMode Repeat mode of whole sequence.
     /// @param repeatCount How many times to repeat the sequence until it stops.
     /// @param start Pass true to start the sequence.
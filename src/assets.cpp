@@ -0,0 +1,260 @@
+#include "assets.h"
+
+#include "compression/lz4.h"
+#include "memory/memory.h"
+#include "sys/base.h"
+
+#ifndef TARGET_PC
+#include "compression/bios.h"
+#include "compression/lz77.h"
+#include "compression/rans.h"
+#endif
+
+namespace Assets
+{
+
+    struct CacheEntry
+    {
+        uint32_t id;       // Asset id
+        uint8_t *data;     // Decompressed data in EWRAM. nullptr if entry is free
+        uint32_t size;     // Allocated size
+        uint32_t lastUsed; // Use counter value of last get()
+    } __attribute__((aligned(4), packed));
+
+    const ArchiveHeader *m_archive = nullptr;
+    uint32_t m_cacheBudget = DefaultCacheBudget;
+    uint32_t m_useCounter = 0;
+    EWRAM_BSS CacheEntry m_cache[MaxCachedAssets];
+    CacheStats m_stats = {0, 0, 0, 0, 0};
+
+    inline const ArchiveEntry *entries()
+    {
+        return reinterpret_cast<const ArchiveEntry *>(m_archive + 1);
+    }
+
+    // Binary search in sorted index
+    const ArchiveEntry *findEntry(uint32_t id)
+    {
+        if (m_archive == nullptr)
+        {
+            return nullptr;
+        }
+        auto index = entries();
+        uint32_t first = 0;
+        uint32_t last = m_archive->nrOfEntries;
+        while (first < last)
+        {
+            const uint32_t middle = (first + last) >> 1;
+            if (index[middle].id < id)
+            {
+                first = middle + 1;
+            }
+            else
+            {
+                last = middle;
+            }
+        }
+        return (first < m_archive->nrOfEntries && index[first].id == id) ? &index[first] : nullptr;
+    }
+
+    CacheEntry *findCached(uint32_t id)
+    {
+        for (auto &entry : m_cache)
+        {
+            if (entry.data != nullptr && entry.id == id)
+            {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    void freeEntry(CacheEntry &entry)
+    {
+        Memory::free(entry.data);
+        entry.data = nullptr;
+        m_stats.entries--;
+        m_stats.bytes -= entry.size;
+    }
+
+    // Evict least recently used entry. Returns false if the cache is empty
+    bool evictLeastRecentlyUsed()
+    {
+        CacheEntry *oldest = nullptr;
+        for (auto &entry : m_cache)
+        {
+            if (entry.data != nullptr && (oldest == nullptr || (m_useCounter - entry.lastUsed) > (m_useCounter - oldest->lastUsed)))
+            {
+                oldest = &entry;
+            }
+        }
+        if (oldest == nullptr)
+        {
+            return false;
+        }
+        freeEntry(*oldest);
+        m_stats.evictions++;
+        return true;
+    }
+
+    // Decompress entry to dst. Returns false if the codec is not supported or the decoder failed
+    bool decompress(const ArchiveEntry &entry, void *dst)
+    {
+        const uint8_t *src = reinterpret_cast<const uint8_t *>(m_archive) + entry.offset;
+        switch (entry.codec)
+        {
+        case Codec::LZ4:
+#ifdef TARGET_PC
+            Compression::LZ4UnCompWrite8bit(reinterpret_cast<const uint32_t *>(src), reinterpret_cast<uint32_t *>(dst));
+#else
+            Compression::LZ4UnCompWrite8bit_ASM(reinterpret_cast<const uint32_t *>(src), reinterpret_cast<uint32_t *>(dst));
+#endif
+            return true;
+#ifndef TARGET_PC
+        case Codec::LZ77:
+            Compression::LZ77UnCompWrite8bit_ASM(src, dst);
+            return true;
+        case Codec::RL:
+            Compression::RLUnCompReadNormalWrite8bit(src, dst);
+            return true;
+        case Codec::RANS:
+        case Codec::RANSLZ4:
+            return Compression::RANSUnCompWrite8bitIWRAM(reinterpret_cast<const uint32_t *>(src), reinterpret_cast<uint32_t *>(dst));
+#endif
+        default:
+            return false;
+        }
+    }
+
+    bool init(const void *archive, uint32_t cacheBudget)
+    {
+        clearCache();
+        resetCacheStats();
+        m_cacheBudget = cacheBudget;
+        auto header = reinterpret_cast<const ArchiveHeader *>(archive);
+        m_archive = (header != nullptr && header->magic == ArchiveMagic) ? header : nullptr;
+        return m_archive != nullptr;
+    }
+
+    const void *get(uint32_t id)
+    {
+        auto entry = findEntry(id);
+        if (entry == nullptr)
+        {
+            return nullptr;
+        }
+        if (entry->codec == Codec::Raw)
+        {
+            return reinterpret_cast<const uint8_t *>(m_archive) + entry->offset;
+        }
+        m_useCounter++;
+        auto cached = findCached(id);
+        if (cached != nullptr)
+        {
+            cached->lastUsed = m_useCounter;
+            m_stats.hits++;
+            return cached->data;
+        }
+        m_stats.misses++;
+        // make room in cache. decoders may write whole words, so round size up
+        const uint32_t size = (entry->uncompressedSize + 3) & ~3;
+        if (size > m_cacheBudget)
+        {
+            return nullptr;
+        }
+        while (m_stats.entries >= MaxCachedAssets || m_stats.bytes + size > m_cacheBudget)
+        {
+            evictLeastRecentlyUsed();
+        }
+        void *data = Memory::malloc_EWRAM(size);
+        while (data == nullptr && evictLeastRecentlyUsed())
+        {
+            data = Memory::malloc_EWRAM(size);
+        }
+        if (data == nullptr)
+        {
+            return nullptr;
+        }
+        if (!decompress(*entry, data))
+        {
+            Memory::free(data);
+            return nullptr;
+        }
+        for (auto &free : m_cache)
+        {
+            if (free.data == nullptr)
+            {
+                free = {id, static_cast<uint8_t *>(data), size, m_useCounter};
+                break;
+            }
+        }
+        m_stats.entries++;
+        m_stats.bytes += size;
+        return data;
+    }
+
+    uint32_t size(uint32_t id)
+    {
+        auto entry = findEntry(id);
+        return entry != nullptr ? entry->uncompressedSize : 0;
+    }
+
+    const void *getStored(uint32_t id)
+    {
+        auto entry = findEntry(id);
+        return entry != nullptr ? reinterpret_cast<const uint8_t *>(m_archive) + entry->offset : nullptr;
+    }
+
+    uint32_t storedSize(uint32_t id)
+    {
+        auto entry = findEntry(id);
+        return entry != nullptr ? entry->storedSize : 0;
+    }
+
+    bool isCached(uint32_t id)
+    {
+        return findCached(id) != nullptr;
+    }
+
+    void evict(uint32_t id)
+    {
+        auto cached = findCached(id);
+        if (cached != nullptr)
+        {
+            freeEntry(*cached);
+        }
+    }
+
+    void clearCache()
+    {
+        for (auto &entry : m_cache)
+        {
+            if (entry.data != nullptr)
+            {
+                freeEntry(entry);
+            }
+        }
+    }
+
+    void setCacheBudget(uint32_t bytes)
+    {
+        m_cacheBudget = bytes;
+        while (m_stats.bytes > m_cacheBudget)
+        {
+            evictLeastRecentlyUsed();
+        }
+    }
+
+    CacheStats cacheStats()
+    {
+        return m_stats;
+    }
+
+    void resetCacheStats()
+    {
+        m_stats.hits = 0;
+        m_stats.misses = 0;
+        m_stats.evictions = 0;
+    }
+
+} // namespace Assets
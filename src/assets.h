@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+
+// Asset archive in ROM, packed at build time with tools/assetpack and gba_add_assets() from cmake/AssetsGBA.cmake.
+// Uncompressed assets are returned as ROM pointers. Compressed assets are decompressed on first use into an EWRAM cache
+// and stay there until they are evicted, least recently used first, so loading a scene again skips decompression.
+namespace Assets
+{
+
+    /// @brief Archive magic "ASAR".
+    constexpr uint32_t ArchiveMagic = 0x52415341;
+
+    /// @brief Storage format of an asset. Values match the type byte of the GBA compression headers.
+    enum class Codec : uint8_t
+    {
+        Raw = 0x00,    // Uncompressed. Returned from ROM
+        LZ77 = 0x10,   // LZ77 10h, decoded with Compression::LZ77UnCompWrite8bit_ASM
+        RL = 0x30,     // Run-length 30h, decoded with the BIOS
+        LZ4 = 0x40,    // LZ4 40h, decoded with Compression::LZ4UnCompWrite8bit_ASM
+        RANS = 0x50,   // rANS 50h, decoded with Compression::RANSUnCompWrite8bitIWRAM
+        RANSLZ4 = 0x51 // LZ4 + rANS 51h, decoded with Compression::RANSUnCompWrite8bitIWRAM
+    };
+
+    /// @brief Archive header. Followed by nrOfEntries entries sorted by id, followed by asset data.
+    struct ArchiveHeader
+    {
+        uint32_t magic;       // ArchiveMagic
+        uint32_t nrOfEntries; // Number of entries in index
+    } __attribute__((aligned(4), packed));
+
+    /// @brief Index entry of an asset.
+    struct ArchiveEntry
+    {
+        uint32_t id;               // Asset id. Assets::id() of asset name
+        uint32_t offset;           // Offset of data from start of archive. Multiple of 4
+        uint32_t storedSize;       // Size of data in archive, including compression header
+        uint32_t uncompressedSize; // Size of data after decompression
+        Codec codec;               // Storage format
+        uint8_t padding[3];
+    } __attribute__((aligned(4), packed));
+
+    /// @brief Asset id from asset name. FNV-1a hash of the name. assetpack generates constants for all ids.
+    constexpr uint32_t id(const char *name)
+    {
+        uint32_t hash = 0x811C9DC5;
+        while (*name != '\0')
+        {
+            hash = (hash ^ static_cast<uint8_t>(*name++)) * 0x01000193;
+        }
+        return hash;
+    }
+
+    /// @brief Default number of EWRAM bytes the cache may use.
+    constexpr uint32_t DefaultCacheBudget = 96 * 1024;
+
+    /// @brief Maximum number of cached assets.
+    constexpr uint32_t MaxCachedAssets = 32;
+
+    /// @brief Cache statistics.
+    struct CacheStats
+    {
+        uint32_t hits;      // get() calls served from cache
+        uint32_t misses;    // get() calls that had to decompress
+        uint32_t evictions; // Entries evicted to make room
+        uint32_t entries;   // Number of cached assets
+        uint32_t bytes;     // EWRAM bytes used by cached assets
+    } __attribute__((aligned(4), packed));
+
+    /// @brief Use archive for all following calls. Clears the cache.
+    /// @param archive Archive data, e.g. the symbol generated by gba_add_assets().
+    /// @param cacheBudget Maximum number of EWRAM bytes used for decompressed assets.
+    /// @return Returns false if the archive is invalid.
+    bool init(const void *archive, uint32_t cacheBudget = DefaultCacheBudget);
+
+    /// @brief Get asset data. Uncompressed assets are returned from ROM. Compressed assets are decompressed into the cache on first use.
+    /// Pointers to cached data stay valid until the entry is evicted, which can happen in any later get() of a
+    /// compressed asset, setCacheBudget(), evict() or clearCache(). Copy data you need for longer.
+    /// @return Returns a pointer to the data or nullptr if the id is unknown, the data does not fit into EWRAM or can not be decompressed,
+    /// e.g. because the codec is not supported or the decoder ran out of memory. Nothing is cached then.
+    const void *get(uint32_t id);
+
+    /// @brief Get asset data as T. See get(uint32_t).
+    template <typename T>
+    const T *get(uint32_t id)
+    {
+        return reinterpret_cast<const T *>(get(id));
+    }
+
+    /// @brief Get uncompressed size of asset in bytes or 0 if the id is unknown.
+    uint32_t size(uint32_t id);
+
+    /// @brief Get asset data as stored in the archive, including the compression header for compressed assets.
+    /// Use this to decode assets yourself, e.g. to VRAM. Never touches the cache.
+    /// @return Returns a pointer to the data in ROM or nullptr if the id is unknown.
+    const void *getStored(uint32_t id);
+
+    /// @brief Get size of asset data as stored in the archive in bytes or 0 if the id is unknown.
+    uint32_t storedSize(uint32_t id);
+
+    /// @brief Check if asset data is in the cache.
+    bool isCached(uint32_t id);
+
+    /// @brief Remove asset from cache, freeing its memory.
+    void evict(uint32_t id);
+
+    /// @brief Remove all assets from cache, freeing their memory.
+    void clearCache();
+
+    /// @brief Set maximum number of EWRAM bytes used for decompressed assets. Evicts entries if needed.
+    void setCacheBudget(uint32_t bytes);
+
+    /// @brief Get cache statistics.
+    CacheStats cacheStats();
+
+    /// @brief Reset hit, miss and eviction counters.
+    void resetCacheStats();
+
+} // namespace Assets
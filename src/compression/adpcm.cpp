@@ -9,6 +9,13 @@
 
 namespace Adpcm
 {
+    // Read the verbatim first sample of a channel block. Blocks of odd size put the second channel at an odd address,
+    // so read it byte by byte
+    FORCEINLINE int32_t readFirstSample(const uint8_t *block)
+    {
+        return static_cast<int16_t>(block[0] | (block[1] << 8));
+    }
+
     void IWRAM_FUNC UnCompWrite32bit_8bit(const uint32_t *data, uint32_t dataSize, uint32_t *dst)
     {
         //  copy frame header and skip to data
@@ -21,9 +28,9 @@ namespace Adpcm
         for (uint32_t channel = 0; channel < frameHeader.nrOfChannels; ++channel)
         {
             // align output buffer to next word boundary
-            dst8 = reinterpret_cast<uint8_t *>((reinterpret_cast<uint32_t>(dst8) + 3) & 0xFFFFFFFC);
+            dst8 = reinterpret_cast<uint8_t *>((reinterpret_cast<uintptr_t>(dst8) + 3) & ~uintptr_t(3));
             // first sample is stored verbatim in header
-            int32_t pcmData = *reinterpret_cast<const int16_t *>(data8);
+            int32_t pcmData = readFirstSample(data8);
 #ifdef ADPCM_DITHER
             pcmData += (ADPCM_DitherState[1] >> ADPCM_DITHER_SHIFT) - ADPCM_DitherState[0];
             ADPCM_DitherState[0] = ADPCM_DitherState[1] >> ADPCM_DITHER_SHIFT;
@@ -36,7 +43,8 @@ namespace Adpcm
 #else
             *dst8++ = pcmData >> 8;
 #endif
-            int32_t index = *reinterpret_cast<const int16_t *>(data8 + 2);
+            // only the low byte of the index is used
+            int32_t index = data8[2];
             data8 += 4;
             uint32_t bytesLeft = adpcmChannelBlockSize - 4;
             while (bytesLeft--)
@@ -94,6 +102,83 @@ namespace Adpcm
         }
     }
 
+    // Dither a left and right PCM sample with the same dither value. Same steps as Adpcm_UnCompWriteStereo32bit_8bit.
+    // Both channels need to see every dither value, else the differences of consecutive values don't cancel out and
+    // the predictors drift
+    FORCEINLINE void ditherStereo(int32_t &pcmLeft, int32_t &pcmRight)
+    {
+#ifdef ADPCM_DITHER
+        const int32_t dither = (ADPCM_DitherState[1] >> ADPCM_DITHER_SHIFT) - ADPCM_DitherState[0];
+        ADPCM_DitherState[0] = ADPCM_DitherState[1] >> ADPCM_DITHER_SHIFT;
+        ADPCM_DitherState[1] = ((ADPCM_DitherState[1] << 4) - ADPCM_DitherState[1]) ^ 1;
+        pcmLeft += dither;
+        pcmRight += dither;
+#endif
+    }
+
+    // Clamp PCM sample to [-32768, 32767] and convert to 8-bit. Same steps as Adpcm_UnCompWriteStereo32bit_8bit
+    FORCEINLINE int8_t clampAndConvert(int32_t &pcmData)
+    {
+        pcmData = pcmData < -32768 ? -32768 : pcmData;
+        pcmData = pcmData > 32767 ? 32767 : pcmData;
+#ifdef ADPCM_ROUNDING
+        return (pcmData + 128) >> 8;
+#else
+        return pcmData >> 8;
+#endif
+    }
+
+    // Apply ADPCM nibble to PCM data and index
+    FORCEINLINE void decodeNibble(int32_t &pcmData, int32_t &index, uint32_t nibble)
+    {
+        const uint32_t delta = ADPCM_DeltaTable_4bit[index][nibble & 0x07];
+        if (nibble & 8)
+            pcmData -= delta;
+        else
+            pcmData += delta;
+        index += ADPCM_IndexTable_4bit[nibble & 0x07];
+        index = index < 0 ? 0 : index;
+        index = index > 88 ? 88 : index;
+    }
+
+    void IWRAM_FUNC UnCompWriteStereo32bit_8bit(const uint32_t *data, uint32_t dataSize, uint32_t *dstLeft, uint32_t *dstRight)
+    {
+        // skip frame header. channels are stored planar, so right channel data directly follows left channel data
+        auto left8 = reinterpret_cast<const uint8_t *>(data + sizeof(Audio::AdpcmFrameHeader) / 4);
+        const auto adpcmChannelBlockSize = (dataSize - sizeof(Audio::AdpcmFrameHeader)) / 2;
+        auto right8 = left8 + adpcmChannelBlockSize;
+        auto dstLeft8 = reinterpret_cast<int8_t *>(dstLeft);
+        auto dstRight8 = reinterpret_cast<int8_t *>(dstRight);
+        // first sample is stored verbatim in header
+        int32_t pcmLeft = readFirstSample(left8);
+        int32_t indexLeft = left8[2];
+        int32_t pcmRight = readFirstSample(right8);
+        int32_t indexRight = right8[2];
+        ditherStereo(pcmLeft, pcmRight);
+        *dstLeft8++ = clampAndConvert(pcmLeft);
+        *dstRight8++ = clampAndConvert(pcmRight);
+        for (uint32_t i = 4; i < adpcmChannelBlockSize; ++i)
+        {
+            // get two ADPCM nibbles per channel
+            const uint32_t nibblesLeft = left8[i];
+            const uint32_t nibblesRight = right8[i];
+            decodeNibble(pcmLeft, indexLeft, nibblesLeft);
+            decodeNibble(pcmRight, indexRight, nibblesRight);
+            ditherStereo(pcmLeft, pcmRight);
+            *dstLeft8++ = clampAndConvert(pcmLeft);
+            *dstRight8++ = clampAndConvert(pcmRight);
+            // decode second nibble only if not last sample
+            if (i < adpcmChannelBlockSize - 1)
+            {
+                decodeNibble(pcmLeft, indexLeft, nibblesLeft >> 4);
+                decodeNibble(pcmRight, indexRight, nibblesRight >> 4);
+                ditherStereo(pcmLeft, pcmRight);
+                *dstLeft8++ = clampAndConvert(pcmLeft);
+                *dstRight8++ = clampAndConvert(pcmRight);
+            }
+        }
+    }
+
     uint32_t IWRAM_FUNC UnCompGetSize_8bit(const uint32_t *data)
     {
         const Audio::AdpcmFrameHeader frameHeader = Audio::AdpcmFrameHeader::read(data);
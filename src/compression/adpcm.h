@@ -4,11 +4,20 @@
 
 #include <cstdint>
 
-/// @brief Decode 4-bit ADPCM sample data and truncate/dither to 8bit. Written in ARMv4 assembler
+/// @brief Decode 4-bit ADPCM sample data and truncate/dither to 8bit. Written in ARMv4 assembler. Output matches Adpcm::UnCompWrite32bit_8bit
 /// @param data Pointer to 4-bit ADPCM data
-/// @param dst Pointer to output sample buffer(s)
+/// @param dst Pointer to output sample buffer. Must be 4-byte-aligned. Stereo data is decoded planar, the right channel
+/// starts at the next word boundary after the left channel
 extern "C" auto Adpcm_UnCompWrite32bit_8bit(const uint32_t *data, uint32_t dataSize, uint32_t *dst) -> void;
 
+/// @brief Decode 4-bit stereo ADPCM sample data and truncate/dither to 8bit. Written in ARMv4 assembler
+/// Decodes both channels in lockstep into separate buffers, e.g. for the DirectSound FIFOs. Output matches Adpcm::UnCompWriteStereo32bit_8bit
+/// @param data Pointer to 4-bit ADPCM data. Must be 4-byte-aligned
+/// @param dstLeft Pointer to output sample buffer for the left channel
+/// @param dstRight Pointer to output sample buffer for the right channel
+/// @note Frames need at least one ADPCM data byte per channel after the initial sample and index
+extern "C" auto Adpcm_UnCompWriteStereo32bit_8bit(const uint32_t *data, uint32_t dataSize, uint32_t *dstLeft, uint32_t *dstRight) -> void;
+
 /// @brief Get stored uncompressed size of sample data after decoding and truncating to 8-bit. Written in ARMv4 assembler
 /// @param data Pointer to ADPCM data
 /// @note Only sample depths of (8, 16, 24, 32) are supported!
@@ -18,9 +27,19 @@ namespace Adpcm
 {
     /// @brief Decode 4-bit ADPCM sample data
     /// @param data Pointer to 4-bit ADPCM data
-    /// @param dst Pointer to output sample buffer(s)
+    /// @param dst Pointer to output sample buffer. Must be 4-byte-aligned. Stereo data is decoded planar, the right
+    /// channel starts at the next word boundary after the left channel
     auto UnCompWrite32bit_8bit(const uint32_t *data, uint32_t dataSize, uint32_t *dst) -> void;
 
+    /// @brief Decode 4-bit stereo ADPCM sample data into separate left and right buffers.
+    /// Samples are decoded in the order L0 R0 L1 R1... The dither state advances once per sample pair and both channels
+    /// get the same dither value, so the dither of each channel cancels out over time like in the mono decoder.
+    /// Reference implementation of Adpcm_UnCompWriteStereo32bit_8bit
+    /// @param data Pointer to 4-bit ADPCM data
+    /// @param dstLeft Pointer to output sample buffer for the left channel
+    /// @param dstRight Pointer to output sample buffer for the right channel
+    auto UnCompWriteStereo32bit_8bit(const uint32_t *data, uint32_t dataSize, uint32_t *dstLeft, uint32_t *dstRight) -> void;
+
     /// @brief Get stored uncompressed size of sample data after decoding
     /// @param data Pointer to ADPCM data
     auto UnCompGetSize_8bit(const uint32_t *data) -> uint32_t;
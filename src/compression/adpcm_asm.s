@@ -22,7 +22,8 @@ Adpcm_UnCompWrite32bit_8bit:
     @ Decode a frame of ADPCM data
     @ r0: pointer to ADPCM frame data, must be 4-byte-aligned (trashed)
     @ r1: size of ADPCM frame data (trashed)
-    @ r2: pointer to the 8bit sample buffer, must be 4-byte-aligned (trashed)
+    @ r2: pointer to the 8bit sample buffer, must be 4-byte-aligned. Channels are stored one after the other, each
+    @ starting at the next word boundary (trashed)
     @ r3 trashed, r4-r12 and r14 used and saved / restored
     @ r6,r7 are scratch registers
     push {r4 - r12, r14}
@@ -50,7 +51,15 @@ Adpcm_UnCompWrite32bit_8bit:
     @ r3 = PCM data
     @ r4 = Current ADPCM index
     @ r5 = Current ADPCM byte (2*4 bit data)
-    ldrsh r3, [r0], #2 @ load first verbatim PCM sample to r3
+    @ every channel starts at a word boundary, like in Adpcm::UnCompWrite32bit_8bit
+    add r2, r2, #3
+    bic r2, r2, #3
+    @ blocks of odd size put the second channel at an odd address, so load the block header byte by byte
+    ldrb r3, [r0], #1 @ load first verbatim PCM sample to r3
+    ldrb r7, [r0], #1
+    orr r3, r3, r7, lsl #8
+    mov r3, r3, lsl #16 @ sign-extend
+    mov r3, r3, asr #16
 #ifdef ADPCM_DITHER
     @ dither PCM data in r3
     sub r3, r3, r11 @ pcmData -= last_dither
@@ -64,7 +73,8 @@ Adpcm_UnCompWrite32bit_8bit:
     @ clamp PCM data in r3 to [-32768, 32767]
     mov r7, r3, lsl #16 @ r7 = r3 << 16
     cmp r3, r7, asr #16 @ shift back and sign-extend r7 and compare with r3. check if r3 fits into signed 16-bit
-    eorne r7, r3, r8, asr #31 @ extract sign bit of r3. xor with r8 and apply to saturate
+    movne r3, r3, asr #31 @ else saturate to 0x7FFF or 0xFFFF8000
+    eorne r3, r3, r8, lsr #16
 #endif
 #ifdef ADPCM_ROUNDING
     add r7, r3, #128 @ r7 = pcmData + 128
@@ -73,7 +83,7 @@ Adpcm_UnCompWrite32bit_8bit:
     mov r7, r3, asr #8 @ r7 = pcmData >> 8
 #endif
     strb r7, [r2], #1 @ store first 8-bit PCM sample
-    ldrsh r4, [r0], #2 @ load first index into r4
+    ldrb r4, [r0], #2 @ load first index into r4. only the low byte is used
     sub r14, r1, #4 @ r14 stores ADPCM byte count per channel for loop (-4 as we have already read 4 bytes)
 
 .adpcm_ucw32_8_sample_loop:
@@ -106,7 +116,8 @@ Adpcm_UnCompWrite32bit_8bit:
     @ clamp PCM data in r3 to [-32768, 32767]
     mov r7, r3, lsl #16 @ r7 = r3 << 16
     cmp r3, r7, asr #16 @ shift back and sign-extend r7 and compare with r3. check if r3 fits into signed 16-bit
-    eorne r7, r3, r8, asr #31 @ extract sign bit of r3. xor with r8 and apply to saturate
+    movne r3, r3, asr #31 @ else saturate to 0x7FFF or 0xFFFF8000
+    eorne r3, r3, r8, lsr #16
 #endif
 #ifdef ADPCM_ROUNDING
     add r7, r3, #128 @ r7 = pcmData + 128
@@ -148,7 +159,8 @@ Adpcm_UnCompWrite32bit_8bit:
     @ clamp PCM data in r3 to [-32768, 32767]
     mov r7, r3, lsl #16 @ r7 = r3 << 16
     cmp r3, r7, asr #16 @ shift back and sign-extend r7 and compare with r3. check if r3 fits into signed 16-bit
-    eorne r7, r3, r8, asr #31 @ extract sign bit of r3. xor with r8 and apply to saturate
+    movne r3, r3, asr #31 @ else saturate to 0x7FFF or 0xFFFF8000
+    eorne r3, r3, r8, lsr #16
 #endif
 #ifdef ADPCM_ROUNDING
     add r7, r3, #128 @ r7 = pcmData + 128
@@ -213,3 +225,146 @@ Adpcm_UnCompGetSize_8bit:
     eor r0, r0, r0
 .adpcm_ucgs_8_end:
     bx lr
+
+ @ Clamp PCM sample to [-32768, 32767] and store as 8-bit sample
+ @ r14 = scratch
+ .macro ADPCM_STEREO_STORE pcm, dst
+    mov r14, \pcm, asr #15 @ r14 = 0 or -1 if pcmData fits into signed 16-bit
+    teq r14, \pcm, asr #31
+    movne r14, #0x7F00 @ else saturate to 0x7FFF or 0xFFFF8000
+    orrne r14, r14, #0xFF
+    eorne \pcm, r14, \pcm, asr #31
+#ifdef ADPCM_ROUNDING
+    add r14, \pcm, #128
+    mov r14, r14, asr #8 @ r14 = (pcmData + 128) >> 8
+#else
+    mov r14, \pcm, asr #8 @ r14 = pcmData >> 8
+#endif
+    strb r14, [\dst], #1
+ .endm
+
+ @ Dither left PCM sample r4 and right PCM sample r6 with the same dither value, then store both as 8-bit samples.
+ @ Both channels need to see every dither value, else the differences of consecutive values don't cancel out and
+ @ the predictors drift
+ @ r10 = last_dither, r11 = dither, r2 = left destination, r3 = right destination
+ .macro ADPCM_STEREO_OUTPUT
+#ifdef ADPCM_DITHER
+    sub r4, r4, r10 @ pcmData -= last_dither
+    sub r6, r6, r10
+    mov r10, r11 @ r10 = dither
+    rsb r11, r10, r11, lsl #4 @ r11 = (dither << 4) - dither
+    eor r11, r11, #1 @ r11 ^= 1
+    mov r10, r10, lsr #ADPCM_DITHER_SHIFT @ r10 = dither >> ADPCM_DITHER_SHIFT
+    add r4, r4, r10 @ pcmData += dither >> ADPCM_DITHER_SHIFT
+    add r6, r6, r10
+#endif
+    ADPCM_STEREO_STORE r4, r2
+    ADPCM_STEREO_STORE r6, r3
+ .endm
+
+ @ Decode the ADPCM nibble at bit position shift in r12 into PCM sample and index
+ @ r8 = delta table, r9 = index table
+ .macro ADPCM_STEREO_DECODE pcm, index, shift
+    and r14, r12, #(7 << \shift) @ r14 = (nibble & 7) << shift
+    add r14, r14, \index, lsl #(3 + \shift) @ r14 = (index * 8 + (nibble & 7)) << shift
+ .if \shift == 0
+    mov r14, r14, lsl #1 @ r14 = index*2*8 + (nibble&7)*2, because uint16_t and 8 entries per index
+ .else
+    mov r14, r14, lsr #(\shift - 1)
+ .endif
+    ldrh r14, [r8, r14] @ load delta to r14
+    tst r12, #(8 << \shift) @ ADPCM value & 8?
+    subne \pcm, \pcm, r14
+    addeq \pcm, \pcm, r14
+    mov r14, r12, lsr #\shift
+    and r14, r14, #0x07
+    ldrsb r14, [r9, r14] @ load index change into r14 and
+    adds \index, \index, r14 @ add to old index. sets flags
+    @ clamp index to [0, 88]
+    movmi \index, #0
+    cmp \index, #88
+    movgt \index, #88
+ .endm
+
+ .arm
+ .align
+ .global Adpcm_UnCompWriteStereo32bit_8bit
+ .type Adpcm_UnCompWriteStereo32bit_8bit,function
+#ifdef __NDS__
+ .section .itcm, "ax", %progbits
+#else
+ .section .iwram, "ax", %progbits
+#endif
+Adpcm_UnCompWriteStereo32bit_8bit:
+    @ Decode a frame of stereo ADPCM data into separate left and right 8bit sample buffers
+    @ Both channels are decoded in lockstep with all predictor and dither state in registers
+    @ r0: pointer to ADPCM frame data, must be 4-byte-aligned (trashed)
+    @ r1: size of ADPCM frame data (trashed)
+    @ r2: pointer to the left 8bit sample buffer (trashed)
+    @ r3: pointer to the right 8bit sample buffer (trashed)
+    @ r4-r12 and r14 used and saved / restored
+    @ r4 = left PCM data, r5 = left ADPCM index, r6 = right PCM data, r7 = right ADPCM index
+    @ r12 = left ADPCM byte in bits 0-7, right ADPCM byte in bits 8-15, loop counter in bits 16-31
+    push {r4 - r12, r14}
+
+    @ store constants
+    ldr r8, =ADPCM_DeltaTable_4bit
+    ldr r9, =ADPCM_IndexTable_4bit
+    @ load dither state
+    ldr r14, =ADPCM_DitherState
+    ldmia r14, {r10, r11} @ load r10 = last_dither, r11 = dither
+
+    @ skip header. channel data is stored planar, so r1 is the offset from left to right channel data
+    add r0, r0, #ADPCM_FRAMEHEADER_SIZE
+    sub r1, r1, #ADPCM_FRAMEHEADER_SIZE
+    mov r1, r1, lsr #1
+    @ load first verbatim PCM samples and indices. only the low byte of the indices is used
+    ldrsh r4, [r0]
+    ldrb r5, [r0, #2]
+    @ blocks of odd size put the right channel at an odd address, so load its block header byte by byte
+    add r14, r0, r1
+    ldrb r6, [r14]
+    ldrb r7, [r14, #1]
+    orr r6, r6, r7, lsl #8
+    mov r6, r6, lsl #16 @ sign-extend
+    mov r6, r6, asr #16
+    ldrb r7, [r14, #2]
+    add r0, r0, #4
+    ADPCM_STEREO_OUTPUT
+
+    @ all bytes except the last decode two samples per channel
+    subs r14, r1, #5
+    beq .adpcm_ucws32_8_last_byte
+    sub r14, r14, #1
+    mov r12, r14, lsl #16
+
+.adpcm_ucws32_8_sample_loop:
+    mov r12, r12, lsr #16 @ keep loop counter
+    ldrb r14, [r0, r1] @ load right ADPCM byte
+    orr r12, r14, r12, lsl #8
+    ldrb r14, [r0], #1 @ load left ADPCM byte
+    orr r12, r14, r12, lsl #8
+    ADPCM_STEREO_DECODE r4, r5, 0
+    ADPCM_STEREO_DECODE r6, r7, 8
+    ADPCM_STEREO_OUTPUT
+    ADPCM_STEREO_DECODE r4, r5, 4
+    ADPCM_STEREO_DECODE r6, r7, 12
+    ADPCM_STEREO_OUTPUT
+    subs r12, r12, #0x10000 @ borrow when loop counter was 0
+    bcs .adpcm_ucws32_8_sample_loop
+
+.adpcm_ucws32_8_last_byte:
+    @ last byte only decodes the first nibble
+    ldrb r14, [r0, r1]
+    ldrb r12, [r0]
+    orr r12, r12, r14, lsl #8
+    ADPCM_STEREO_DECODE r4, r5, 0
+    ADPCM_STEREO_DECODE r6, r7, 8
+    ADPCM_STEREO_OUTPUT
+
+    @ store dither state
+    ldr r14, =ADPCM_DitherState
+    stmia r14, {r10, r11}
+
+    pop {r4 - r12, r14}
+    bx lr
@@ -0,0 +1,38 @@
+#pragma once
+
+// ADPCM frame layout shared by the C decoders in adpcm.cpp and the assembler decoders in adpcm_asm.s.
+// A frame starts with a 4 byte header. Bit 5-6: Number of channels, bit 7-12: Bits per sample of the source PCM data,
+// bit 16-31: Size of the source PCM data in bytes. The header is followed by one block of the same size per channel:
+// 16 bit initial sample, 16 bit step index [0, 88] of which only the low byte is read, then two 4 bit nibbles per byte, low nibble first. The high nibble
+// of the last byte is not used, so a block of n bytes decodes to 2 * (n - 4) samples.
+
+#define ADPCM_FRAMEHEADER_SIZE 4
+
+#ifndef __ASSEMBLER__
+
+#include <cstdint>
+
+namespace Audio
+{
+    /// @brief ADPCM frame header.
+    struct AdpcmFrameHeader
+    {
+        uint8_t nrOfChannels;      // 1 for mono, 2 for stereo
+        uint8_t pcmBitsPerSample;  // Bits per sample of the source PCM data
+        uint16_t uncompressedSize; // Size of the source PCM data in bytes
+
+        /// @brief Read header from start of frame.
+        static AdpcmFrameHeader read(const uint32_t *data)
+        {
+            AdpcmFrameHeader header;
+            header.nrOfChannels = (data[0] >> 5) & 3;
+            header.pcmBitsPerSample = (data[0] >> 7) & 63;
+            header.uncompressedSize = data[0] >> 16;
+            return header;
+        }
+    } __attribute__((aligned(4), packed));
+
+    static_assert(sizeof(AdpcmFrameHeader) == ADPCM_FRAMEHEADER_SIZE, "ADPCM frame header size must match the assembler decoders");
+}
+
+#endif
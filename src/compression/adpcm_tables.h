@@ -0,0 +1,18 @@
+#pragma once
+
+#include "sys/base.h"
+
+#include <cstdint>
+
+// Tables and state shared by the C decoders in adpcm.cpp and the assembler decoders in adpcm_asm.s.
+// Defined in adpcm_tables.cpp, so host tools and tests can link them without the assembler decoders.
+
+/// @brief Delta to add to / subtract from the predicted sample for step index [0, 88] and nibble bits 0-2.
+extern "C" const uint16_t ADPCM_DeltaTable_4bit[89][8];
+
+/// @brief Step index change for nibble bits 0-2.
+extern "C" const int8_t ADPCM_IndexTable_4bit[8];
+
+/// @brief Dither state of all decoders. [0] is the last dither value, [1] the dither generator.
+/// Set both before decoding to get reproducible output.
+extern "C" uint32_t ADPCM_DitherState[2];
@@ -0,0 +1,89 @@
+#include "decode.h"
+
+#include "bios.h"
+#include "lz4.h"
+#include "lz77.h"
+#include "rans.h"
+
+namespace Compression
+{
+    struct Decoder
+    {
+        uint8_t type;     // Type byte of data header
+        bool vramSafe;    // Decoder only writes 16 or 32 bit units
+        const char *name; // Function name for debug output
+        bool (*function)(const void *, void *); // Returns false if decoding failed
+    };
+
+    // Call a decoder that can not fail
+    template <void (*Function)(const void *, void *)>
+    bool decodeAlways(const void *source, void *destination)
+    {
+        Function(source, destination);
+        return true;
+    }
+
+    bool decodeLZ4_8(const void *source, void *destination)
+    {
+        LZ4UnCompWrite8bit_ASM(reinterpret_cast<const uint32_t *>(source), reinterpret_cast<uint32_t *>(destination));
+        return true;
+    }
+    bool decodeLZ4_16(const void *source, void *destination)
+    {
+        LZ4UnCompWrite16bit_ASM(reinterpret_cast<const uint32_t *>(source), reinterpret_cast<uint32_t *>(destination));
+        return true;
+    }
+    bool decodeRANS_8(const void *source, void *destination) { return RANSUnCompWrite8bitIWRAM(reinterpret_cast<const uint32_t *>(source), reinterpret_cast<uint32_t *>(destination)); }
+
+    // Decoders for each type. decode() uses the first one allowed for the destination, so byte writers come before VRAM-safe ones.
+    // The order is not backed by recorded measurements. Test::bandwidth() in test/gba prints a "# fastest" line per type,
+    // source and destination with the measured fastest decoder next to the one chosen here. Reorder if they disagree
+    const Decoder Decoders[] = {
+        {0x10, false, "LZ77UnCompWrite8bit_ASM", decodeAlways<LZ77UnCompWrite8bit_ASM>},
+        {0x10, true, "LZ77UnCompWrite16bit_ASM", decodeAlways<LZ77UnCompWrite16bit_ASM>},
+        {0x24, true, "HuffUnCompReadNormal", decodeAlways<HuffUnCompReadNormal>},
+        {0x28, true, "HuffUnCompReadNormal", decodeAlways<HuffUnCompReadNormal>},
+        {0x30, false, "RLUnCompReadNormalWrite8bit", decodeAlways<RLUnCompReadNormalWrite8bit>},
+        {0x30, true, "RLUnCompReadNormalWrite16bit", decodeAlways<RLUnCompReadNormalWrite16bit>},
+        {0x40, false, "LZ4UnCompWrite8bit_ASM", decodeLZ4_8},
+        {0x40, true, "LZ4UnCompWrite16bit_ASM", decodeLZ4_16},
+        {0x50, false, "RANSUnCompWrite8bitIWRAM", decodeRANS_8},
+        {0x51, false, "RANSUnCompWrite8bitIWRAM", decodeRANS_8},
+        {0x81, false, "Diff8bitUnFilterWrite8bit", decodeAlways<Diff8bitUnFilterWrite8bit>},
+        {0x81, true, "Diff8bitUnFilterWrite16bit", decodeAlways<Diff8bitUnFilterWrite16bit>},
+        {0x82, true, "Diff16bitUnFilter", decodeAlways<Diff16bitUnFilter>}};
+
+    const Decoder *findDecoder(const void *source, void *destination, DestKind kind)
+    {
+        const uint8_t type = *reinterpret_cast<const uint8_t *>(source);
+        const bool vram = (kind == DestKind::Auto ? destKindOf(destination) : kind) == DestKind::VideoRam;
+        for (const auto &decoder : Decoders)
+        {
+            if (decoder.type == type && (decoder.vramSafe || !vram))
+            {
+                return &decoder;
+            }
+        }
+        return nullptr;
+    }
+
+    auto decode(const void *source, void *destination, DestKind kind) -> uint32_t
+    {
+        auto decoder = findDecoder(source, destination, kind);
+        if (decoder == nullptr)
+        {
+            return 0;
+        }
+        if (!decoder->function(source, destination))
+        {
+            return 0;
+        }
+        return *reinterpret_cast<const uint32_t *>(source) >> 8;
+    }
+
+    auto decoderName(const void *source, DestKind kind) -> const char *
+    {
+        auto decoder = findDecoder(source, nullptr, kind);
+        return decoder != nullptr ? decoder->name : nullptr;
+    }
+}
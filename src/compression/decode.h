@@ -0,0 +1,38 @@
+#pragma once
+
+#include "sys/base.h"
+
+#include <cstdint>
+
+namespace Compression
+{
+    /// @brief Kind of memory decoded data is written to. Decides which decoders can be used.
+    enum class DestKind : uint8_t
+    {
+        Auto = 0,    // Detect from destination address
+        WorkRam = 1, // IWRAM or EWRAM. 8 bit writes allowed
+        VideoRam = 2 // VRAM, palette or OAM. Only 16 and 32 bit writes allowed
+    };
+
+    /// @brief Decompress BIOS-compatible data, choosing the decoder for the type byte in the data header and the destination.
+    /// Supports LZ77 10h, Huffman 24h / 28h, run-length 30h, LZ4 40h, rANS 50h / 51h and the diff filters 81h / 82h.
+    /// rANS data can only be decoded to work RAM
+    /// @param source Compressed data with 4 byte header. Must be 4-byte-aligned
+    /// @param destination Output buffer. Must be 4-byte-aligned
+    /// @param kind Kind of destination memory. Detected from the address with DestKind::Auto
+    /// @return Size of the decompressed data or 0 if the type is not supported or the decoder failed, e.g. because rANS
+    /// tables could not be allocated. Nothing was written then
+    auto decode(const void *source, void *destination, DestKind kind = DestKind::Auto) -> uint32_t;
+
+    /// @brief Name of the decoder decode() would use for source and kind or nullptr if the type is not supported. For debug output and benchmarks.
+    /// DestKind::Auto is treated as DestKind::WorkRam here
+    auto decoderName(const void *source, DestKind kind) -> const char *;
+
+    /// @brief Get destination kind from address
+    inline auto destKindOf(const void *destination) -> DestKind
+    {
+        // palette RAM, VRAM and OAM are 0x05000000 - 0x07FFFFFF
+        const uint32_t region = reinterpret_cast<uint32_t>(destination) >> 24;
+        return (region >= 0x05 && region <= 0x07) ? DestKind::VideoRam : DestKind::WorkRam;
+    }
+}
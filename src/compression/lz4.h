@@ -25,6 +25,16 @@ namespace Compression
     /// @param dst Pointer to output buffer
     extern "C" auto LZ4UnCompWrite16bit_ASM(const uint32_t *data, uint32_t *dst) -> void;
 
+    /// @brief Decompress LZ4 variant 40h through a double-buffered IWRAM window. Safe for VRAM.
+    /// Chunks of LZ4ChunkSize bytes are decoded to IWRAM with LZ4StreamDecode_ASM() and moved to dst with 32 bit DMA3.
+    /// Falls back to LZ4UnCompWrite16bit_ASM() if the window can not be allocated
+    /// @param data Pointer to LZ4-compressed data
+    /// @param dst Pointer to output buffer
+    auto LZ4UnCompWriteDMA(const uint32_t *data, uint32_t *dst) -> void;
+
+    /// @brief Size of one IWRAM window chunk for LZ4UnCompWriteDMA()
+    constexpr uint32_t LZ4ChunkSize = 1024;
+
     /// @brief Get stored uncompressed size of data after decoding. Written in ARMv4 assembler
     /// @param data Pointer to LZ4-compressed data
     extern "C" auto LZ4UnCompGetSize_ASM(const uint32_t *data) -> uint32_t;
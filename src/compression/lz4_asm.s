@@ -297,6 +297,157 @@ LZ4UnCompWrite16bit_ASM:
     mov     r0, #0
     bx      lr
 
+ .arm
+ .align
+ .global LZ4StreamDecode_ASM
+ .type LZ4StreamDecode_ASM,function
+#ifdef __NDS__
+ .section .itcm, "ax", %progbits
+#else
+ .section .iwram, "ax", %progbits
+#endif
+LZ4StreamDecode_ASM:
+    @ Decode at most maxBytes of LZ4 data and save the state, so decoding can resume at any byte
+    @ Same as LZ4StreamDecode() in lz4stream.cpp, but copies with LZ4_MemCopy16 like LZ4UnCompWrite16bit_ASM
+    @ ------------------------------
+    @ Input:
+    @ r0: pointer to LZ4StreamState, layout see LZ4_STATE_* below
+    @ r1: maximum number of bytes to write
+    @ ------------------------------
+    @ Output:
+    @ r0: number of bytes written
+    @ ------------------------------
+    @ In function:
+    @ r1: current position in output buffer
+    @ r2: uncompressed bytes left to decode (signed)
+    @ r3: match offset
+    @ r6: current position in compressed data
+    @ r7: bytes left to write in this call
+    @ r8: literal bytes left to copy
+    @ r9: match bytes left to copy
+    @ r10: match length nibble of current token. match header follows literals
+    @ r11: pointer to state
+    @ r0,r4,r5,r12 trashed by LZ4_MemCopy16
+#define LZ4_STATE_SRC 0
+#define LZ4_STATE_DST 4
+#define LZ4_STATE_REMAINING 8
+#define LZ4_STATE_LITERAL_LENGTH 12
+#define LZ4_STATE_MATCH_LENGTH 16
+#define LZ4_STATE_MATCH_OFFSET 20
+#define LZ4_STATE_MATCH_TOKEN 24
+#define LZ4_STATE_WINDOW_START 28
+#define LZ4_STATE_PREVIOUS 32
+#define LZ4_STATE_PREVIOUS_SIZE 36
+#define LZ4_STATE_HISTORY 40
+    push    {r1, r4 - r11, lr}
+    mov     r11, r0
+    mov     r7, r1
+    ldr     r6, [r11, #LZ4_STATE_SRC]
+    ldr     r1, [r11, #LZ4_STATE_DST]
+    ldr     r2, [r11, #LZ4_STATE_REMAINING]
+    ldr     r8, [r11, #LZ4_STATE_LITERAL_LENGTH]
+    ldr     r9, [r11, #LZ4_STATE_MATCH_LENGTH]
+    ldr     r3, [r11, #LZ4_STATE_MATCH_OFFSET]
+    ldr     r10, [r11, #LZ4_STATE_MATCH_TOKEN]
+.lz4_sd_decode_loop:
+    cmp     r7, #0
+    beq     .lz4_sd_done
+    cmp     r8, #0
+    bne     .lz4_sd_literals
+    cmp     r10, #0
+    bne     .lz4_sd_match_header
+    cmp     r9, #0
+    bne     .lz4_sd_match
+    cmp     r2, #0
+    ble     .lz4_sd_done
+    @ ----- token -----
+    ldrb    r12, [r6], #1
+    and     r10, r12, #LZ4_CONSTANTS_LENGTH_MASK
+    lsrs    r8, r12, #LZ4_CONSTANTS_LITERAL_LENGTH_SHIFT
+    beq     .lz4_sd_decode_loop
+    @ read extra literal length if initial length == 15
+    cmp     r8, #15
+.lz4_sd_read_literals_length:
+    ldreqb  r5, [r6], #1
+    addeq   r8, r8, r5
+    cmpeq   r5, #255
+    beq     .lz4_sd_read_literals_length
+    b       .lz4_sd_decode_loop
+.lz4_sd_literals:
+    @ ----- copy literals, possibly only part of them -----
+    cmp     r8, r7
+    movlo   r4, r8
+    movhs   r4, r7
+    sub     r8, r8, r4
+    sub     r7, r7, r4
+    sub     r2, r2, r4
+    mov     r0, r6
+    bl      LZ4_MemCopy16
+    mov     r6, r0
+    b       .lz4_sd_decode_loop
+.lz4_sd_match_header:
+    @ ----- literals are done. read 16-bit match offset and extra match length -----
+    ldrb    r12, [r6], #1
+    ldrb    r5, [r6], #1
+    orr     r3, r5, r12, lsl #8
+    cmp     r10, #15
+.lz4_sd_read_match_length:
+    ldreqb  r5, [r6], #1
+    addeq   r10, r10, r5
+    cmpeq   r5, #255
+    beq     .lz4_sd_read_match_length
+    add     r9, r10, #LZ4_CONSTANTS_MIN_MATCH_LENGTH - 1
+    mov     r10, #0
+    b       .lz4_sd_decode_loop
+.lz4_sd_match:
+    @ ----- copy match, possibly only part of it -----
+    cmp     r9, r7
+    movlo   r4, r9
+    movhs   r4, r7
+    @ r0 = match source. copy in one go if it is inside the output window
+    sub     r0, r1, r3
+    ldr     r12, [r11, #LZ4_STATE_WINDOW_START]
+    cmp     r0, r12
+    bhs     .lz4_sd_match_copy
+    @ match starts before the window. r12 = distance from window start
+    sub     r12, r12, r0
+    ldr     r5, [r11, #LZ4_STATE_PREVIOUS_SIZE]
+    subs    r12, r12, r5
+    bls     .lz4_sd_match_previous
+    @ data older than the previous window is at its final location. copy up to the start of the previous window
+    cmp     r4, r12
+    movhi   r4, r12
+    ldr     r0, [r11, #LZ4_STATE_HISTORY]
+    sub     r0, r0, r12
+    b       .lz4_sd_match_copy
+.lz4_sd_match_previous:
+    @ data from the previous window. copy up to the start of the output window
+    add     r12, r12, r5
+    cmp     r4, r12
+    movhi   r4, r12
+    ldr     r0, [r11, #LZ4_STATE_PREVIOUS]
+    add     r0, r0, r5
+    sub     r0, r0, r12
+.lz4_sd_match_copy:
+    sub     r9, r9, r4
+    sub     r7, r7, r4
+    sub     r2, r2, r4
+    bl      LZ4_MemCopy16
+    b       .lz4_sd_decode_loop
+.lz4_sd_done:
+    str     r6, [r11, #LZ4_STATE_SRC]
+    str     r1, [r11, #LZ4_STATE_DST]
+    str     r2, [r11, #LZ4_STATE_REMAINING]
+    str     r8, [r11, #LZ4_STATE_LITERAL_LENGTH]
+    str     r9, [r11, #LZ4_STATE_MATCH_LENGTH]
+    str     r3, [r11, #LZ4_STATE_MATCH_OFFSET]
+    str     r10, [r11, #LZ4_STATE_MATCH_TOKEN]
+    @ return maxBytes - bytes left
+    ldr     r0, [sp], #4
+    sub     r0, r0, r7
+    pop     {r4 - r11, lr}
+    bx      lr
+
 .arm
  .align
  .global LZ4UnCompGetSize_ASM
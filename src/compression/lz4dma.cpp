@@ -0,0 +1,57 @@
+#include "lz4.h"
+#include "lz4stream.h"
+
+#include "memory/dma.h"
+#include "memory/memory.h"
+
+namespace Compression
+{
+    // Move a decoded chunk to its final location. Only the last chunk can have a size that is not a multiple of 4
+    void writeChunk(uint8_t *dst, const uint8_t *chunk, uint32_t size)
+    {
+        const uint32_t nrOfWords = size >> 2;
+        if (nrOfWords > 0)
+        {
+            DMA::dma_copy32(dst, reinterpret_cast<const uint32_t *>(chunk), nrOfWords);
+        }
+        // write trailing bytes as halfwords, merging an odd last byte with the data already there
+        for (uint32_t i = nrOfWords << 2; i < size; i += 2)
+        {
+            auto dst16 = reinterpret_cast<uint16_t *>(dst + i);
+            const uint16_t high = (i + 1) < size ? chunk[i + 1] : (*dst16 >> 8);
+            *dst16 = chunk[i] | (high << 8);
+        }
+    }
+
+    auto LZ4UnCompWriteDMA(const uint32_t *data, uint32_t *dst) -> void
+    {
+        LZ4StreamState state;
+        if (!LZ4StreamInit(state, data, dst))
+        {
+            return;
+        }
+        auto window = Memory::malloc_IWRAM<uint32_t>(2 * LZ4ChunkSize / 4);
+        if (window == nullptr)
+        {
+            LZ4UnCompWrite16bit_ASM(data, dst);
+            return;
+        }
+        // decode into one half of the window while the other half holds the previous chunk.
+        // the previous chunk is kept for matches, because it is read from IWRAM faster than from its final location.
+        // the byte LZ4StreamDecode_ASM() can write after an odd-sized chunk is still inside its half of the window
+        auto out8 = reinterpret_cast<uint8_t *>(dst);
+        const uint32_t *previous = nullptr;
+        uint32_t previousSize = 0;
+        for (uint32_t i = 0; !LZ4StreamDone(state); i ^= 1)
+        {
+            auto chunk = window + i * (LZ4ChunkSize / 4);
+            LZ4StreamSetWindow(state, chunk, previous, previousSize, reinterpret_cast<const uint32_t *>(out8 - previousSize));
+            const uint32_t size = LZ4StreamDecode_ASM(state, LZ4ChunkSize);
+            writeChunk(out8, reinterpret_cast<const uint8_t *>(chunk), size);
+            out8 += size;
+            previous = chunk;
+            previousSize = size;
+        }
+        Memory::free(window);
+    }
+}
@@ -0,0 +1,142 @@
+#include "lz4stream.h"
+#include "lz4_constants.h"
+
+namespace Compression
+{
+    auto LZ4StreamInit(LZ4StreamState &state, const uint32_t *data, uint32_t *dst) -> bool
+    {
+        state = LZ4StreamState();
+        // read data header and skip to data
+        const uint32_t header = *data++;
+        if ((header & 0xFF) != Lz4Constants::TYPE_MARKER)
+        {
+            return false;
+        }
+        state.src = reinterpret_cast<const uint8_t *>(data);
+        state.dst = reinterpret_cast<uint8_t *>(dst);
+        state.remaining = (header >> 8);
+        return true;
+    }
+
+    // Copy the part of a match that lies before the output window. Returns the number of bytes copied
+    NOINLINE uint32_t copyFromHistory(const LZ4StreamState &state, uint8_t *dst8, const uint8_t *match8, uint32_t count)
+    {
+        uint32_t distance = state.windowStart - match8;
+        uint32_t copied = 0;
+        // data older than previous is at its final location
+        if (distance > state.previousSize)
+        {
+            const uint32_t n = count < (distance - state.previousSize) ? count : (distance - state.previousSize);
+            auto src8 = state.history - (distance - state.previousSize);
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                dst8[i] = src8[i];
+            }
+            copied = n;
+            distance -= n;
+        }
+        // data from previous window
+        const uint32_t n = (count - copied) < distance ? (count - copied) : distance;
+        auto src8 = state.previous + state.previousSize - distance;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            dst8[copied + i] = src8[i];
+        }
+        return copied + n;
+    }
+
+    IWRAM_FUNC auto LZ4StreamDecode(LZ4StreamState &state, uint32_t maxBytes) -> uint32_t
+    {
+        // work on local copies, so the compiler can keep them in registers
+        auto data8 = state.src;
+        auto dst8 = state.dst;
+        uint32_t literalLength = state.literalLength;
+        uint32_t matchLength = state.matchLength;
+        uint32_t matchToken = state.matchToken;
+        int32_t remaining = state.remaining;
+        uint32_t budget = maxBytes;
+        while (budget > 0)
+        {
+            if (literalLength > 0)
+            {
+                // copy literals, possibly only part of them
+                const uint32_t count = literalLength < budget ? literalLength : budget;
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    dst8[i] = data8[i];
+                }
+                data8 += count;
+                dst8 += count;
+                literalLength -= count;
+                remaining -= count;
+                budget -= count;
+            }
+            else if (matchToken > 0)
+            {
+                // literals are done. read match offset and extra match length
+                matchLength = matchToken;
+                matchToken = 0;
+                state.matchOffset = (uint32_t(data8[0]) << 8) | uint32_t(data8[1]);
+                data8 += 2;
+                if (matchLength == 15)
+                {
+                    uint8_t extraLength = 0;
+                    do
+                    {
+                        extraLength = *data8++;
+                        matchLength += extraLength;
+                    } while (extraLength == 255);
+                }
+                matchLength += (Lz4Constants::MIN_MATCH_LENGTH - 1);
+            }
+            else if (matchLength > 0)
+            {
+                // copy match, possibly only part of it. note that we have to allow overlapping copies
+                uint32_t count = matchLength < budget ? matchLength : budget;
+                auto match8 = const_cast<const uint8_t *>(dst8) - state.matchOffset;
+                if (match8 < state.windowStart)
+                {
+                    count = copyFromHistory(state, dst8, match8, count);
+                }
+                else
+                {
+                    for (uint32_t i = 0; i < count; ++i)
+                    {
+                        dst8[i] = match8[i];
+                    }
+                }
+                dst8 += count;
+                matchLength -= count;
+                remaining -= count;
+                budget -= count;
+            }
+            else if (remaining > 0)
+            {
+                // read token and extra literal length
+                const uint8_t token = *data8++;
+                literalLength = (token >> Lz4Constants::LITERAL_LENGTH_SHIFT) & Lz4Constants::LENGTH_MASK;
+                if (literalLength == 15)
+                {
+                    uint8_t extraLength = 0;
+                    do
+                    {
+                        extraLength = *data8++;
+                        literalLength += extraLength;
+                    } while (extraLength == 255);
+                }
+                matchToken = token & Lz4Constants::LENGTH_MASK;
+            }
+            else
+            {
+                break;
+            }
+        }
+        state.src = data8;
+        state.dst = dst8;
+        state.literalLength = literalLength;
+        state.matchLength = matchLength;
+        state.matchToken = matchToken;
+        state.remaining = remaining;
+        return maxBytes - budget;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "sys/base.h"
+
+#include <cstdint>
+
+namespace Compression
+{
+    /// @brief State of a resumable LZ4 variant 40h decoder. Treat as opaque and set up with LZ4StreamInit()
+    struct LZ4StreamState
+    {
+        const uint8_t *src = nullptr; // Current position in compressed data
+        uint8_t *dst = nullptr;       // Current position in output buffer
+        int32_t remaining = 0;        // Uncompressed bytes left to decode
+        uint32_t literalLength = 0;   // Literal bytes left to copy from current token
+        uint32_t matchLength = 0;     // Match bytes left to copy from current token
+        uint32_t matchOffset = 0;     // Distance of match from current output position
+        uint32_t matchToken = 0;      // Match length nibble of current token. Match header follows literals
+        uint8_t *windowStart = nullptr;   // Start of output window. Matches before it are read from previous / history
+        const uint8_t *previous = nullptr; // Output data directly before windowStart, e.g. the previous window
+        uint32_t previousSize = 0;         // Size of previous in bytes
+        const uint8_t *history = nullptr;  // Final location of previous. Older output data is read from before it
+    } __attribute__((aligned(4), packed));
+
+#ifndef TARGET_PC
+    static_assert(sizeof(LZ4StreamState) == 44, "LZ4 stream state layout must match LZ4StreamDecode_ASM");
+#endif
+
+    /// @brief Set up decoder state for decompressing LZ4 variant 40h data with LZ4StreamDecode()
+    /// @param state Decoder state to set up
+    /// @param data Pointer to LZ4-compressed data. Must stay valid until decoding is done
+    /// @param dst Pointer to output buffer. Must stay valid until decoding is done
+    /// @return False if data is not LZ4 variant 40h data
+    auto LZ4StreamInit(LZ4StreamState &state, const uint32_t *data, uint32_t *dst) -> bool;
+
+    /// @brief Decompress at most maxBytes of LZ4 variant 40h data, writing 8 bit at a time. Don't use for VRAM.
+    /// Call repeatedly, e.g. once per frame, until LZ4StreamDone() returns true.
+    /// The output is the same as for LZ4UnCompWrite8bit()
+    /// @param state Decoder state set up with LZ4StreamInit()
+    /// @param maxBytes Maximum number of bytes to write in this call
+    /// @return Number of bytes written in this call
+    auto LZ4StreamDecode(LZ4StreamState &state, uint32_t maxBytes) -> uint32_t;
+
+    /// @brief Decompress at most maxBytes of LZ4 variant 40h data, writing 16 bit at a time. Safe for VRAM. Written in ARMv4 assembler.
+    /// Same as LZ4StreamDecode(), but copies like LZ4UnCompWrite16bit_ASM(). Can write the byte after the last output byte.
+    /// Use either this or LZ4StreamDecode() on one state
+    /// @param state Decoder state set up with LZ4StreamInit()
+    /// @param maxBytes Maximum number of bytes to write in this call
+    /// @return Number of bytes written in this call
+    extern "C" auto LZ4StreamDecode_ASM(LZ4StreamState &state, uint32_t maxBytes) -> uint32_t;
+
+    /// @brief Continue decoding into a new output window, e.g. for decompressing through a small IWRAM buffer.
+    /// Matches reaching before the window are read from the previous window first, then from the final output location.
+    /// Without calling this the output is written to one contiguous buffer
+    /// @param state Decoder state set up with LZ4StreamInit()
+    /// @param window Output buffer for the following LZ4StreamDecode() calls
+    /// @param previous Output data directly before window. Must stay unchanged while decoding into window
+    /// @param previousSize Size of previous in bytes
+    /// @param history Final location of previous. Data before it must have been written already and be readable
+    inline auto LZ4StreamSetWindow(LZ4StreamState &state, uint32_t *window, const uint32_t *previous, uint32_t previousSize, const uint32_t *history) -> void
+    {
+        state.dst = reinterpret_cast<uint8_t *>(window);
+        state.windowStart = state.dst;
+        state.previous = reinterpret_cast<const uint8_t *>(previous);
+        state.previousSize = previousSize;
+        state.history = reinterpret_cast<const uint8_t *>(history);
+    }
+
+    /// @brief Check if all data has been decompressed
+    inline auto LZ4StreamDone(const LZ4StreamState &state) -> bool
+    {
+        return state.remaining <= 0 && state.literalLength == 0 && state.matchLength == 0 && state.matchToken == 0;
+    }
+}
@@ -0,0 +1,73 @@
+#include "rans.h"
+
+namespace Compression
+{
+    // Read symbol frequencies and build the symbol info and slot tables. Returns a pointer to the initial state
+    const uint32_t *ransBuildTables(const uint8_t *data8, uint32_t *info, uint8_t *slots)
+    {
+        uint32_t cumulative = 0;
+        for (uint32_t symbol = 0; symbol < 256;)
+        {
+            uint32_t frequency = *data8++;
+            if (frequency >= 0x80)
+            {
+                frequency = ((frequency & 0x7F) << 8) | *data8++;
+            }
+            if (frequency == 0)
+            {
+                symbol += 1 + *data8++;
+                continue;
+            }
+            // symbol info: cumulative frequency in bits 0-15, frequency in bits 16-31
+            info[symbol] = cumulative | (frequency << 16);
+            for (uint32_t i = 0; i < frequency; ++i)
+            {
+                slots[cumulative + i] = symbol;
+            }
+            cumulative += frequency;
+            symbol++;
+        }
+        return reinterpret_cast<const uint32_t *>((reinterpret_cast<uintptr_t>(data8) + 3) & ~uintptr_t(3));
+    }
+
+    IWRAM_FUNC void RANSUnCompWrite8bit(const uint32_t *data, uint32_t *dst, uint32_t *tables)
+    {
+        // read data header and skip to data
+        const uint32_t header = *data++;
+        if ((header & 0xFF) != RANSTypeMarker)
+        {
+            return;
+        }
+        const uint32_t uncompressedSize = header >> 8;
+        if (uncompressedSize == 0)
+        {
+            return;
+        }
+        auto info = tables;
+        auto slots = reinterpret_cast<uint8_t *>(tables + 256);
+        auto src = ransBuildTables(reinterpret_cast<const uint8_t *>(data), info, slots);
+        uint32_t state = *src++;
+        auto src8 = reinterpret_cast<const uint8_t *>(src);
+        auto dst8 = reinterpret_cast<uint8_t *>(dst);
+        constexpr uint32_t SlotMask = (1 << RANSProbabilityBits) - 1;
+        for (uint32_t i = 0; i < uncompressedSize; ++i)
+        {
+            // the low bits of the state select the symbol, the high bits are scaled by the symbol frequency
+            const uint32_t slot = state & SlotMask;
+            const uint8_t symbol = slots[slot];
+            dst8[i] = symbol;
+            const uint32_t symbolInfo = info[symbol];
+            state = (symbolInfo >> 16) * (state >> RANSProbabilityBits) + slot - (symbolInfo & 0xFFFF);
+            while (state < RANSStateLow)
+            {
+                state = (state << 8) | *src8++;
+            }
+        }
+    }
+
+    auto RANSUnCompGetSize(const uint32_t *data) -> uint32_t
+    {
+        const uint32_t header = *data;
+        return ((header & 0xFF) == RANSTypeMarker || (header & 0xFF) == RANSLZ4TypeMarker) ? (header >> 8) : 0;
+    }
+}
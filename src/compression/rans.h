@@ -0,0 +1,62 @@
+#pragma once
+
+#include "sys/base.h"
+
+#include <cstdint>
+
+// Static order-0 rANS (range asymmetric numeral system) entropy coding, packed with tools/ranspack.
+// Compresses better than LZ77 / LZ4 when data has a skewed byte distribution but few repeats, e.g. noisy graphics,
+// and can be layered after LZ4, entropy coding its token stream, for the best of both.
+//
+// Variant 50h:
+// Bit 0-7 of header word: Compressed type (50h), Bit 8-31: Size of uncompressed data.
+// Followed by the symbol frequencies, summing up to 1 << RANSProbabilityBits. For symbols 0-255: One byte < 80h is the
+// frequency, a byte >= 80h holds bits 8-14 of the frequency and is followed by bits 0-7. A frequency of 0 is followed
+// by the number of following symbols that also have frequency 0. Padded to a multiple of 4 bytes, followed by the
+// 32 bit initial decoder state, followed by the renormalization bytes read in order.
+//
+// Variant 51h:
+// Bit 0-7 of header word: Compressed type (51h), Bit 8-31: Size of uncompressed data.
+// Followed by rANS 50h data that decodes to LZ4 40h data, which decodes to the uncompressed data.
+namespace Compression
+{
+    /// @brief Compressed type of rANS data
+    constexpr uint8_t RANSTypeMarker = 0x50;
+
+    /// @brief Compressed type of LZ4 data entropy coded with rANS
+    constexpr uint8_t RANSLZ4TypeMarker = 0x51;
+
+    /// @brief Symbol frequencies sum up to 1 << RANSProbabilityBits
+    constexpr uint32_t RANSProbabilityBits = 12;
+
+    /// @brief Lower bound of decoder state. The state is renormalized by reading bytes when it falls below this
+    constexpr uint32_t RANSStateLow = 1 << 23;
+
+    /// @brief Size of decoder tables in bytes. Symbol info for 256 symbols and the symbol for every frequency slot
+    constexpr uint32_t RANSTableSize = 256 * 4 + (1 << RANSProbabilityBits);
+
+    /// @brief Decompress rANS variant 50h, writing 8 bit at a time. Don't use for VRAM
+    /// @param data Pointer to rANS-compressed data. Must be 4-byte-aligned
+    /// @param dst Pointer to output buffer
+    /// @param tables Scratch buffer of RANSTableSize bytes for decoder tables. Must be 4-byte-aligned
+    auto RANSUnCompWrite8bit(const uint32_t *data, uint32_t *dst, uint32_t *tables) -> void;
+
+    /// @brief Get stored uncompressed size of rANS variant 50h or 51h data after decoding
+    /// @param data Pointer to rANS-compressed data
+    auto RANSUnCompGetSize(const uint32_t *data) -> uint32_t;
+
+    /// @brief Decompress rANS variant 50h, writing 8 bit at a time. Don't use for VRAM. Written in ARMv4 assembler.
+    /// Builds the decoder tables, then decodes ~4 symbols per loop iteration
+    /// @param data Pointer to rANS-compressed data. Must be 4-byte-aligned
+    /// @param dst Pointer to output buffer
+    /// @param tables Scratch buffer of RANSTableSize bytes for decoder tables. Should be in IWRAM. Must be 4-byte-aligned
+    extern "C" auto RANSUnCompWrite8bit_ASM(const uint32_t *data, uint32_t *dst, uint32_t *tables) -> void;
+
+    /// @brief Decompress rANS variant 50h or 51h with RANSUnCompWrite8bit_ASM() and decoder tables in IWRAM.
+    /// Falls back to EWRAM tables if IWRAM is full. Variant 51h first decodes the LZ4 data to EWRAM, then decodes
+    /// that with LZ4UnCompWrite8bit_ASM(). Don't use for VRAM
+    /// @param data Pointer to rANS-compressed data. Must be 4-byte-aligned
+    /// @param dst Pointer to output buffer
+    /// @return False if data is not rANS 50h / 51h data or the tables or LZ4 data could not be allocated. Nothing is written then
+    auto RANSUnCompWrite8bitIWRAM(const uint32_t *data, uint32_t *dst) -> bool;
+}
@@ -0,0 +1,145 @@
+@ ARM v4/v5 static rANS decompressor
+@ See rans.h for the data format
+
+#define RANS_TYPE_MARKER 0x50       // Compressed type of rANS data
+#define RANS_PROBABILITY_BITS 12    // Symbol frequencies sum up to 1 << RANS_PROBABILITY_BITS
+#define RANS_STATE_LOW 0x00800000   // Lower bound of decoder state
+#define RANS_SLOT_TABLE_OFFSET 1024 // Offset of slot table from symbol info table
+
+.arm
+ .align
+ .global RANSUnCompWrite8bit_ASM
+ .type RANSUnCompWrite8bit_ASM,function
+#ifdef __NDS__
+ .section .itcm, "ax", %progbits
+#else
+ .section .iwram, "ax", %progbits
+#endif
+
+@ Decode one symbol and renormalize
+@ r0: source, r1: destination, r2: symbol info table, r3: state, r6: slot table
+@ r7-r10 trashed
+.macro RANS_SYMBOL
+    mov     r7, r3, lsl #(32 - RANS_PROBABILITY_BITS)    @ r7 = slot << 20
+    ldrb    r8, [r6, r7, lsr #(32 - RANS_PROBABILITY_BITS)] @ r8 = symbol of slot
+    mov     r3, r3, lsr #RANS_PROBABILITY_BITS          @ r3 = state >> 12
+    ldr     r9, [r2, r8, lsl #2]                        @ r9 = cumulative | frequency << 16
+    strb    r8, [r1], #1                                @ write symbol
+    mov     r8, r9, lsr #16                             @ r8 = frequency. <= 12 bits, so the multiply is short
+    mul     r10, r3, r8                                 @ r10 = frequency * (state >> 12)
+    mov     r9, r9, lsl #16
+    add     r3, r10, r7, lsr #(32 - RANS_PROBABILITY_BITS) @ state = frequency * (state >> 12) + slot
+    sub     r3, r3, r9, lsr #16                         @ state -= cumulative
+    @ renormalize. the state is >= 2^11 here, so 2 bytes always suffice
+    cmp     r3, #RANS_STATE_LOW
+    ldrlob  r8, [r0], #1
+    orrlo   r3, r8, r3, lsl #8
+    cmplo   r3, #RANS_STATE_LOW
+    ldrlob  r8, [r0], #1
+    orrlo   r3, r8, r3, lsl #8
+.endm
+
+RANSUnCompWrite8bit_ASM:
+    @ Decode rANS data
+    @ ------------------------------
+    @ Input:
+    @ r0: pointer to rANS data, must be 4-byte-aligned (trashed)
+    @ r1: pointer to destination buffer (trashed)
+    @ r2: pointer to table scratch buffer, must be 4-byte-aligned (trashed)
+    @ ------------------------------
+    @ In function:
+    @ r3: decoder state
+    @ r4: symbol, r5: cumulative frequency while building tables
+    @ r6: slot table
+    @ r7-r10 trashed
+    @ r11: symbols left for tail loop
+    @ r12: end of decompressed data in destination buffer (past the last byte)
+    @ r4-r11 used and saved / restored
+
+    @ read header word:
+    @ Bit 0-7: Compressed type (50h for rANS)
+    @ Bit 8-31: Size of uncompressed data
+    ldr     r3, [r0], #4
+    and     r12, r3, #0xFF
+    cmp     r12, #RANS_TYPE_MARKER
+    bxne    lr
+    movs    r3, r3, lsr #8
+    bxeq    lr
+    push    {r4 - r11}
+    add     r12, r1, r3
+
+    @ build tables from symbol frequencies
+    mov     r4, #0
+    mov     r5, #0
+    add     r6, r2, #RANS_SLOT_TABLE_OFFSET
+.rans_table_loop:
+    @ read frequency. 1 byte if < 80h, else 2 bytes
+    ldrb    r7, [r0], #1
+    tst     r7, #0x80
+    bicne   r7, r7, #0x80
+    ldrneb  r8, [r0], #1
+    orrne   r7, r8, r7, lsl #8
+    cmp     r7, #0
+    bne     .rans_table_symbol
+    @ frequency 0. skip this and the following unused symbols
+    ldrb    r8, [r0], #1
+    add     r4, r4, #1
+    add     r4, r4, r8
+    b       .rans_table_next
+.rans_table_symbol:
+    @ store symbol info
+    orr     r8, r5, r7, lsl #16
+    str     r8, [r2, r4, lsl #2]
+    @ fill frequency slots r8 to r9 with symbol. bytes up to word alignment, then words, then the remaining bytes
+    add     r8, r6, r5
+    add     r5, r5, r7
+    add     r9, r6, r5
+    orr     r10, r4, r4, lsl #8
+    orr     r10, r10, r10, lsl #16
+1:  cmp     r8, r9
+    bhs     .rans_table_filled
+    tst     r8, #3
+    beq     2f
+    strb    r4, [r8], #1
+    b       1b
+2:  sub     r7, r9, r8
+    movs    r7, r7, lsr #2
+    beq     4f
+3:  str     r10, [r8], #4
+    subs    r7, r7, #1
+    bne     3b
+4:  cmp     r8, r9
+    strlob  r4, [r8], #1
+    blo     4b
+.rans_table_filled:
+    add     r4, r4, #1
+.rans_table_next:
+    cmp     r4, #256
+    blo     .rans_table_loop
+
+    @ skip padding and read initial state
+    add     r0, r0, #3
+    bic     r0, r0, #3
+    ldr     r3, [r0], #4
+
+    @ decode (size % 4) symbols, then 4 symbols per loop
+    sub     r11, r12, r1
+    ands    r11, r11, #3
+    beq     .rans_check_end
+.rans_tail_loop:
+    RANS_SYMBOL
+    subs    r11, r11, #1
+    bne     .rans_tail_loop
+.rans_check_end:
+    cmp     r1, r12
+    bhs     .rans_done
+.rans_loop:
+    RANS_SYMBOL
+    RANS_SYMBOL
+    RANS_SYMBOL
+    RANS_SYMBOL
+    cmp     r1, r12
+    blo     .rans_loop
+.rans_done:
+    pop     {r4 - r11}
+    bx      lr
@@ -0,0 +1,42 @@
+#include "lz4.h"
+#include "rans.h"
+
+#include "memory/memory.h"
+
+namespace Compression
+{
+    auto RANSUnCompWrite8bitIWRAM(const uint32_t *data, uint32_t *dst) -> bool
+    {
+        const uint32_t type = *data & 0xFF;
+        if (type != RANSTypeMarker && type != RANSLZ4TypeMarker)
+        {
+            return false;
+        }
+        // symbols are looked up in the tables for every byte, so keep them in IWRAM if possible
+        auto tables = Memory::malloc_IWRAM<uint32_t>(RANSTableSize / 4);
+        tables = tables != nullptr ? tables : Memory::malloc_EWRAM<uint32_t>(RANSTableSize / 4);
+        if (tables == nullptr)
+        {
+            return false;
+        }
+        bool ok = true;
+        if (type == RANSTypeMarker)
+        {
+            RANSUnCompWrite8bit_ASM(data, dst, tables);
+        }
+        else
+        {
+            // entropy decode the LZ4 data, then decode that
+            auto lz4 = Memory::malloc_EWRAM<uint32_t>((RANSUnCompGetSize(data + 1) + 3) / 4);
+            ok = lz4 != nullptr;
+            if (ok)
+            {
+                RANSUnCompWrite8bit_ASM(data + 1, lz4, tables);
+                LZ4UnCompWrite8bit_ASM(lz4, dst);
+                Memory::free(lz4);
+            }
+        }
+        Memory::free(tables);
+        return ok;
+    }
+}
@@ -1,5 +1,7 @@
 #include "affine.h"
 
+#include "scanline.h"
+
 #include "math/random.h"
 #include "graphics.h"
 
@@ -104,61 +106,57 @@ namespace Effect_Affine
         setData(data.target, data.affine);
     }
 
-    void shiftScreenLinesRandom(Target target, Math::fp1616_t baseShift, uint8_t pixelsLog2)
+    // Scanline effects for shifting BG2 / BG3
+    int32_t m_shiftEffect[2] = {-1, -1};
+
+    int32_t *shiftTable(Target target)
     {
-        int32_t &REG_TARGET = (target == Target::TARGET_BG2 ? REG_BG2X : REG_BG3X);
-        // set base position
-        REG_TARGET = baseShift.raw() >> 8;
-        // wait while in vblank
-        while (REG_VCOUNT >= 160)
+        auto &effect = m_shiftEffect[target == Target::TARGET_BG2 ? 0 : 1];
+        if (effect < 0)
         {
+            effect = Effect_Scanline::add(reinterpret_cast<uint32_t>(target == Target::TARGET_BG2 ? &REG_BG2X : &REG_BG3X), 2);
         }
-        uint8_t vcount = 255;
-        while (REG_VCOUNT < 160)
+        return Effect_Scanline::backTable<int32_t>(effect);
+    }
+
+    void shiftScreenLinesRandom(Target target, Math::fp1616_t baseShift, uint8_t pixelsLog2)
+    {
+        auto table = shiftTable(target);
+        if (table != nullptr)
         {
-            // wait for the line to change
-            if (vcount != REG_VCOUNT)
+            for (uint32_t line = 0; line < Effect_Scanline::NrOfLines; line++)
             {
                 // shift horizontal start of screen
-                vcount = REG_VCOUNT;
                 int32_t shift = ((int32_t)(random<uint32_t>() >> (31 - pixelsLog2))) - ((int32_t)1 << pixelsLog2);
-                REG_TARGET = (baseShift.raw() >> 8) + (shift << 8);
+                table[line] = (baseShift.raw() >> 8) + (shift << 8);
             }
+            Effect_Scanline::commit(m_shiftEffect[target == Target::TARGET_BG2 ? 0 : 1]);
         }
-        // set base position again
-        REG_TARGET = baseShift.raw() >> 8;
     }
 
     void shiftScreenLinesSine(Target target, Math::fp1616_t baseShift, Math::fp1616_t scale, Math::fp1616_t amplitude, Math::fp1616_t phaseInc)
     {
-        int32_t &REG_TARGET = (target == Target::TARGET_BG2 ? REG_BG2X : REG_BG3X);
-        // set base position
-        REG_TARGET = baseShift.raw() >> 8;
-        // wait while in vblank
-        while (REG_VCOUNT >= 160)
-        {
-        }
-        // now wait until display has started
-        uint8_t vcount = 255;
-        while (REG_VCOUNT < 160)
+        auto table = shiftTable(target);
+        if (table != nullptr)
         {
-            // wait for the line to change
-            if (vcount != REG_VCOUNT)
+            for (uint32_t line = 0; line < Effect_Scanline::NrOfLines; line++)
             {
                 // shift horizontal start of screen
-                vcount = REG_VCOUNT;
-                Math::fp1616_t sineFactor = cos(scale * (phase + vcount) / Math::fp1616_t(160.0f) * Math::fp1616_t::PI_2);
-                REG_TARGET = (baseShift.raw() >> 8) + ((sineFactor * amplitude).raw() >> 8);
-                //Effect_BG::setFade(Effect_BG::FadeTarget::TARGET_BLACK, (sineFactor + 1.0f) / 8.0f);
+                Math::fp1616_t sineFactor = cos(scale * (phase + static_cast<int32_t>(line)) / Math::fp1616_t(160.0f) * Math::fp1616_t::PI_2);
+                table[line] = (baseShift.raw() >> 8) + ((sineFactor * amplitude).raw() >> 8);
             }
+            Effect_Scanline::commit(m_shiftEffect[target == Target::TARGET_BG2 ? 0 : 1]);
         }
-        // set base position
-        REG_TARGET = baseShift.raw() >> 8;
         phase += phaseInc;
     }
 
     void clear()
     {
+        for (auto &effect : m_shiftEffect)
+        {
+            Effect_Scanline::remove(effect);
+            effect = -1;
+        }
         REG_BG2PA = 256;
         REG_BG2PB = 0;
         REG_BG2PC = 0;
@@ -47,11 +47,15 @@ namespace Effect_Affine
 	void setData(const EffectData &data);
 
 	/// @brief Screen effect that shifts BG2 a random amount of pixes left/right.
+	/// Uses a HBlank DMA scanline effect. Call once per frame, the shift is displayed starting with the next frame.
+	/// The effect stays active after you stop calling this and shows the last shift every frame until clear() is called.
 	/// @param baseShift Start value before and after shifting occurrs. Random values will be added on top.
 	/// @param pixelsLog2 log2(pixels) to shift the screen.
 	void shiftScreenLinesRandom(Target target, Math::fp1616_t baseShift = 0, uint8_t pixelsLog2 = 3);
 
-	/// @brief Screen effect that shifts BG2 a random amount of pixes left/right.
+	/// @brief Screen effect that shifts BG2 a sine amount of pixes left/right.
+	/// Uses a HBlank DMA scanline effect. Call once per frame, the shift is displayed starting with the next frame.
+	/// The effect stays active after you stop calling this and shows the last shift every frame until clear() is called.
 	/// @param baseShift Start value before and after shifting occurrs. Random values will be added on top.
 	/// @param scale Scale factor for sine.
 	/// @param amplitude Amplitude of sine.
@@ -59,6 +63,7 @@ namespace Effect_Affine
 	void shiftScreenLinesSine(Target target, Math::fp1616_t baseShift = 0, Math::fp1616_t scale = 2, Math::fp1616_t amplitude = 3, Math::fp1616_t phaseInc = 0.9f);
 
 	/// @brief Clear all registers to their default values, turning off all effects.
+	/// Removes the scanline effects used by shiftScreenLines* and releases their DMA channels.
 	void clear();
 
 } // namespace Effect_Affine
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "scanline.h"
+
+#include "graphics.h"
+#include "memory/dma.h"
+#include "memory/memory.h"
+
+namespace Effect_Scanline
+{
+
+    struct Effect
+    {
+        uint32_t registerAddress;
+        uint16_t *table[2];      // Front table used by DMA and back table being filled
+        uint16_t hwordsPerLine;  // 16-bit values written per scanline
+        uint8_t channel;         // DMA channel
+        uint8_t state;           // See State
+        volatile bool committed; // Back table is complete and should be swapped. Separate, so commit() does not race with update()
+    } __attribute__((aligned(4), packed));
+
+    enum State : uint8_t
+    {
+        Used = 1,   // Effect exists
+        Running = 2 // Front table is valid and DMA is running
+    };
+
+    // DMA channels in order of use. DMA3 is needed for copying and its users wait for it to finish
+    constexpr uint8_t Channels[MaxEffects] = {0, 1, 2};
+
+    // Reserve the first free channel. Returns -1 if all are taken, e.g. by DirectSound
+    int32_t reserveChannel()
+    {
+        for (uint32_t i = 0; i < MaxEffects; i++)
+        {
+            if (DMA::reserveChannel(Channels[i]))
+            {
+                return Channels[i];
+            }
+        }
+        return -1;
+    }
+
+    Effect m_effects[MaxEffects];
+    uint32_t m_nrOfEffects = 0;
+
+    inline bool isValid(int32_t effect)
+    {
+        return effect >= 0 && effect < static_cast<int32_t>(MaxEffects) && (m_effects[effect].state & Used) != 0;
+    }
+
+    int32_t add(uint32_t registerAddress, uint32_t hwordsPerLine)
+    {
+        if (hwordsPerLine != 1 && hwordsPerLine != 2 && hwordsPerLine != 4)
+        {
+            return -1;
+        }
+        for (uint32_t i = 0; i < MaxEffects; i++)
+        {
+            auto &effect = m_effects[i];
+            if ((effect.state & Used) == 0)
+            {
+                const int32_t channel = reserveChannel();
+                if (channel < 0)
+                {
+                    return -1;
+                }
+                // allocate both tables in one go. one extra entry is read by DMA in the hblank of the last line
+                const uint32_t tableSize = (NrOfLines + 1) * hwordsPerLine;
+                auto tables = Memory::malloc_EWRAM<uint16_t>(2 * tableSize);
+                if (tables == nullptr)
+                {
+                    DMA::releaseChannel(channel);
+                    return -1;
+                }
+                Memory::memset32(tables, 0, tableSize);
+                effect.registerAddress = registerAddress;
+                effect.table[0] = tables;
+                effect.table[1] = tables + tableSize;
+                effect.hwordsPerLine = hwordsPerLine;
+                effect.channel = channel;
+                effect.state = Used;
+                effect.committed = false;
+                if (m_nrOfEffects++ == 0)
+                {
+                    Graphics::callAtVblank(update);
+                }
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    uint16_t *backTable(int32_t effect)
+    {
+        return isValid(effect) ? m_effects[effect].table[1] : nullptr;
+    }
+
+    void commit(int32_t effect)
+    {
+        if (isValid(effect))
+        {
+            m_effects[effect].committed = true;
+        }
+    }
+
+    void remove(int32_t effect)
+    {
+        if (isValid(effect))
+        {
+            auto &e = m_effects[effect];
+            REG_DMA[e.channel].control = 0;
+            DMA::releaseChannel(e.channel);
+            e.state = 0;
+            Memory::free(e.table[0] < e.table[1] ? e.table[0] : e.table[1]);
+            if (--m_nrOfEffects == 0)
+            {
+                Graphics::removeAtVblank(update);
+            }
+        }
+    }
+
+    void clear()
+    {
+        for (uint32_t i = 0; i < MaxEffects; i++)
+        {
+            remove(i);
+        }
+    }
+
+    void update()
+    {
+        for (uint32_t i = 0; i < MaxEffects; i++)
+        {
+            auto &effect = m_effects[i];
+            if ((effect.state & Used) && effect.committed)
+            {
+                auto front = effect.table[1];
+                effect.table[1] = effect.table[0];
+                effect.table[0] = front;
+                // the entry after the last line is written in vblank. repeat the first line there
+                for (uint32_t h = 0; h < effect.hwordsPerLine; h++)
+                {
+                    front[NrOfLines * effect.hwordsPerLine + h] = front[h];
+                }
+                effect.state = Used | Running;
+                effect.committed = false;
+            }
+            if (effect.state & Running)
+            {
+                // DMA is only triggered in the hblanks of lines 0-159, so the CPU writes the value for line 0
+                const uint16_t *front = effect.table[0];
+                auto &dma = REG_DMA[effect.channel];
+                dma.control = 0;
+                if (effect.hwordsPerLine == 1)
+                {
+                    *reinterpret_cast<volatile uint16_t *>(effect.registerAddress) = front[0];
+                    dma.source = reinterpret_cast<uint32_t>(front + 1);
+                    dma.destination = effect.registerAddress;
+                    dma.count = 1;
+                    dma.control = DMA_HBLANK | DMA_REPEAT | DMA16 | DMA_DST_RELOAD | DMA_SRC_INC | DMA_ENABLE;
+                }
+                else
+                {
+                    const uint32_t wordsPerLine = effect.hwordsPerLine >> 1;
+                    for (uint32_t w = 0; w < wordsPerLine; w++)
+                    {
+                        reinterpret_cast<volatile uint32_t *>(effect.registerAddress)[w] = reinterpret_cast<const uint32_t *>(front)[w];
+                    }
+                    dma.source = reinterpret_cast<uint32_t>(front + effect.hwordsPerLine);
+                    dma.destination = effect.registerAddress;
+                    dma.count = wordsPerLine;
+                    dma.control = DMA_HBLANK | DMA_REPEAT | DMA32 | DMA_DST_RELOAD | DMA_SRC_INC | DMA_ENABLE;
+                }
+            }
+        }
+    }
+
+} // namespace Effect_Scanline
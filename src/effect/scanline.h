@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+// Per-scanline register effects using HBlank DMA.
+// An effect writes one value per scanline from a 160-entry table to an I/O register, e.g. BGxHOFS, BG2PA-PD,
+// BLDALPHA, WINxH or a palette color. Tables are double-buffered: fill the back table during the frame and
+// commit() it. update() swaps committed tables and reprograms HBlank DMA at vblank, so effects cost no CPU
+// time during display. Every effect reserves its own DMA channel with DMA::reserveChannel(), trying DMA0, DMA1 and
+// DMA2 in that order. DMA1 and DMA2 are not available while DirectSound, e.g. AdpcmPlayer, is playing. DMA3 is kept for copying.
+namespace Effect_Scanline
+{
+
+    /// @brief Number of visible scanlines and table entries.
+    constexpr uint32_t NrOfLines = 160;
+
+    /// @brief Maximum number of effects running at the same time.
+    constexpr uint32_t MaxEffects = 3;
+
+    /// @brief Add an effect. DMA starts with the first commit().
+    /// @param registerAddress Address of the first register to write, e.g. (uint32_t)&REG_BG2HOFS or 0x05000000 for the backdrop color.
+    /// @param hwordsPerLine Number of 16-bit values written per scanline. Must be 1, 2 or 4,
+    /// e.g. 2 for 32-bit registers like BG2X or for BG0HOFS+BG0VOFS, 4 for BG2PA-PD.
+    /// @return Returns the effect index or -1 if no DMA channel can be reserved or out of memory.
+    int32_t add(uint32_t registerAddress, uint32_t hwordsPerLine = 1);
+
+    /// @brief Get table for the next frame. Holds NrOfLines entries of hwordsPerLine values each.
+    /// Entry n is written to the register before scanline n is displayed.
+    uint16_t *backTable(int32_t effect);
+
+    /// @brief Get table for the next frame. Holds NrOfLines entries of hwordsPerLine values each.
+    template <typename T>
+    T *backTable(int32_t effect) { return reinterpret_cast<T *>(backTable(effect)); }
+
+    /// @brief Mark back table as complete. It will be displayed starting with the next frame.
+    void commit(int32_t effect);
+
+    /// @brief Stop effect and free its tables. The register keeps its last value.
+    void remove(int32_t effect);
+
+    /// @brief Stop and remove all effects.
+    void clear();
+
+    /// @brief Swap committed tables and restart HBlank DMA. Registered at vblank automatically while effects exist.
+    void update();
+
+} // namespace Effect_Scanline
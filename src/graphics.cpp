@@ -39,7 +39,7 @@ namespace Graphics
 
     //---helper functions------------------------------------------------------------------
 
-    void addFunction(FunctionEntry *functions, uint32_t &nrOfFunctions, void (*function)(void *), void *data, uint16_t startLine = 0, uint16_t endLine = 0)
+    bool addFunction(FunctionEntry *functions, uint32_t &nrOfFunctions, void (*function)(void *), void *data, uint16_t startLine = 0, uint16_t endLine = 0)
     {
         if (nrOfFunctions < MaxVideoFunctions)
         {
@@ -49,10 +49,12 @@ namespace Graphics
             functions[nrOfFunctions].startLine = startLine > 227 ? 227 : startLine;
             functions[nrOfFunctions].endLine = endLine > 227 ? 227 : endLine;
             nrOfFunctions++;
+            return true;
         }
+        return false;
     }
 
-    void addFunction(FunctionEntry *functions, uint32_t &nrOfFunctions, void (*function)(), uint16_t startLine = 0, uint16_t endLine = 0)
+    bool addFunction(FunctionEntry *functions, uint32_t &nrOfFunctions, void (*function)(), uint16_t startLine = 0, uint16_t endLine = 0)
     {
         if (nrOfFunctions < MaxVideoFunctions)
         {
@@ -62,7 +64,9 @@ namespace Graphics
             functions[nrOfFunctions].startLine = startLine > 227 ? 227 : startLine;
             functions[nrOfFunctions].endLine = endLine > 227 ? 227 : endLine;
             nrOfFunctions++;
+            return true;
         }
+        return false;
     }
 
     void removeFunction(FunctionEntry *functions, uint32_t &nrOfFunctions, void (*function)(), const void *data)
@@ -158,14 +162,14 @@ namespace Graphics
         }
     }
 
-    void callAtVblank(void (*function)(void *), void *data)
+    bool callAtVblank(void (*function)(void *), void *data)
     {
-        addFunction(m_vblankFunctions, m_nrOfVblankFunctions, function, data);
+        return addFunction(m_vblankFunctions, m_nrOfVblankFunctions, function, data);
     }
 
-    void callAtVblank(void (*function)())
+    bool callAtVblank(void (*function)())
     {
-        addFunction(m_vblankFunctions, m_nrOfVblankFunctions, function);
+        return addFunction(m_vblankFunctions, m_nrOfVblankFunctions, function);
     }
 
     void removeAtVblank(void (*function)(void *), const void *data)
@@ -244,16 +248,16 @@ namespace Graphics
         }
     }
 
-    void callAtVcount(void (*function)(void *), void *data, uint16_t startLine, uint16_t endLine)
+    bool callAtVcount(void (*function)(void *), void *data, uint16_t startLine, uint16_t endLine)
     {
         endLine = endLine < startLine || endLine > 227 ? startLine : endLine;
-        addFunction(m_vcountFunctions, m_nrOfVcountFunctions, function, data, startLine, endLine);
+        return addFunction(m_vcountFunctions, m_nrOfVcountFunctions, function, data, startLine, endLine);
     }
 
-    void callAtVcount(void (*function)(), uint16_t startLine, uint16_t endLine)
+    bool callAtVcount(void (*function)(), uint16_t startLine, uint16_t endLine)
     {
         endLine = endLine < startLine || endLine > 227 ? startLine : endLine;
-        addFunction(m_vcountFunctions, m_nrOfVcountFunctions, function, startLine, endLine);
+        return addFunction(m_vcountFunctions, m_nrOfVcountFunctions, function, startLine, endLine);
     }
 
     void removeAtVcount(void (*function)(void *), const void *data)
@@ -587,7 +591,7 @@ namespace Graphics
             // copy scanlines
             for (uint32_t y = 0; y < blitHeight; ++y)
             {
-                // TODO: rewrite
+                Memory::memcpy8Write16bit(dest8, src8, blitWidth);
                 dest8 += m_width;
                 src8 += dataWidth;
             }
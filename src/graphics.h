@@ -134,10 +134,12 @@ namespace Graphics
     void vblankEnable(bool enable = true);
 
     /// @brief Register a function to be called when the system enters Vblank.
-    void callAtVblank(void (*function)(void *), void *data);
+    /// @return Returns false if all function slots are in use.
+    bool callAtVblank(void (*function)(void *), void *data);
 
     /// @brief Register a function to be called when the system enters Vblank.
-    void callAtVblank(void (*function)());
+    /// @return Returns false if all function slots are in use.
+    bool callAtVblank(void (*function)());
 
     /// @brief Unregister a function to be called when the system enters Vblank.
     void removeAtVblank(void (*function)(void *), const void *data = nullptr);
@@ -156,12 +158,14 @@ namespace Graphics
     /// @brief Register a function to be called when a specific screen display line is drawn.
     /// @note You MUST insert functions in increasing startLine order!
     /// Also endLine must be >= startLine. If endLine > 227 it will be ignored.
-    void callAtVcount(void (*function)(void *), void *data, uint16_t startLine, uint16_t endLine = UINT16_MAX);
+    /// @return Returns false if all function slots are in use.
+    bool callAtVcount(void (*function)(void *), void *data, uint16_t startLine, uint16_t endLine = UINT16_MAX);
 
     /// @brief Register a function to be called when a specific screen display line is drawn.
     /// @note You MUST insert functions in increasing startLine order!
     /// Also endLine must be >= startLine. If endLine > 227 it will be ignored.
-    void callAtVcount(void (*function)(), uint16_t startLine, uint16_t endLine = UINT16_MAX);
+    /// @return Returns false if all function slots are in use.
+    bool callAtVcount(void (*function)(), uint16_t startLine, uint16_t endLine = UINT16_MAX);
 
     /// @brief Unregister a function to be called when a specific screen display line is drawn.
     void removeAtVcount(void (*function)(void *), const void *data = nullptr);
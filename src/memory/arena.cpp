@@ -0,0 +1,47 @@
+#include "arena.h"
+
+#include "memory.h"
+
+namespace Memory
+{
+
+	bool Arena::reserveIWRAM(uint32_t nrOfBytes)
+	{
+		release();
+		void *memory = malloc_IWRAM(nrOfBytes);
+		if (memory == nullptr)
+		{
+			return false;
+		}
+		init(memory, nrOfBytes);
+		m_owned = true;
+		return true;
+	}
+
+	bool Arena::reserveEWRAM(uint32_t nrOfBytes)
+	{
+		release();
+		void *memory = malloc_EWRAM(nrOfBytes);
+		if (memory == nullptr)
+		{
+			return false;
+		}
+		init(memory, nrOfBytes);
+		m_owned = true;
+		return true;
+	}
+
+	void Arena::release()
+	{
+		if (m_owned)
+		{
+			Memory::free(m_start);
+		}
+		m_start = nullptr;
+		m_end = nullptr;
+		m_current = nullptr;
+		m_highWatermark = 0;
+		m_owned = false;
+	}
+
+} // namespace Memory
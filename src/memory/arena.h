@@ -0,0 +1,94 @@
+#pragma once
+
+#include "sys/base.h"
+
+#include <cstdint>
+
+namespace Memory
+{
+	/// @brief Linear scratch memory / bump-pointer allocator for per-frame or per-scene temporaries.
+	/// Reserve a region once, allocate from it in O(1) and release all allocations at once with reset().
+	/// There is no per-allocation header and no free(). Typical use:
+	///
+	/// Memory::Arena frameArena;
+	/// frameArena.reserveIWRAM(4096);
+	/// ...
+	/// auto vertices = frameArena.malloc<Math::fp1616vec3_t>(nrOfVertices);
+	/// ...
+	/// frameArena.reset(); // at the end of the frame
+	class Arena
+	{
+	public:
+		/// @brief Use a memory region as arena memory. The arena does not own the memory.
+		/// @param start Start of memory region. Will be aligned to 4 bytes.
+		/// @param nrOfBytes Size of memory region in bytes.
+		void init(void *start, uint32_t nrOfBytes)
+		{
+			const uintptr_t regionStart = (reinterpret_cast<uintptr_t>(start) + 3) & ~uintptr_t(3);
+			const uintptr_t regionEnd = (reinterpret_cast<uintptr_t>(start) + nrOfBytes) & ~uintptr_t(3);
+			m_start = reinterpret_cast<uint8_t *>(regionStart);
+			m_end = regionEnd > regionStart ? reinterpret_cast<uint8_t *>(regionEnd) : m_start;
+			m_current = m_start;
+			m_highWatermark = 0;
+			m_owned = false;
+		}
+
+		/// @brief Reserve arena memory from the IWRAM heap. Frees memory reserved before.
+		/// @return Returns true if the memory could be allocated.
+		bool reserveIWRAM(uint32_t nrOfBytes);
+
+		/// @brief Reserve arena memory from the EWRAM heap. Frees memory reserved before.
+		/// @return Returns true if the memory could be allocated.
+		bool reserveEWRAM(uint32_t nrOfBytes);
+
+		/// @brief Return memory reserved with reserveIWRAM() / reserveEWRAM() to the heap.
+		/// All pointers allocated from the arena become invalid.
+		void release();
+
+		/// @brief Allocate a block of arena memory.
+		/// @return Returns a 4-byte aligned pointer to the memory or nullptr if the arena is full.
+		void *malloc(uint32_t nrOfBytes)
+		{
+			const uint32_t size = (nrOfBytes + 3) & ~uint32_t(3);
+			if (size > static_cast<uint32_t>(m_end - m_current))
+			{
+				return nullptr;
+			}
+			uint8_t *result = m_current;
+			m_current += size;
+			const uint32_t used = m_current - m_start;
+			m_highWatermark = used > m_highWatermark ? used : m_highWatermark;
+			return result;
+		}
+
+		/// @brief Allocate a block of arena memory of specific type.
+		/// @param nrOfT Number of Ts to allocate.
+		/// @return Returns a pointer to the memory or nullptr if the arena is full.
+		template <typename T>
+		T *malloc(uint32_t nrOfT) { return reinterpret_cast<T *>(malloc(sizeof(T) * nrOfT)); }
+
+		/// @brief Release all allocations at once. The high watermark is kept.
+		void reset() { m_current = m_start; }
+
+		/// @brief Number of bytes currently allocated.
+		uint32_t used() const { return m_current - m_start; }
+
+		/// @brief Number of bytes in arena.
+		uint32_t size() const { return m_end - m_start; }
+
+		/// @brief Maximum number of bytes that were allocated at the same time since the arena was set up.
+		/// Use this to size the arena.
+		uint32_t highWatermark() const { return m_highWatermark; }
+
+		/// @brief Reset the high watermark to the currently allocated number of bytes.
+		void resetHighWatermark() { m_highWatermark = used(); }
+
+	private:
+		uint8_t *m_start = nullptr;
+		uint8_t *m_end = nullptr;
+		uint8_t *m_current = nullptr;
+		uint32_t m_highWatermark = 0;
+		bool m_owned = false; // true if memory was allocated from a heap
+	};
+
+} // namespace Memory
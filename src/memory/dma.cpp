@@ -5,6 +5,7 @@
 namespace DMA
 {
     IWRAM_DATA uint32_t DMAFillTempValue;
+    IWRAM_DATA uint32_t m_reservedChannels = 0; // Bit n set if channel n is reserved
 
     void dma_fill16(void *destination, uint16_t value, uint16_t nrOfHwords, uint16_t channel, uint16_t mode)
     {
@@ -89,4 +90,26 @@ namespace DMA
         REG_DMA[channel].count = nrOfWords;
         REG_DMA[channel].control = DMA_HBLANK | DMA_REPEAT | DMA32 | DMA_DST_FIXED | DMA_SRC_INC | DMA_ENABLE;
     }
+
+    bool reserveChannel(uint16_t channel)
+    {
+        const uint32_t bit = 1 << (channel & 3);
+        if (m_reservedChannels & bit)
+        {
+            return false;
+        }
+        m_reservedChannels |= bit;
+        return true;
+    }
+
+    void releaseChannel(uint16_t channel)
+    {
+        m_reservedChannels &= ~(1 << (channel & 3));
+    }
+
+    bool isChannelReserved(uint16_t channel)
+    {
+        return (m_reservedChannels & (1 << (channel & 3))) != 0;
+    }
+
 } // namespace DMA
\ No newline at end of file
@@ -49,4 +49,16 @@ namespace DMA
     /// @brief Start 32-bit H-blank DMA
     void dma_hdma(uint32_t *destination, const uint32_t *source, uint16_t nrOfWords, uint16_t channel = 3);
 
+    /// @brief Reserve a DMA channel for a long-running repeating transfer, e.g. HBlank effects or DirectSound FIFOs.
+    /// Modules that program a channel permanently must reserve it first, so they don't silently steal it from each other.
+    /// DMA3 is used for copying everywhere and should not be reserved.
+    /// @return Returns false if the channel is already reserved.
+    bool reserveChannel(uint16_t channel);
+
+    /// @brief Release a channel reserved with reserveChannel().
+    void releaseChannel(uint16_t channel);
+
+    /// @brief Returns true if the channel has been reserved.
+    bool isChannelReserved(uint16_t channel);
+
 } // namespace DMA
\ No newline at end of file
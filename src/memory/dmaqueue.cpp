@@ -0,0 +1,177 @@
+#include "dmaqueue.h"
+
+#include "sys/base.h"
+#ifdef TARGET_PC
+#include <cstring>
+#else
+#include "memory.h"
+#include "sys/interrupts.h"
+#endif
+
+namespace DMA
+{
+
+    struct Transfer
+    {
+        uintptr_t destination;
+        uintptr_t source;
+        uint32_t nrOfBytes;
+        Priority priority;
+    } __attribute__((aligned(4), packed));
+
+    EWRAM_BSS Transfer m_queue[MaxQueuedTransfers];
+    uint32_t m_queueDepth = 0;
+    uint32_t m_queueBudget = DefaultQueueBudget;
+    QueueStats m_queueStats = {0, 0, 0, 0, 0, 0};
+
+    // Keeps the vblank handler from processing the queue while it is being changed
+    class IrqLock
+    {
+    public:
+#ifdef TARGET_PC
+        IrqLock() {}
+#else
+        IrqLock() : m_ime(Irq::RegIme)
+        {
+            Irq::RegIme = 0;
+        }
+        ~IrqLock()
+        {
+            Irq::RegIme = m_ime;
+        }
+
+    private:
+        uint16_t m_ime;
+#endif
+    };
+
+    // Copy with the CPU. processQueue() runs in the vblank interrupt and using DMA3 would break a transfer the
+    // main loop is setting up. ldm / stm bursts from ROM or EWRAM are about as fast as DMA3
+    inline void copy(uintptr_t destination, uintptr_t source, uint32_t nrOfBytes)
+    {
+#ifdef TARGET_PC
+        memcpy(reinterpret_cast<void *>(destination), reinterpret_cast<const void *>(source), nrOfBytes);
+#else
+        if (((destination | source | nrOfBytes) & 3) == 0)
+        {
+            Memory::memcpy32(reinterpret_cast<void *>(destination), reinterpret_cast<const void *>(source), nrOfBytes >> 2);
+        }
+        else
+        {
+            Memory::memcpy16(reinterpret_cast<void *>(destination), reinterpret_cast<const void *>(source), nrOfBytes >> 1);
+        }
+#endif
+    }
+
+    bool enqueue(void *destination, const void *source, uint32_t nrOfBytes, Priority priority)
+    {
+        const uintptr_t dst = reinterpret_cast<uintptr_t>(destination);
+        const uintptr_t src = reinterpret_cast<uintptr_t>(source);
+        if (((dst | src | nrOfBytes) & 1) != 0)
+        {
+            return false;
+        }
+        if (nrOfBytes == 0)
+        {
+            return true;
+        }
+        IrqLock lock;
+        if (m_queueDepth >= MaxQueuedTransfers)
+        {
+            m_queueStats.dropped++;
+            return false;
+        }
+        // insert behind all transfers with the same or higher priority
+        uint32_t i = m_queueDepth;
+        while (i > 0 && m_queue[i - 1].priority > priority)
+        {
+            m_queue[i] = m_queue[i - 1];
+            i--;
+        }
+        m_queue[i] = {dst, src, nrOfBytes, priority};
+        m_queueDepth++;
+        m_queueStats.maxDepth = m_queueDepth > m_queueStats.maxDepth ? m_queueDepth : m_queueStats.maxDepth;
+        return true;
+    }
+
+    // Copy transfers from the front of the queue until budget is used up and remove finished transfers
+    void process(uint32_t budget)
+    {
+        uint32_t done = 0;
+        uint32_t transferred = 0;
+        while (done < m_queueDepth)
+        {
+            auto &transfer = m_queue[done];
+            // split transfer if it does not fit. keep word-aligned transfers word-aligned
+            const uint32_t granularity = ((transfer.destination | transfer.source | transfer.nrOfBytes) & 3) == 0 ? 4 : 2;
+            uint32_t chunk = transfer.nrOfBytes < budget ? transfer.nrOfBytes : budget;
+            chunk &= ~(granularity - 1);
+            if (chunk == 0)
+            {
+                break;
+            }
+            copy(transfer.destination, transfer.source, chunk);
+            transfer.destination += chunk;
+            transfer.source += chunk;
+            transfer.nrOfBytes -= chunk;
+            transferred += chunk;
+            budget -= chunk;
+            if (transfer.nrOfBytes == 0)
+            {
+                done++;
+            }
+        }
+        // move remaining transfers to the front
+        for (uint32_t i = done; i < m_queueDepth; i++)
+        {
+            m_queue[i - done] = m_queue[i];
+        }
+        m_queueDepth -= done;
+        m_queueStats.deferred += m_queueDepth;
+        m_queueStats.lastBytes = transferred;
+    }
+
+    void processQueue()
+    {
+        process(m_queueBudget);
+    }
+
+    void flushQueue()
+    {
+        IrqLock lock;
+        process(~0U);
+    }
+
+    void clearQueue()
+    {
+        IrqLock lock;
+        m_queueDepth = 0;
+    }
+
+    void setQueueBudget(uint32_t nrOfBytes)
+    {
+        m_queueBudget = nrOfBytes;
+    }
+
+    QueueStats queueStats()
+    {
+        IrqLock lock;
+        QueueStats result = m_queueStats;
+        result.depth = m_queueDepth;
+        result.pendingBytes = 0;
+        for (uint32_t i = 0; i < m_queueDepth; i++)
+        {
+            result.pendingBytes += m_queue[i].nrOfBytes;
+        }
+        return result;
+    }
+
+    void resetQueueStats()
+    {
+        IrqLock lock;
+        m_queueStats.maxDepth = m_queueDepth;
+        m_queueStats.deferred = 0;
+        m_queueStats.dropped = 0;
+    }
+
+} // namespace DMA
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+
+// Queue for uploads to VRAM, palette RAM and OAM.
+// Code enqueues transfers during the frame and processQueue() copies them in vblank. The copies use the CPU,
+// not DMA3, because processQueue() runs in the vblank interrupt and could break a DMA3 transfer being set up.
+// Only a limited number of bytes is copied per call, the rest is carried over to the next frame,
+// so many uploads in one frame do not overrun vblank and cause tearing.
+// Register processQueue() with Graphics::callAtVblank(DMA::processQueue).
+namespace DMA
+{
+
+    /// @brief Transfer priority. Higher priority transfers are processed first.
+    enum class Priority : uint8_t
+    {
+        High = 0,
+        Normal = 1,
+        Low = 2
+    };
+
+    /// @brief Queue usage report.
+    struct QueueStats
+    {
+        uint16_t depth;          // Number of transfers currently queued
+        uint16_t maxDepth;       // Maximum number of transfers queued since last reset
+        uint32_t pendingBytes;   // Number of bytes waiting to be transferred
+        uint32_t lastBytes;      // Number of bytes transferred in the last processQueue() call
+        uint32_t deferred;       // Number of times a transfer was carried over to the next frame
+        uint32_t dropped;        // Number of transfers rejected because the queue was full
+    } __attribute__((aligned(4), packed));
+
+    /// @brief Maximum number of queued transfers.
+    constexpr uint32_t MaxQueuedTransfers = 32;
+
+    /// @brief Default number of bytes copied per processQueue() call.
+    /// Copying needs roughly 4-6 cycles per word from ROM, so this uses about a third of vblank.
+    constexpr uint32_t DefaultQueueBudget = 16 * 1024;
+
+    /// @brief Queue a transfer. Source data must stay valid until the transfer is done.
+    /// Transfers use 32-bit copies if addresses and size are word-aligned, else 16-bit copies.
+    /// @param destination Destination address. Must be 2-byte aligned.
+    /// @param source Source address. Must be 2-byte aligned.
+    /// @param nrOfBytes Transfer size. Must be a multiple of 2.
+    /// @param priority Transfer priority. Transfers with the same priority are processed in order.
+    /// @return Returns false if the queue is full or the transfer is not properly aligned.
+    bool enqueue(void *destination, const void *source, uint32_t nrOfBytes, Priority priority = Priority::Normal);
+
+    /// @brief Copy queued transfers until the byte budget is used up. Call only in vblank.
+    /// Transfers larger than the remaining budget are split.
+    void processQueue();
+
+    /// @brief Copy all queued transfers, ignoring the budget, e.g. in scene setup with the screen turned off.
+    void flushQueue();
+
+    /// @brief Remove all queued transfers without copying.
+    void clearQueue();
+
+    /// @brief Set number of bytes copied per processQueue() call.
+    void setQueueBudget(uint32_t nrOfBytes);
+
+    /// @brief Get queue usage report.
+    QueueStats queueStats();
+
+    /// @brief Reset maximum depth, deferred and dropped counts.
+    void resetQueueStats();
+
+} // namespace DMA
@@ -0,0 +1,417 @@
+// #define DEBUG_MEMORY
+#include "heap.h"
+
+#ifdef TARGET_PC
+#include <cstring>
+#endif
+
+#ifdef DEBUG_MEMORY
+#include "print/output.h"
+#define GUARD_VALUE 0xDEADBEEF
+#endif
+
+namespace Memory
+{
+	/// @brief Header of one block of allocated or free memory.
+	/// The free list links are only valid for free blocks and overlap the user data otherwise.
+	/// Links are stored as 32-bit byte offsets relative to the block itself, 0 meaning no block, so the
+	/// header has the same size on the target and on 64-bit hosts and host replays fragment like the target.
+	struct Heap::Block
+	{
+#ifdef DEBUG_MEMORY
+		uint32_t GUARD;
+#endif
+		int32_t previousOffset;	// offset to previous physical block. 0 if first block.
+		uint32_t size;			// size of user data in bytes. bit 0 is set if the block is free, bit 1 if it is movable.
+		int32_t nextFreeOffset; // offset to next block in same free list. 0 if last block.
+		int32_t prevFreeOffset; // offset to previous block in same free list. 0 if first block.
+
+		static constexpr uint32_t FreeBit = 1;
+		static constexpr uint32_t MovableBit = 2;
+
+		uint32_t blockSize() const { return size & ~(Alignment - 1); }
+		bool isFree() const { return (size & FreeBit) != 0; }
+		bool isMovable() const { return (size & MovableBit) != 0; }
+		void setSize(uint32_t s) { size = s | (size & (FreeBit | MovableBit)); }
+		void setFree(bool free) { size = free ? (size | FreeBit) : (size & ~FreeBit); }
+		void setMovable(bool movable) { size = movable ? (size | MovableBit) : (size & ~MovableBit); }
+		Block *previous() const { return link(previousOffset); }
+		Block *nextFree() const { return link(nextFreeOffset); }
+		Block *prevFree() const { return link(prevFreeOffset); }
+		void setPrevious(const Block *block) { previousOffset = offsetTo(block); }
+		void setNextFree(const Block *block) { nextFreeOffset = offsetTo(block); }
+		void setPrevFree(const Block *block) { prevFreeOffset = offsetTo(block); }
+		uint8_t *data() { return reinterpret_cast<uint8_t *>(&nextFreeOffset); }
+		Block *next() { return reinterpret_cast<Block *>(data() + blockSize()); }
+		static Block *fromData(void *address) { return reinterpret_cast<Block *>(static_cast<uint8_t *>(address) - HeaderSize); }
+
+		static const uint32_t HeaderSize; // management data in front of user data
+		static const uint32_t MinSize;	  // free blocks must be able to hold the free list links
+
+	private:
+		Block *link(int32_t offset) const { return offset == 0 ? nullptr : reinterpret_cast<Block *>(const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(this)) + offset); }
+		int32_t offsetTo(const Block *block) const { return block == nullptr ? 0 : static_cast<int32_t>(reinterpret_cast<const uint8_t *>(block) - reinterpret_cast<const uint8_t *>(this)); }
+	} __attribute__((aligned(4), packed));
+
+	constexpr uint32_t Heap::Block::HeaderSize = sizeof(Heap::Block) - 2 * sizeof(int32_t);
+	constexpr uint32_t Heap::Block::MinSize = 2 * sizeof(int32_t);
+
+#ifndef TARGET_PC
+	static_assert(sizeof(Heap) == Heap::TargetSize, "Heap::TargetSize does not match heap structure");
+#endif
+
+	// Find last set bit, so floor(log2(x)). x must be != 0
+	FORCEINLINE uint32_t findLastSet(uint32_t x)
+	{
+		return 31 - __builtin_clz(x);
+	}
+
+	// Find first set bit. x must be != 0
+	FORCEINLINE uint32_t findFirstSet(uint32_t x)
+	{
+		return __builtin_ctz(x);
+	}
+
+	// Map block size to first-level and second-level size class
+	FORCEINLINE void mapping(uint32_t size, uint32_t &fl, uint32_t &sl)
+	{
+		if (size < Heap::SmallBlockSize)
+		{
+			fl = 0;
+			sl = size >> Heap::AlignmentLog2;
+		}
+		else
+		{
+			const uint32_t t = findLastSet(size);
+			sl = (size >> (t - Heap::SlCountLog2)) ^ Heap::SlCount;
+			fl = t - Heap::FlShift + 1;
+		}
+	}
+
+	Heap *Heap::create(void *start, uint32_t nrOfBytes)
+	{
+		// align start and end of region to block alignment
+		const uintptr_t regionStart = (reinterpret_cast<uintptr_t>(start) + Alignment - 1) & ~uintptr_t(Alignment - 1);
+		const uintptr_t regionEnd = (reinterpret_cast<uintptr_t>(start) + nrOfBytes) & ~uintptr_t(Alignment - 1);
+		// we need space for the heap structure, one free block and the sentinel block
+		const uint32_t minRegionSize = sizeof(Heap) + Block::HeaderSize + Block::MinSize + Block::HeaderSize;
+		if (regionEnd <= regionStart || (regionEnd - regionStart) < minRegionSize)
+		{
+			return nullptr;
+		}
+		Heap *heap = reinterpret_cast<Heap *>(regionStart);
+		heap->m_flBitmap = 0;
+		for (uint32_t fl = 0; fl < FlCount; ++fl)
+		{
+			heap->m_slBitmap[fl] = 0;
+			for (uint32_t sl = 0; sl < SlCount; ++sl)
+			{
+				heap->m_freeLists[fl][sl] = nullptr;
+			}
+		}
+		heap->m_start = reinterpret_cast<uint8_t *>(regionStart + sizeof(Heap));
+		heap->m_end = reinterpret_cast<uint8_t *>(regionEnd);
+		heap->m_usedBytes = 0;
+		heap->m_freeBytes = 0;
+		heap->m_nrOfUsedBlocks = 0;
+		heap->m_nrOfFreeBlocks = 0;
+		heap->m_highWatermark = 0;
+		// the sentinel is a zero-size used block at the very end of the region, so we never need to check for the last block
+		Block *sentinel = reinterpret_cast<Block *>(heap->m_end - Block::HeaderSize);
+		// one big free block covering the rest of the region
+		Block *block = reinterpret_cast<Block *>(heap->m_start);
+		uint32_t blockSize = reinterpret_cast<uint8_t *>(sentinel) - block->data();
+		blockSize = blockSize > MaxAllocationSize ? (MaxAllocationSize & ~(Alignment - 1)) : blockSize;
+		sentinel = reinterpret_cast<Block *>(block->data() + blockSize);
+#ifdef DEBUG_MEMORY
+		block->GUARD = GUARD_VALUE;
+		sentinel->GUARD = GUARD_VALUE;
+#endif
+		block->setPrevious(nullptr);
+		block->size = blockSize;
+		sentinel->setPrevious(block);
+		sentinel->size = 0;
+		heap->insertFreeBlock(block);
+#ifdef DEBUG_MEMORY
+		Debug::printf("Reserving %d bytes starting at 0x%x", blockSize, reinterpret_cast<uint32_t>(block->data()));
+		Debug::printf("Block header is %d bytes", Block::HeaderSize);
+#endif
+		return heap;
+	}
+
+	void Heap::insertFreeBlock(Block *block)
+	{
+		uint32_t fl;
+		uint32_t sl;
+		mapping(block->blockSize(), fl, sl);
+		Block *head = m_freeLists[fl][sl];
+		block->setNextFree(head);
+		block->setPrevFree(nullptr);
+		if (head != nullptr)
+		{
+			head->setPrevFree(block);
+		}
+		m_freeLists[fl][sl] = block;
+		m_flBitmap |= 1 << fl;
+		m_slBitmap[fl] |= 1 << sl;
+		block->setFree(true);
+		m_freeBytes += block->blockSize();
+		m_nrOfFreeBlocks++;
+	}
+
+	void Heap::removeFreeBlock(Block *block)
+	{
+		uint32_t fl;
+		uint32_t sl;
+		mapping(block->blockSize(), fl, sl);
+		if (block->nextFree() != nullptr)
+		{
+			block->nextFree()->setPrevFree(block->prevFree());
+		}
+		if (block->prevFree() != nullptr)
+		{
+			block->prevFree()->setNextFree(block->nextFree());
+		}
+		else
+		{
+			// block was list head. if the list is empty now, clear bitmap bits
+			m_freeLists[fl][sl] = block->nextFree();
+			if (block->nextFree() == nullptr)
+			{
+				m_slBitmap[fl] &= ~(1 << sl);
+				if (m_slBitmap[fl] == 0)
+				{
+					m_flBitmap &= ~(1 << fl);
+				}
+			}
+		}
+		block->setFree(false);
+		m_freeBytes -= block->blockSize();
+		m_nrOfFreeBlocks--;
+	}
+
+	Heap::Block *Heap::findFreeBlock(uint32_t size)
+	{
+		// round size up to the next size class, so any block in the class found is big enough
+		if (size >= SmallBlockSize)
+		{
+			size += (1 << (findLastSet(size) - SlCountLog2)) - 1;
+		}
+		uint32_t fl;
+		uint32_t sl;
+		mapping(size, fl, sl);
+		if (fl >= FlCount)
+		{
+			return nullptr;
+		}
+		// search for free list in this first-level class with size >= sl
+		uint32_t slMap = m_slBitmap[fl] & (~0U << sl);
+		if (slMap == 0)
+		{
+			// none found. search for next bigger first-level class
+			const uint32_t flMap = m_flBitmap & (~0U << (fl + 1));
+			if (flMap == 0)
+			{
+				return nullptr;
+			}
+			fl = findFirstSet(flMap);
+			slMap = m_slBitmap[fl];
+		}
+		sl = findFirstSet(slMap);
+		return m_freeLists[fl][sl];
+	}
+
+	void *Heap::malloc(uint32_t nrOfBytes)
+	{
+#ifdef DEBUG_MEMORY
+		check();
+#endif
+		if (nrOfBytes == 0 || nrOfBytes > MaxAllocationSize)
+		{
+			return nullptr;
+		}
+		// pad the size to a multiple of 4, so all data is properly aligned to 32bit. this gives much faster access!
+		uint32_t size = (nrOfBytes + Alignment - 1) & ~(Alignment - 1);
+		size = size < Block::MinSize ? Block::MinSize : size;
+		Block *block = findFreeBlock(size);
+		if (block == nullptr)
+		{
+#ifdef DEBUG_MEMORY
+			Debug::printf("Out of memory! Failed to allocate %d bytes!", size);
+#endif
+			return nullptr;
+		}
+		removeFreeBlock(block);
+		// check if the remaining size is big enough to hold another block
+		const uint32_t blockSize = block->blockSize();
+		if (blockSize >= size + Block::HeaderSize + Block::MinSize)
+		{
+			// yes. insert free block behind this one
+			Block *remaining = reinterpret_cast<Block *>(block->data() + size);
+#ifdef DEBUG_MEMORY
+			remaining->GUARD = GUARD_VALUE;
+#endif
+			remaining->setPrevious(block);
+			remaining->size = blockSize - size - Block::HeaderSize;
+			remaining->next()->setPrevious(remaining);
+			block->setSize(size);
+			insertFreeBlock(remaining);
+		}
+		m_usedBytes += block->blockSize();
+		m_nrOfUsedBlocks++;
+		m_highWatermark = m_usedBytes > m_highWatermark ? m_usedBytes : m_highWatermark;
+#ifdef DEBUG_MEMORY
+		Debug::printf("Allocating %d bytes at 0x%x", block->blockSize(), reinterpret_cast<uint32_t>(block->data()));
+#endif
+		return block->data();
+	}
+
+	void Heap::free(void *address)
+	{
+#ifdef DEBUG_MEMORY
+		check();
+#endif
+		Block *block = Block::fromData(address);
+		// check if used
+		if (block->isFree())
+		{
+			return;
+		}
+#ifdef DEBUG_MEMORY
+		Debug::printf("Freeing %d bytes at 0x%x", block->blockSize(), reinterpret_cast<uint32_t>(address));
+#endif
+		m_usedBytes -= block->blockSize();
+		m_nrOfUsedBlocks--;
+		// mark block as free now, so a stale header left over after combining blocks is never freed twice
+		block->setFree(true);
+		block->setMovable(false);
+		// is the block before this free? combine the two blocks
+		Block *previous = block->previous();
+		if (previous != nullptr && previous->isFree())
+		{
+			removeFreeBlock(previous);
+			previous->setSize(previous->blockSize() + Block::HeaderSize + block->blockSize());
+			previous->next()->setPrevious(previous);
+			block = previous;
+		}
+		// is the block behind this free? combine the two blocks. the sentinel is never free
+		Block *next = block->next();
+		if (next->isFree())
+		{
+			removeFreeBlock(next);
+			block->setSize(block->blockSize() + Block::HeaderSize + next->blockSize());
+			block->next()->setPrevious(block);
+		}
+		insertFreeBlock(block);
+	}
+
+	bool Heap::contains(const void *address) const
+	{
+		return address >= m_start && address < m_end;
+	}
+
+	HeapStats Heap::stats() const
+	{
+		HeapStats result;
+		result.size = m_end - m_start;
+		result.used = m_usedBytes;
+		result.free = m_freeBytes;
+		result.largestFree = 0;
+		result.usedBlocks = m_nrOfUsedBlocks;
+		result.freeBlocks = m_nrOfFreeBlocks;
+		result.highWatermark = m_highWatermark;
+		// the largest free block is in the highest non-empty size class
+		if (m_flBitmap != 0)
+		{
+			const uint32_t fl = findLastSet(m_flBitmap);
+			const uint32_t sl = findLastSet(m_slBitmap[fl]);
+			for (const Block *block = m_freeLists[fl][sl]; block != nullptr; block = block->nextFree())
+			{
+				result.largestFree = block->blockSize() > result.largestFree ? block->blockSize() : result.largestFree;
+			}
+		}
+		return result;
+	}
+
+	void Heap::setMovable(void *address)
+	{
+		Block::fromData(address)->setMovable(true);
+	}
+
+	uint32_t Heap::compact(bool (*canMove)(void *address), void (*moved)(void *from, void *to))
+	{
+#ifdef DEBUG_MEMORY
+		check();
+#endif
+		uint32_t nrOfMovedBlocks = 0;
+		// walk all blocks up to the sentinel
+		Block *block = reinterpret_cast<Block *>(m_start);
+		while (block->blockSize() != 0)
+		{
+			Block *previous = block->previous();
+			if (!block->isFree() && block->isMovable() && previous != nullptr && previous->isFree() && canMove(block->data()))
+			{
+				// slide block down into the free block in front of it. the free block moves behind it
+				removeFreeBlock(previous);
+				const uint32_t freeSize = previous->blockSize();
+				const uint32_t size = block->blockSize();
+				uint8_t *from = block->data();
+				// destination is below source, so copying upwards is safe even if the regions overlap
+#ifdef TARGET_PC
+				memmove(previous->data(), from, size);
+#else
+				memcpy32(previous->data(), from, size / 4);
+#endif
+				Block *movedBlock = previous;
+				movedBlock->size = size;
+				movedBlock->setMovable(true);
+				Block *freeBlock = reinterpret_cast<Block *>(movedBlock->data() + size);
+#ifdef DEBUG_MEMORY
+				freeBlock->GUARD = GUARD_VALUE;
+#endif
+				freeBlock->setPrevious(movedBlock);
+				freeBlock->size = freeSize;
+				Block *next = freeBlock->next();
+				next->setPrevious(freeBlock);
+				// combine with the free block behind it
+				if (next->isFree())
+				{
+					removeFreeBlock(next);
+					freeBlock->setSize(freeSize + Block::HeaderSize + next->blockSize());
+					freeBlock->next()->setPrevious(freeBlock);
+				}
+				insertFreeBlock(freeBlock);
+				moved(from, movedBlock->data());
+				nrOfMovedBlocks++;
+				block = movedBlock;
+			}
+			block = block->next();
+		}
+#ifdef DEBUG_MEMORY
+		Debug::printf("Compacted heap, moved %d blocks", nrOfMovedBlocks);
+#endif
+		return nrOfMovedBlocks;
+	}
+
+#ifdef DEBUG_MEMORY
+	void Heap::check() const
+	{
+		Block *block = reinterpret_cast<Block *>(m_start);
+		while (reinterpret_cast<uint8_t *>(block) < m_end)
+		{
+			if (block->GUARD != GUARD_VALUE)
+			{
+				Debug::printf("Memory corruption in block 0x%x!", reinterpret_cast<uint32_t>(block));
+				return;
+			}
+			if (block->blockSize() == 0)
+			{
+				// sentinel reached
+				return;
+			}
+			block = block->next();
+		}
+	}
+#endif
+
+} // namespace Memory
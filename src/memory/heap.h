@@ -0,0 +1,93 @@
+#pragma once
+
+#include "memory.h"
+#include "sys/base.h"
+
+#include <cstdint>
+
+namespace Memory
+{
+	/// @brief Two-level segregated fit (TLSF) heap manager working on a fixed memory region.
+	/// Free blocks are kept in size-segregated free lists that are found through two bitmaps,
+	/// so malloc() and free() take constant time regardless of how many blocks are in the heap.
+	/// The heap management structure is placed at the start of the region it manages and every
+	/// block carries an 8 byte header, so all management data is kept in the specific RAM it is for.
+	/// See: http://www.gii.upv.es/tlsf/
+	class Heap
+	{
+	public:
+		/// @brief Allocation alignment in bytes. All sizes are padded to this.
+		static constexpr uint32_t AlignmentLog2 = 2;
+		static constexpr uint32_t Alignment = 1 << AlignmentLog2;
+
+		/// @brief Number of second-level subdivisions per power of two size class.
+		static constexpr uint32_t SlCountLog2 = 2;
+		static constexpr uint32_t SlCount = 1 << SlCountLog2;
+
+		/// @brief Sizes below this all go to the first first-level class.
+		static constexpr uint32_t FlShift = SlCountLog2 + AlignmentLog2;
+		static constexpr uint32_t SmallBlockSize = 1 << FlShift;
+
+		/// @brief log2 of largest block size managed. 256 kB covers all of EWRAM.
+		static constexpr uint32_t MaxSizeLog2 = 18;
+		static constexpr uint32_t FlCount = MaxSizeLog2 - FlShift + 1;
+
+		/// @brief Maximum size of a single allocation in bytes.
+		static constexpr uint32_t MaxAllocationSize = (1 << MaxSizeLog2) - 1;
+
+		/// @brief Size of the heap structure with 32-bit pointers as on the target. Host tools replaying target
+		/// allocations add sizeof(Heap) - TargetSize to the region size, so the blocks get the same addresses.
+		static constexpr uint32_t TargetSize = 4 * (1 + FlCount + FlCount * SlCount + 2 + 2) + 2 * 2 + 4;
+
+		/// @brief Set up a heap in a memory region. The heap structure itself is placed at the start of the region.
+		/// @param start Start of memory region. Will be aligned to 4 bytes.
+		/// @param nrOfBytes Size of memory region in bytes.
+		/// @return Returns the heap or nullptr if the region is too small.
+		static Heap *create(void *start, uint32_t nrOfBytes);
+
+		/// @brief Allocate a block of memory from the heap.
+		/// @return Returns a 4-byte aligned pointer to the memory or nullptr if allocation failed.
+		void *malloc(uint32_t nrOfBytes);
+
+		/// @brief Free a block of memory allocated from this heap. Freeing a block twice is ignored.
+		void free(void *address);
+
+		/// @brief Check if address lies inside the memory managed by this heap.
+		bool contains(const void *address) const;
+
+		/// @brief Get usage statistics. Needs to walk one free list to find the largest free block.
+		HeapStats stats() const;
+
+		/// @brief Mark an allocated block as movable, so compact() may relocate it.
+		void setMovable(void *address);
+
+		/// @brief Slide movable blocks towards the start of the heap into free space in front of them, so free space coalesces.
+		/// Blocks that are not movable stay where they are. Data is moved with memcpy32.
+		/// @param canMove Called before moving a block. Return false to keep the block in place.
+		/// @param moved Called after a block has been moved from one data address to another.
+		/// @return Returns the number of blocks moved.
+		uint32_t compact(bool (*canMove)(void *address), void (*moved)(void *from, void *to));
+
+	private:
+		struct Block;
+
+		/// @brief Walk all blocks and check for corrupted block headers. Only available with DEBUG_MEMORY.
+		void check() const;
+
+		void insertFreeBlock(Block *block);
+		void removeFreeBlock(Block *block);
+		Block *findFreeBlock(uint32_t size);
+
+		uint32_t m_flBitmap;				   // Bit n set if there are free blocks in first-level class n
+		uint32_t m_slBitmap[FlCount];		   // Bit m set if there are free blocks in second-level class m
+		Block *m_freeLists[FlCount][SlCount]; // Free block list heads for each size class
+		uint8_t *m_start;					   // Start of first block
+		uint8_t *m_end;						   // End of sentinel block
+		uint32_t m_usedBytes;				   // Sum of user data size of all used blocks
+		uint32_t m_freeBytes;				   // Sum of user data size of all free blocks
+		uint16_t m_nrOfUsedBlocks;			   // Number of used blocks
+		uint16_t m_nrOfFreeBlocks;			   // Number of free blocks
+		uint32_t m_highWatermark;			   // Maximum of m_usedBytes since heap creation
+	} __attribute__((aligned(4)));
+
+} // namespace Memory
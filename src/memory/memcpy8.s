@@ -0,0 +1,279 @@
+@ Byte-granular memcpy / memmove for any source and destination alignment.
+@ The destination is aligned to words first. If the source is then word-aligned too, data is copied
+@ with 8-register ldm/stm bursts, else aligned source words are shift-merged into destination words.
+@ memmove8 does the same backward from the end of the buffers when the destination overlaps above the source.
+
+@ === Shift-merge copy for source misaligned by \k bytes ====================
+@ r0: dst (word-aligned), r1: src aligned down, r2: byte count
+@ r12: first source word, r3-r11: data buffer
+@ On exit r0, r1 point behind the copied words, r2 = remaining byte count (0-3)
+.macro SHIFT_COPY k
+    mov     r12, r12, lsr #(8*\k)       @ r12 = carry bytes from first word
+    subs    r2, r2, #32
+    blo     2f
+1:  ldmia   r1!, {r3-r10}
+    mov     r11, r10, lsr #(8*\k)       @ carry for next burst
+    mov     r10, r10, lsl #(32-8*\k)    @ merge words back to front, so inputs are still intact
+    orr     r10, r10, r9, lsr #(8*\k)
+    mov     r9, r9, lsl #(32-8*\k)
+    orr     r9, r9, r8, lsr #(8*\k)
+    mov     r8, r8, lsl #(32-8*\k)
+    orr     r8, r8, r7, lsr #(8*\k)
+    mov     r7, r7, lsl #(32-8*\k)
+    orr     r7, r7, r6, lsr #(8*\k)
+    mov     r6, r6, lsl #(32-8*\k)
+    orr     r6, r6, r5, lsr #(8*\k)
+    mov     r5, r5, lsl #(32-8*\k)
+    orr     r5, r5, r4, lsr #(8*\k)
+    mov     r4, r4, lsl #(32-8*\k)
+    orr     r4, r4, r3, lsr #(8*\k)
+    mov     r3, r3, lsl #(32-8*\k)
+    orr     r3, r3, r12
+    stmia   r0!, {r3-r10}
+    mov     r12, r11
+    subs    r2, r2, #32
+    bhs     1b
+2:  add     r2, r2, #32
+    @ residual words
+    subs    r2, r2, #4
+    blo     4f
+3:  ldr     r3, [r1], #4
+    orr     r4, r12, r3, lsl #(32-8*\k)
+    str     r4, [r0], #4
+    mov     r12, r3, lsr #(8*\k)
+    subs    r2, r2, #4
+    bhs     3b
+4:  add     r2, r2, #4
+    sub     r1, r1, #(4-\k)             @ point src to first byte not copied
+    bx      lr
+.endm
+
+@ === Backward shift-merge copy for source misaligned by \k bytes ===========
+@ r0: end of dst (word-aligned), r1: end of src aligned down, r2: byte count
+@ r12: last source word, r3-r11: data buffer
+@ On exit r0, r1 point to the first copied byte, r2 = remaining byte count (0-3)
+.macro SHIFT_COPY_BACK k
+    mov     r12, r12, lsl #(32-8*\k)    @ r12 = carry bytes from last word
+    subs    r2, r2, #32
+    blo     2f
+1:  ldmdb   r1!, {r3-r10}
+    mov     r11, r3, lsl #(32-8*\k)     @ carry for next burst
+    mov     r3, r3, lsr #(8*\k)         @ merge words front to back, so inputs are still intact
+    orr     r3, r3, r4, lsl #(32-8*\k)
+    mov     r4, r4, lsr #(8*\k)
+    orr     r4, r4, r5, lsl #(32-8*\k)
+    mov     r5, r5, lsr #(8*\k)
+    orr     r5, r5, r6, lsl #(32-8*\k)
+    mov     r6, r6, lsr #(8*\k)
+    orr     r6, r6, r7, lsl #(32-8*\k)
+    mov     r7, r7, lsr #(8*\k)
+    orr     r7, r7, r8, lsl #(32-8*\k)
+    mov     r8, r8, lsr #(8*\k)
+    orr     r8, r8, r9, lsl #(32-8*\k)
+    mov     r9, r9, lsr #(8*\k)
+    orr     r9, r9, r10, lsl #(32-8*\k)
+    mov     r10, r10, lsr #(8*\k)
+    orr     r10, r10, r12
+    stmdb   r0!, {r3-r10}
+    mov     r12, r11
+    subs    r2, r2, #32
+    bhs     1b
+2:  add     r2, r2, #32
+    @ residual words
+    subs    r2, r2, #4
+    blo     4f
+3:  ldr     r3, [r1, #-4]!
+    orr     r4, r12, r3, lsr #(8*\k)
+    str     r4, [r0, #-4]!
+    mov     r12, r3, lsl #(32-8*\k)
+    subs    r2, r2, #4
+    bhs     3b
+4:  add     r2, r2, #4
+    add     r1, r1, #\k                 @ point src to first byte copied
+    b       .Lmove8_bytes
+.endm
+
+.section .iwram,"ax", %progbits
+.arm
+.cpu arm7tdmi
+.align 2
+
+@ === Copy words to word-aligned destination ================================
+@ r0: dst (word-aligned), r1: src, r2: byte count
+@ Trashes r3-r12. On exit r0, r1 point behind the copied words, r2 = remaining byte count (0-3)
+.Lcopy_words:
+    ands    r3, r1, #3
+    bne     .Lcopy_words_unaligned
+    @ copy 32 byte chunks with 8-register ldm/stm
+    subs    r2, r2, #32
+    blo     2f
+1:  ldmia   r1!, {r3-r10}
+    stmia   r0!, {r3-r10}
+    subs    r2, r2, #32
+    bhs     1b
+2:  add     r2, r2, #32
+    @ residual words
+3:  subs    r2, r2, #4
+    ldrhs   r3, [r1], #4
+    strhs   r3, [r0], #4
+    bhs     3b
+    add     r2, r2, #4
+    bx      lr
+.Lcopy_words_unaligned:
+    bic     r1, r1, #3
+    ldr     r12, [r1], #4
+    cmp     r3, #2
+    beq     .Lcopy_words_shift2
+    bhi     .Lcopy_words_shift3
+    SHIFT_COPY 1
+.Lcopy_words_shift2:
+    SHIFT_COPY 2
+.Lcopy_words_shift3:
+    SHIFT_COPY 3
+
+@ === void memcpy8(void *dst, const void *src, uint32_t count) IWRAM_CODE; ==
+@ r0, r1: dst, src
+@ r2: byte count
+.global memcpy8
+.type memcpy8,function
+memcpy8:
+    @ short copies byte by byte
+    cmp     r2, #16
+    bhs     1f
+0:  subs    r2, r2, #1
+    ldrcsb  r3, [r1], #1
+    strcsb  r3, [r0], #1
+    bhi     0b
+    bx      lr
+1:  push    {r4-r11, lr}
+    @ align dst to words
+    ands    r3, r0, #3
+    beq     2f
+    rsb     r3, r3, #4
+    sub     r2, r2, r3
+3:  ldrb    r12, [r1], #1
+    strb    r12, [r0], #1
+    subs    r3, r3, #1
+    bne     3b
+2:  bl      .Lcopy_words
+    @ residual bytes
+4:  subs    r2, r2, #1
+    ldrcsb  r3, [r1], #1
+    strcsb  r3, [r0], #1
+    bhi     4b
+    pop     {r4-r11, lr}
+    bx      lr
+.size memcpy8, .-memcpy8
+
+@ === void memcpy8Write16bit(void *dst, const void *src, uint32_t count) IWRAM_CODE;
+@ Like memcpy8, but never stores bytes. Single bytes are merged into halfwords, so this is safe for VRAM.
+@ r0, r1: dst, src
+@ r2: byte count
+.global memcpy8Write16bit
+.type memcpy8Write16bit,function
+memcpy8Write16bit:
+    push    {r4-r11, lr}
+    cmp     r2, #0
+    beq     .Lw16_done
+    @ dst odd: merge first byte into high byte of halfword
+    tst     r0, #1
+    beq     1f
+    ldrh    r3, [r0, #-1]!
+    ldrb    r4, [r1], #1
+    and     r3, r3, #0xFF
+    orr     r3, r3, r4, lsl #8
+    strh    r3, [r0], #2
+    subs    r2, r2, #1
+    beq     .Lw16_done
+    @ dst not word-aligned: copy one halfword
+1:  tst     r0, #2
+    beq     2f
+    cmp     r2, #2
+    blo     .Lw16_tail
+    ldrb    r3, [r1], #1
+    ldrb    r4, [r1], #1
+    orr     r3, r3, r4, lsl #8
+    strh    r3, [r0], #2
+    sub     r2, r2, #2
+2:  bl      .Lcopy_words
+.Lw16_tail:
+    @ 0-3 bytes left
+    cmp     r2, #2
+    blo     3f
+    ldrb    r3, [r1], #1
+    ldrb    r4, [r1], #1
+    orr     r3, r3, r4, lsl #8
+    strh    r3, [r0], #2
+    sub     r2, r2, #2
+3:  cmp     r2, #1
+    bne     .Lw16_done
+    @ merge last byte into low byte of halfword
+    ldrh    r3, [r0]
+    ldrb    r4, [r1]
+    bic     r3, r3, #0xFF
+    orr     r3, r3, r4
+    strh    r3, [r0]
+.Lw16_done:
+    pop     {r4-r11, lr}
+    bx      lr
+.size memcpy8Write16bit, .-memcpy8Write16bit
+
+@ === void memmove8(void *dst, const void *src, uint32_t count) IWRAM_CODE; =
+@ r0, r1: dst, src
+@ r2: byte count
+.global memmove8
+.type memmove8,function
+memmove8:
+    @ copy forward if dst is below src or behind the end of src
+    sub     r3, r0, r1
+    cmp     r3, r2
+    bhs     memcpy8
+    @ overlapping with dst above src. copy backward
+    push    {r4-r11}
+    add     r0, r0, r2
+    add     r1, r1, r2
+    @ align end of dst to words
+1:  tst     r0, #3
+    beq     2f
+    subs    r2, r2, #1
+    blo     6f
+    ldrb    r3, [r1, #-1]!
+    strb    r3, [r0, #-1]!
+    b       1b
+2:  ands    r3, r1, #3
+    bne     .Lmove8_unaligned
+    @ src and dst have the same alignment. copy 32 byte chunks with 8-register ldm/stm
+    subs    r2, r2, #32
+    blo     3f
+4:  ldmdb   r1!, {r3-r10}
+    stmdb   r0!, {r3-r10}
+    subs    r2, r2, #32
+    bhs     4b
+3:  add     r2, r2, #32
+    @ residual words
+7:  subs    r2, r2, #4
+    ldrhs   r3, [r1, #-4]!
+    strhs   r3, [r0, #-4]!
+    bhs     7b
+    add     r2, r2, #4
+    @ residual bytes
+.Lmove8_bytes:
+5:  subs    r2, r2, #1
+    ldrcsb  r3, [r1, #-1]!
+    strcsb  r3, [r0, #-1]!
+    bhi     5b
+6:  pop     {r4-r11}
+    bx      lr
+    @ different alignments. shift-merge aligned source words
+.Lmove8_unaligned:
+    bic     r1, r1, #3
+    ldr     r12, [r1]
+    cmp     r3, #2
+    beq     .Lmove8_shift2
+    bhi     .Lmove8_shift3
+    SHIFT_COPY_BACK 1
+.Lmove8_shift2:
+    SHIFT_COPY_BACK 2
+.Lmove8_shift3:
+    SHIFT_COPY_BACK 3
+.size memmove8, .-memmove8
@@ -1,10 +1,9 @@
+// #define DEBUG_MEMORY
+// #define TRACE_MEMORY
 #include "memory.h"
+#include "heap.h"
 
-// #define DEBUG_MEMORY
-#ifdef DEBUG_MEMORY
 #include "print/output.h"
-#define GUARD_VALUE 0xDEADBEEF
-#endif
 
 extern uint32_t __iheap_start; // Points to the start of free IWRAM
 extern uint32_t __sp_usr;	   // Points to the end of the stack in IWRAM, which grows in direction of __iheap_start
@@ -13,234 +12,310 @@ extern uint32_t __eheap_end;   // Points to the end of free EWRAM
 
 namespace Memory
 {
-	// Simple memory heap manager for IWRAM/EWRAM. Heap memory grows towards the end of the reserved memory
-	// Management structures are at the very start of each block.
-	// After the management structure follows the allocated memory.
+	// Heap managers for IWRAM/EWRAM. Heap memory grows towards the end of the reserved memory.
+	// Each heap is a two-level segregated fit allocator (see heap.h), so malloc and free run in constant time.
 	// Management structures are all kept in the specific RAM they're for.
 
-	constexpr uint32_t StackSize = 1024; // Amount of memory to reserve for stack
 	IWRAM_DATA bool m_isInitialized = false;
+	IWRAM_DATA Heap *m_iwramHeap = nullptr;
+	IWRAM_DATA Heap *m_ewramHeap = nullptr;
 
-	/// @brief Structure for one block of allocated or free memory.
-	struct MemoryBlock
+	// Relocatable memory. The first word of a relocatable block stores its handle, so compact() can update the table
+	struct HandleEntry
 	{
-#ifdef DEBUG_MEMORY
-		uint32_t GUARD;
-#endif
-		struct
-		{
-			unsigned int size : 24; // size of allocated memory returned to user
-			unsigned int free : 8;	// true if the block is free memory.
-		};
-		MemoryBlock *previous; // pointer to previous block. nullptr if first block.
-		MemoryBlock *next;	   // pointer to next block. nullptr if last block.
+		uint32_t *block; // block data or nullptr if entry is unused
+		uint16_t lockCount;
 	} __attribute__((aligned(4), packed));
 
-	void init()
+	EWRAM_BSS HandleEntry m_handles[MaxHandles]; // entry 0 is never used, because 0 is the invalid handle
+
+#ifdef TRACE_MEMORY
+	// Allocation trace ring buffer. m_traceCount counts all entries ever written
+	EWRAM_BSS TraceEntry m_trace[TraceSize];
+	EWRAM_BSS uint32_t m_traceCount;
+
+	FORCEINLINE void trace(TraceOp op, const void *address, uint32_t size)
 	{
-		// clear all memory if existant. we reserve one big free block at the start of the memory pool for both iwram and ewram.
-		MemoryBlock *block_iwram = reinterpret_cast<MemoryBlock *>(&__iheap_start);
-#ifdef DEBUG_MEMORY
-		block_iwram->GUARD = GUARD_VALUE;
-#endif
-		block_iwram->size = (reinterpret_cast<uint32_t>(&__sp_usr) - StackSize - reinterpret_cast<uint32_t>(&__iheap_start)) - sizeof(MemoryBlock);
-		block_iwram->free = true;
-		block_iwram->previous = nullptr;
-		block_iwram->next = nullptr;
-		MemoryBlock *block_ewram = reinterpret_cast<MemoryBlock *>(&__eheap_start);
-#ifdef DEBUG_MEMORY
-		block_ewram->GUARD = GUARD_VALUE;
-#endif
-		block_ewram->size = (reinterpret_cast<uint32_t>(&__eheap_end) - reinterpret_cast<uint32_t>(&__eheap_start)) - sizeof(MemoryBlock);
-		block_ewram->free = true;
-		block_ewram->previous = nullptr;
-		block_ewram->next = nullptr;
-#ifdef DEBUG_MEMORY
-		Debug::printf("Reserving %d bytes of IWRAM starting at 0x%x", uint32_t(block_iwram->size), reinterpret_cast<uint32_t>(block_iwram));
-		Debug::printf("Reserving %d bytes of EWRAM starting at 0x%x", uint32_t(block_ewram->size), reinterpret_cast<uint32_t>(block_ewram));
-		Debug::printf("sizeof(MemoryBlock) is %d bytes", (uint16_t)sizeof(MemoryBlock));
+		auto &entry = m_trace[m_traceCount++ & (TraceSize - 1)];
+		entry.address = reinterpret_cast<uint32_t>(address);
+		entry.info = (static_cast<uint32_t>(op) << 24) | (size & 0xFFFFFF);
+	}
 #endif
+
+	// Stack painting. The stack grows down from __sp_usr to __sp_usr - StackSize where the IWRAM heap ends
+	constexpr uint32_t StackPaint = 0x57AC57AC;
+	constexpr uint32_t StackGuardWords = 4; // if any of the lowest words of the stack reserve is used, the stack overflowed
+	IWRAM_DATA bool m_stackOverflowReported = false;
+
+	FORCEINLINE uint32_t *stackBottom()
+	{
+		return reinterpret_cast<uint32_t *>(reinterpret_cast<uint32_t>(&__sp_usr) - StackSize);
 	}
 
-#ifdef DEBUG_MEMORY
-	void checkMemory()
+	void paintStack()
 	{
-		MemoryBlock *iwBlock = reinterpret_cast<MemoryBlock *>(&__iheap_start);
-		if (iwBlock->GUARD != GUARD_VALUE)
+		// paint from the bottom of the reserve up to a bit below the current stack pointer, which is in use
+		uint32_t *stackPointer;
+		asm volatile("mov %0, sp"
+					 : "=r"(stackPointer));
+		uint32_t *current = stackBottom();
+		uint32_t *end = stackPointer - 16;
+		while (current < end)
 		{
-			Debug::printf("Memory corruption in IWRAM block 0x%x!", iwBlock);
+			*current++ = StackPaint;
 		}
-		while (iwBlock->next != nullptr)
-		{
-			iwBlock = iwBlock->next;
-			if (iwBlock->GUARD != GUARD_VALUE)
-			{
-				Debug::printf("Memory corruption in IWRAM block 0x%x!", iwBlock);
-			}
-		}
-		MemoryBlock *ewBlock = reinterpret_cast<MemoryBlock *>(&__eheap_start);
-		if (ewBlock->GUARD != GUARD_VALUE)
+		m_stackOverflowReported = false;
+	}
+
+	uint32_t stackHighWatermark()
+	{
+		const uint32_t *current = stackBottom();
+		const uint32_t *end = &__sp_usr;
+		while (current < end && *current == StackPaint)
 		{
-			Debug::printf("Memory corruption in EWRAM block 0x%x!", ewBlock);
+			++current;
 		}
-		while (ewBlock->next != nullptr)
+		return reinterpret_cast<uint32_t>(end) - reinterpret_cast<uint32_t>(current);
+	}
+
+	bool stackOverflowed()
+	{
+		const uint32_t *bottom = stackBottom();
+		for (uint32_t i = 0; i < StackGuardWords; ++i)
 		{
-			ewBlock = ewBlock->next;
-			if (ewBlock->GUARD != GUARD_VALUE)
+			if (bottom[i] != StackPaint)
 			{
-				Debug::printf("Memory corruption in EWRAM block 0x%x!", ewBlock);
+				return true;
 			}
 		}
+		return false;
 	}
-#endif
 
-#ifdef DEBUG_MEMORY
-	void *malloc_internal(uint32_t size, uint8_t *memory, const char *name)
+	void checkStack()
 	{
-		if (!m_isInitialized)
+		if (!m_stackOverflowReported && stackOverflowed())
 		{
-			m_isInitialized = true;
-			init();
+			Debug::printf("Stack overflow into IWRAM heap at 0x%x!", reinterpret_cast<uint32_t>(stackBottom()));
+			m_stackOverflowReported = true;
 		}
-		checkMemory();
-#else
-	void *malloc_internal(uint32_t size, uint8_t *memory)
+	}
+
+	void init()
 	{
 		if (!m_isInitialized)
 		{
-			m_isInitialized = true;
-			init();
+			paintStack();
 		}
-#endif
-		if (size > 0 && size < 262144)
+		// clear all memory if existant. we reserve one big free block at the start of the memory pool for both iwram and ewram.
+		const uint32_t iwramSize = reinterpret_cast<uint32_t>(&__sp_usr) - StackSize - reinterpret_cast<uint32_t>(&__iheap_start);
+		m_iwramHeap = Heap::create(&__iheap_start, iwramSize);
+		const uint32_t ewramSize = reinterpret_cast<uint32_t>(&__eheap_end) - reinterpret_cast<uint32_t>(&__eheap_start);
+		m_ewramHeap = Heap::create(&__eheap_start, ewramSize);
+		for (uint32_t i = 0; i < MaxHandles; ++i)
 		{
-			// pad the size to a multiple of 4, so all data is properly aligned to 32bit. this gives much faster access!
-			size = (size + 3) & 0xFFFFFFFC;
-			// calculate how much size we need including the management structures
-			const uint32_t combinedSizeNeeded = size + sizeof(MemoryBlock);
-			// strategy: find the first free block big enough for size + management structure
-			MemoryBlock *currentBlock = reinterpret_cast<MemoryBlock *>(memory);
-			do
-			{
-				// block must be free and big enough
-				if (currentBlock->free && currentBlock->size >= combinedSizeNeeded)
-				{
-#ifdef DEBUG_MEMORY
-					Debug::printf("Allocating %d bytes of %s at 0x%x", size, name, reinterpret_cast<uint32_t>(currentBlock) + sizeof(MemoryBlock));
-#endif
-					// check if the remaining size would be bigger than management data
-					if (currentBlock->size - combinedSizeNeeded > sizeof(MemoryBlock))
-					{
-						// yes. insert free block behind this one
-						MemoryBlock *freeBlock = reinterpret_cast<MemoryBlock *>(reinterpret_cast<uint8_t *>(currentBlock) + combinedSizeNeeded);
-						freeBlock->size = currentBlock->size - combinedSizeNeeded;
-#ifdef DEBUG_MEMORY
-						Debug::printf("Inserting free block with %d bytes of %s at 0x%x", uint32_t(freeBlock->size), name, reinterpret_cast<uint32_t>(freeBlock) + sizeof(MemoryBlock));
-						freeBlock->GUARD = GUARD_VALUE;
+			m_handles[i].block = nullptr;
+			m_handles[i].lockCount = 0;
+		}
+		m_isInitialized = true;
+#ifdef TRACE_MEMORY
+		trace(TraceOp::Init, nullptr, 0);
 #endif
-						freeBlock->free = true;
-						freeBlock->previous = currentBlock;
-						freeBlock->next = currentBlock->next;
-						currentBlock->next = freeBlock;
-					}
-					// mark current block as used
-					currentBlock->size = size;
-					currentBlock->free = false;
-					// new block starts directly after management structure
-					return (reinterpret_cast<uint8_t *>(currentBlock) + sizeof(MemoryBlock));
-				}
-				// block is not free, or too small. skip to next block
-				currentBlock = currentBlock->next;
-			} while (currentBlock != nullptr);
-			// error. no memory available.
 #ifdef DEBUG_MEMORY
-			Debug::printf("Out of %s! Failed to allocate %d bytes!", name, size);
+		Debug::printf("Reserving %d bytes of IWRAM starting at 0x%x", iwramSize, reinterpret_cast<uint32_t>(&__iheap_start));
+		Debug::printf("Reserving %d bytes of EWRAM starting at 0x%x", ewramSize, reinterpret_cast<uint32_t>(&__eheap_start));
 #endif
-		}
-		return nullptr;
 	}
 
 	void *malloc_IWRAM(uint32_t size)
 	{
+		if (!m_isInitialized)
+		{
+			init();
+		}
 #ifdef DEBUG_MEMORY
-		return malloc_internal(size, (uint8_t *)&__iheap_start, "IWRAM");
+		Debug::printf("Allocating %d bytes of IWRAM", size);
+#endif
+#ifdef TRACE_MEMORY
+		void *address = m_iwramHeap->malloc(size);
+		trace(TraceOp::MallocIWRAM, address, size);
+		return address;
 #else
-		return malloc_internal(size, (uint8_t *)&__iheap_start);
+		return m_iwramHeap->malloc(size);
 #endif
 	}
 
 	void *malloc_EWRAM(uint32_t size)
 	{
+		if (!m_isInitialized)
+		{
+			init();
+		}
 #ifdef DEBUG_MEMORY
-		return malloc_internal(size, (uint8_t *)&__eheap_start, "EWRAM");
+		Debug::printf("Allocating %d bytes of EWRAM", size);
+#endif
+#ifdef TRACE_MEMORY
+		void *address = m_ewramHeap->malloc(size);
+		trace(TraceOp::MallocEWRAM, address, size);
+		return address;
 #else
-		return malloc_internal(size, (uint8_t *)&__eheap_start);
+		return m_ewramHeap->malloc(size);
 #endif
 	}
 
-#ifdef DEBUG_MEMORY
 	void free(void *adress)
 	{
-		checkMemory();
-#else
-	void free(void *adress)
-	{
-#endif
-		if ((adress >= &__iheap_start && adress < (&__sp_usr - StackSize + sizeof(void *))) ||
-			(adress >= &__eheap_start && adress < (&__eheap_end + sizeof(void *))))
+		if (!m_isInitialized || adress == nullptr)
 		{
-			// memory points to start of memory. skip to management structure from there
-			MemoryBlock *currentBlock = reinterpret_cast<MemoryBlock *>(static_cast<uint8_t *>(adress) - sizeof(MemoryBlock));
-			// check if used
-			if (!currentBlock->free)
-			{
-#ifdef DEBUG_MEMORY
-				Debug::printf("Freeing %d bytes at 0x%x", (uint32_t)currentBlock->size, adress);
+			return;
+		}
+#ifdef TRACE_MEMORY
+		trace(TraceOp::Free, adress, 0);
 #endif
-				// mark block as free now
-				currentBlock->free = true;
-				// are there blocks behind this? are they free?
-				while (currentBlock->next != nullptr && currentBlock->next->free)
-				{
+		if (m_iwramHeap->contains(adress))
+		{
+			m_iwramHeap->free(adress);
+		}
+		else if (m_ewramHeap->contains(adress))
+		{
+			m_ewramHeap->free(adress);
+		}
 #ifdef DEBUG_MEMORY
-					Debug::printf("Combining free blocks current 0x%x and next 0x%x", reinterpret_cast<uint32_t>(currentBlock) + sizeof(MemoryBlock), reinterpret_cast<uint32_t>(currentBlock->next) + sizeof(MemoryBlock));
+		else
+		{
+			Debug::print("Adress not in IWRAM or EWRAM heap!");
+		}
 #endif
-					// combine the two blocks
-					currentBlock->size += currentBlock->next->size + sizeof(MemoryBlock);
-					currentBlock->next = currentBlock->next->next;
-					if (currentBlock->next)
-					{
-						currentBlock->next->previous = currentBlock;
-					}
-				}
-				// are there blocks before this? are they free?
-				while (currentBlock->previous != nullptr && currentBlock->previous->free)
+	}
+
+	void free(const void *adress)
+	{
+		free(const_cast<void *>(adress));
+	}
+
+	Handle malloc_Handle(uint32_t size)
+	{
+		if (!m_isInitialized)
+		{
+			init();
+		}
+		for (uint32_t i = 1; i < MaxHandles; ++i)
+		{
+			if (m_handles[i].block == nullptr)
+			{
+				auto block = static_cast<uint32_t *>(m_ewramHeap->malloc(size + sizeof(uint32_t)));
+				if (block == nullptr)
 				{
-#ifdef DEBUG_MEMORY
-					Debug::printf("Combining free blocks previous 0x%x and current 0x%x", reinterpret_cast<uint32_t>(currentBlock->previous) + sizeof(MemoryBlock), reinterpret_cast<uint32_t>(currentBlock) + sizeof(MemoryBlock));
-#endif
-					// combine the two blocks
-					currentBlock->previous->size += currentBlock->size + sizeof(MemoryBlock);
-					currentBlock->previous->next = currentBlock->next;
-					if (currentBlock->previous->next)
-					{
-						currentBlock->next->previous = currentBlock->previous;
-					}
-					currentBlock = currentBlock->previous;
+					return 0;
 				}
+				block[0] = i;
+				m_ewramHeap->setMovable(block);
+				m_handles[i].block = block;
+				m_handles[i].lockCount = 0;
+				return i;
 			}
 		}
 #ifdef DEBUG_MEMORY
-		else
+		Debug::print("Out of handles!");
+#endif
+		return 0;
+	}
+
+	void *lock(Handle handle)
+	{
+		if (handle == 0 || handle >= MaxHandles || m_handles[handle].block == nullptr)
 		{
-			Debug::print("Adress not in IWRAM or EWRAM heap!");
+			return nullptr;
+		}
+		m_handles[handle].lockCount++;
+		return m_handles[handle].block + 1;
+	}
+
+	void unlock(Handle handle)
+	{
+		if (handle != 0 && handle < MaxHandles && m_handles[handle].lockCount > 0)
+		{
+			m_handles[handle].lockCount--;
 		}
+	}
+
+	void freeHandle(Handle handle)
+	{
+		if (handle == 0 || handle >= MaxHandles || m_handles[handle].block == nullptr)
+		{
+			return;
+		}
+		m_ewramHeap->free(m_handles[handle].block);
+		m_handles[handle].block = nullptr;
+		m_handles[handle].lockCount = 0;
+	}
+
+	bool canMoveHandleBlock(void *address)
+	{
+		return m_handles[*static_cast<uint32_t *>(address)].lockCount == 0;
+	}
+
+	void movedHandleBlock(void *, void *to)
+	{
+		m_handles[*static_cast<uint32_t *>(to)].block = static_cast<uint32_t *>(to);
+	}
+
+	uint32_t compact()
+	{
+		if (!m_isInitialized)
+		{
+			return 0;
+		}
+		return m_ewramHeap->compact(canMoveHandleBlock, movedHandleBlock);
+	}
+
+	Stats stats()
+	{
+		if (!m_isInitialized)
+		{
+			init();
+		}
+		return {m_iwramHeap->stats(), m_ewramHeap->stats()};
+	}
+
+	uint32_t traceRead(TraceEntry *destination, uint32_t maxEntries)
+	{
+#ifdef TRACE_MEMORY
+		const uint32_t nrOfEntries = m_traceCount < TraceSize ? m_traceCount : TraceSize;
+		const uint32_t nrToCopy = nrOfEntries < maxEntries ? nrOfEntries : maxEntries;
+		// copy the newest entries, oldest first
+		for (uint32_t i = 0; i < nrToCopy; ++i)
+		{
+			destination[i] = m_trace[(m_traceCount - nrToCopy + i) & (TraceSize - 1)];
+		}
+		return nrToCopy;
+#else
+		return 0;
 #endif
 	}
 
-	void free(const void *adress)
+	uint32_t traceLost()
 	{
-		free(const_cast<void *>(adress));
+#ifdef TRACE_MEMORY
+		return m_traceCount > TraceSize ? m_traceCount - TraceSize : 0;
+#else
+		return 0;
+#endif
+	}
+
+	void tracePrint()
+	{
+#ifdef TRACE_MEMORY
+		if (traceLost() > 0)
+		{
+			Debug::printf("memtrace lost %d", traceLost());
+		}
+		const uint32_t nrOfEntries = m_traceCount < TraceSize ? m_traceCount : TraceSize;
+		for (uint32_t i = 0; i < nrOfEntries; ++i)
+		{
+			const auto &entry = m_trace[(m_traceCount - nrOfEntries + i) & (TraceSize - 1)];
+			Debug::printf("memtrace %x %x", entry.address, entry.info);
+		}
+#endif
 	}
 
 } // namespace Memory
@@ -6,6 +6,30 @@
 
 namespace Memory
 {
+	/// @brief Set up the IWRAM and EWRAM heaps. All previous allocations are discarded.
+	/// Called automatically on the first allocation. Paints the stack on the first call.
+	void init();
+
+	/// @brief Amount of IWRAM reserved for the stack below __sp_usr. The IWRAM heap ends there.
+	/// Interrupt handlers run in system mode and use this stack too.
+	constexpr uint32_t StackSize = 1024;
+
+	/// @brief Fill unused stack memory with a pattern, so stackHighWatermark() can find out how much stack was used.
+	/// Called by init() on the first call. Call it early in main() to measure from boot.
+	void paintStack();
+
+	/// @brief Get the maximum number of bytes of stack used since paintStack() by looking for the untouched pattern.
+	/// If this gets close to StackSize, increase the stack reserve or reduce stack usage.
+	uint32_t stackHighWatermark();
+
+	/// @brief Check if the stack has grown down to the bottom of its reserve and thus into the IWRAM heap.
+	/// Cheap enough to be called every frame, e.g. with Graphics::callAtVblank(Memory::checkStack).
+	bool stackOverflowed();
+
+	/// @brief Print a message through Debug::printf once if the stack has overflown into the IWRAM heap.
+	/// Register with Graphics::callAtVblank(Memory::checkStack) for an optional per-frame check.
+	void checkStack();
+
 	/// @brief Allocate a block of IWRAM.
 	/// @return Returns a pointer to the memory or NULL if allocation failed.
 	void *malloc_IWRAM(uint32_t nrOfBytes);
@@ -32,6 +56,91 @@ namespace Memory
 	/// @brief Free IWRAM or EWRAM memory.
 	void free(const void *adress);
 
+	/// @brief Handle to relocatable EWRAM memory. 0 is an invalid handle.
+	using Handle = uint16_t;
+
+	/// @brief Maximum number of handles that can be allocated at the same time.
+	constexpr uint32_t MaxHandles = 128;
+
+	/// @brief Allocate a block of relocatable EWRAM that can be moved by compact().
+	/// Use lock() to get a pointer to the memory.
+	/// @return Returns a handle to the memory or 0 if allocation failed.
+	Handle malloc_Handle(uint32_t nrOfBytes);
+
+	/// @brief Get pointer to memory of handle and prevent compact() from moving it. Locks can be nested.
+	/// @return Returns a pointer to the memory or NULL if the handle is invalid.
+	void *lock(Handle handle);
+
+	/// @brief Get pointer to memory of handle of specific type and prevent compact() from moving it.
+	/// @return Returns a pointer to the memory or NULL if the handle is invalid.
+	template <typename T>
+	T *lock(Handle handle) { return reinterpret_cast<T *>(lock(handle)); }
+
+	/// @brief Allow compact() to move memory of handle again. Pointers returned from lock() may become invalid.
+	void unlock(Handle handle);
+
+	/// @brief Free relocatable memory. The handle becomes invalid.
+	void freeHandle(Handle handle);
+
+	/// @brief Move unlocked relocatable EWRAM blocks together, so free space coalesces and big allocations can succeed again.
+	/// Takes time depending on how much memory needs to be moved, so call this e.g. during a scene transition.
+	/// @return Returns the number of blocks moved.
+	uint32_t compact();
+
+	/// @brief Usage statistics for one heap. All sizes are in bytes. All but size exclude block headers.
+	struct HeapStats
+	{
+		uint32_t size;			/// Size of the block area incl. block headers. Excludes the heap structure at the start of the region
+		uint32_t used;			/// Memory currently allocated
+		uint32_t free;			/// Memory currently free
+		uint32_t largestFree;	/// Size of largest free block. Allocations up to this size might succeed
+		uint16_t usedBlocks;	/// Number of allocated blocks
+		uint16_t freeBlocks;	/// Number of free blocks. Many free blocks mean fragmentation
+		uint32_t highWatermark; /// Maximum memory allocated at the same time since init()
+	} __attribute__((aligned(4), packed));
+
+	/// @brief Usage statistics for all heaps.
+	struct Stats
+	{
+		HeapStats iwram;
+		HeapStats ewram;
+	} __attribute__((aligned(4), packed));
+
+	/// @brief Get current heap usage statistics.
+	Stats stats();
+
+	/// @brief Allocator operation recorded in trace.
+	enum class TraceOp : uint8_t
+	{
+		Init = 0,		 /// Heaps were reset
+		MallocIWRAM = 1, /// IWRAM allocation. Address is 0 if it failed
+		MallocEWRAM = 2, /// EWRAM allocation. Address is 0 if it failed
+		Free = 3		 /// Memory was freed. Size is 0
+	};
+
+	/// @brief One entry in the allocation trace.
+	struct TraceEntry
+	{
+		uint32_t address; /// Address returned from malloc or passed to free
+		uint32_t info;	  /// Bits 0-23: Number of bytes requested, bits 24-31: TraceOp
+	} __attribute__((aligned(4), packed));
+
+	/// @brief Number of entries in allocation trace ring buffer.
+	constexpr uint32_t TraceSize = 256;
+
+	/// @brief Copy the allocation trace to a buffer, oldest entry first.
+	/// Tracing needs TRACE_MEMORY to be defined in memory.cpp, else no entries are recorded.
+	/// @return Returns the number of entries copied.
+	uint32_t traceRead(TraceEntry *destination, uint32_t maxEntries);
+
+	/// @brief Number of trace entries that have been overwritten, because the ring buffer wrapped around.
+	uint32_t traceLost();
+
+	/// @brief Print the allocation trace through Debug::printf, oldest entry first, as lines "memtrace <address> <info>" in hex.
+	/// If entries have been lost, a line "memtrace lost <count>" in decimal is printed first.
+	/// Feed the emulator log to the memtrace host tool to replay it against the heap.
+	void tracePrint();
+
 	/// @brief Copy words from source to destination.
 	/// @param destination Copy destination.
 	/// @param source Copy source.
@@ -56,6 +165,27 @@ namespace Memory
 	/// @param nrOfWords Number of words to set.
 	extern "C" void memset32(void *destination, uint32_t value, uint32_t nrOfWords) IWRAM_FUNC;
 
+	/// @brief Copy bytes from source to destination. Source and destination can have any alignment.
+	/// Uses word copies with 8-register ldm/stm bursts or shift-merging if source and destination alignment differ.
+	/// Writes single bytes at the start and end of destination, so don't use for VRAM.
+	/// @param destination Copy destination.
+	/// @param source Copy source.
+	/// @param nrOfBytes Number of bytes to copy.
+	extern "C" void memcpy8(void *destination, const void *source, uint32_t nrOfBytes) IWRAM_FUNC;
+
+	/// @brief Copy bytes from source to destination like memcpy8, but never write single bytes. Safe for VRAM.
+	/// @param destination Copy destination.
+	/// @param source Copy source.
+	/// @param nrOfBytes Number of bytes to copy.
+	extern "C" void memcpy8Write16bit(void *destination, const void *source, uint32_t nrOfBytes) IWRAM_FUNC;
+
+	/// @brief Copy bytes from source to destination. Source and destination may overlap.
+	/// Overlapping copies with the destination above the source are done backward, with the same word bursts as memcpy8. Don't use for VRAM.
+	/// @param destination Copy destination.
+	/// @param source Copy source.
+	/// @param nrOfBytes Number of bytes to copy.
+	extern "C" void memmove8(void *destination, const void *source, uint32_t nrOfBytes) IWRAM_FUNC;
+
 } // namespace Memory
 
 #ifndef TARGET_PC
@@ -0,0 +1,79 @@
+// #define DEBUG_OVERLAY
+#include "overlay.h"
+
+#include "memory.h"
+
+#ifdef DEBUG_OVERLAY
+#include "print/output.h"
+#endif
+
+// IWRAM overlay region and overlay load addresses in ROM from the devkitARM linker script
+extern uint32_t __iwram_overlay_start;
+extern uint32_t __load_start_iwram0, __load_stop_iwram0;
+extern uint32_t __load_start_iwram1, __load_stop_iwram1;
+extern uint32_t __load_start_iwram2, __load_stop_iwram2;
+extern uint32_t __load_start_iwram3, __load_stop_iwram3;
+extern uint32_t __load_start_iwram4, __load_stop_iwram4;
+extern uint32_t __load_start_iwram5, __load_stop_iwram5;
+extern uint32_t __load_start_iwram6, __load_stop_iwram6;
+extern uint32_t __load_start_iwram7, __load_stop_iwram7;
+extern uint32_t __load_start_iwram8, __load_stop_iwram8;
+extern uint32_t __load_start_iwram9, __load_stop_iwram9;
+
+namespace Memory
+{
+
+	struct OverlayRange
+	{
+		const uint32_t *start;
+		const uint32_t *stop;
+	};
+
+	const OverlayRange m_overlays[NrOfOverlays] = {
+		{&__load_start_iwram0, &__load_stop_iwram0},
+		{&__load_start_iwram1, &__load_stop_iwram1},
+		{&__load_start_iwram2, &__load_stop_iwram2},
+		{&__load_start_iwram3, &__load_stop_iwram3},
+		{&__load_start_iwram4, &__load_stop_iwram4},
+		{&__load_start_iwram5, &__load_stop_iwram5},
+		{&__load_start_iwram6, &__load_stop_iwram6},
+		{&__load_start_iwram7, &__load_stop_iwram7},
+		{&__load_start_iwram8, &__load_stop_iwram8},
+		{&__load_start_iwram9, &__load_stop_iwram9}};
+
+	IWRAM_DATA int32_t m_currentOverlay = NoOverlay;
+
+	void loadOverlay(int32_t overlayNr)
+	{
+		if (overlayNr < 0 || overlayNr >= static_cast<int32_t>(NrOfOverlays) || overlayNr == m_currentOverlay)
+		{
+			return;
+		}
+		const auto &overlay = m_overlays[overlayNr];
+		// overlay sections are 4-byte aligned in the linker script
+		const uint32_t nrOfWords = overlay.stop - overlay.start;
+#ifdef DEBUG_OVERLAY
+		Debug::printf("Loading overlay %d, %d bytes", overlayNr, nrOfWords * 4);
+#endif
+		if (nrOfWords > 0)
+		{
+			memcpy32(&__iwram_overlay_start, overlay.start, nrOfWords);
+		}
+		m_currentOverlay = overlayNr;
+	}
+
+	int32_t currentOverlay()
+	{
+		return m_currentOverlay;
+	}
+
+	uint32_t overlaySize(int32_t overlayNr)
+	{
+		if (overlayNr < 0 || overlayNr >= static_cast<int32_t>(NrOfOverlays))
+		{
+			return 0;
+		}
+		return (m_overlays[overlayNr].stop - m_overlays[overlayNr].start) * 4;
+	}
+
+} // namespace Memory
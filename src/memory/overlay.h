@@ -0,0 +1,28 @@
+#pragma once
+
+#include "sys/base.h"
+
+#include <cstdint>
+
+namespace Memory
+{
+	/// @brief Number of IWRAM overlays the linker script provides (.iwram0 - .iwram9).
+	constexpr uint32_t NrOfOverlays = 10;
+
+	/// @brief Value for "no overlay loaded".
+	constexpr int32_t NoOverlay = -1;
+
+	/// @brief Copy code of IWRAM overlay from ROM to the shared IWRAM overlay region.
+	/// Functions of the previously loaded overlay must not be called anymore after this.
+	/// Put functions into an overlay with IWRAM_OVERLAY_FUNC(nr) or gba_iwram_overlay() in CMake.
+	/// Loading the overlay that is already loaded does nothing.
+	/// @param overlayNr Overlay number [0,9]. NoOverlay is ignored.
+	void loadOverlay(int32_t overlayNr);
+
+	/// @brief Get number of overlay currently loaded or NoOverlay.
+	int32_t currentOverlay();
+
+	/// @brief Get size of overlay code in bytes.
+	uint32_t overlaySize(int32_t overlayNr);
+
+} // namespace Memory
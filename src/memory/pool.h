@@ -0,0 +1,97 @@
+#pragma once
+
+#include "sys/base.h"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace Memory
+{
+	/// @brief Fixed-size object pool with O(1) acquire() and release() from an intrusive free list.
+	/// Objects have no per-allocation header and the pool can never fragment.
+	/// All storage is inside the pool object, so place the pool where you want the objects to live:
+	///
+	/// Memory::Pool<Particle, 128> particles IWRAM_BSS;
+	/// Memory::Pool<Keyframe, 64> keyframes EWRAM_BSS;
+	///
+	/// A zero-initialized pool is valid and empty, so no constructor needs to run at startup.
+	/// Objects are not constructed or destroyed, thus T must be trivially destructible.
+	template <typename T, uint32_t N>
+	class Pool
+	{
+		static_assert(N > 0, "Pool must have at least one object");
+		static_assert(std::is_trivially_destructible<T>::value, "Pool objects must be trivially destructible");
+
+	public:
+		/// @brief Number of objects in pool.
+		static constexpr uint32_t Capacity = N;
+
+		/// @brief Get an object from the pool. The object memory is not initialized.
+		/// @return Returns a 4-byte aligned pointer to the object or nullptr if the pool is empty.
+		T *acquire()
+		{
+			Slot *slot = m_freeList;
+			if (slot != nullptr)
+			{
+				m_freeList = slot->next;
+			}
+			else if (m_nrOfTouched < N)
+			{
+				// free list is empty, but slots at the end of the pool have never been used yet
+				slot = &m_slots[m_nrOfTouched++];
+			}
+			else
+			{
+				return nullptr;
+			}
+			m_nrOfUsed++;
+			return reinterpret_cast<T *>(slot->data);
+		}
+
+		/// @brief Return an object to the pool. Passing nullptr is ignored.
+		/// @note The object must have been acquired from this pool and must not be released twice.
+		void release(T *object)
+		{
+			if (object != nullptr)
+			{
+				Slot *slot = reinterpret_cast<Slot *>(object);
+				slot->next = m_freeList;
+				m_freeList = slot;
+				m_nrOfUsed--;
+			}
+		}
+
+		/// @brief Return all objects to the pool at once.
+		void clear()
+		{
+			m_freeList = nullptr;
+			m_nrOfTouched = 0;
+			m_nrOfUsed = 0;
+		}
+
+		/// @brief Check if the object lies inside the memory of this pool.
+		bool contains(const T *object) const
+		{
+			return reinterpret_cast<const uint8_t *>(object) >= reinterpret_cast<const uint8_t *>(m_slots) && reinterpret_cast<const uint8_t *>(object) < reinterpret_cast<const uint8_t *>(m_slots + N);
+		}
+
+		/// @brief Number of objects currently acquired.
+		uint32_t used() const { return m_nrOfUsed; }
+
+		/// @brief Number of objects that can still be acquired.
+		uint32_t available() const { return N - m_nrOfUsed; }
+
+	private:
+		union Slot
+		{
+			Slot *next; // next free slot if slot is in free list
+			uint8_t data[sizeof(T)] __attribute__((aligned(alignof(T) > 4 ? alignof(T) : 4)));
+		};
+
+		Slot m_slots[N] = {};
+		Slot *m_freeList = nullptr; // slots that have been released
+		uint32_t m_nrOfTouched = 0; // slots [0, m_nrOfTouched) have been used at least once
+		uint32_t m_nrOfUsed = 0;	// number of objects currently acquired
+	};
+
+} // namespace Memory
@@ -0,0 +1,256 @@
+#include "movie.h"
+
+#include "compression/lz4stream.h"
+#include "sys/base.h"
+
+#ifndef TARGET_PC
+#include "graphics.h"
+#include "memory/memory.h"
+#include "palette.h"
+#include "sys/video.h"
+#endif
+
+namespace Movie
+{
+
+    // Copy block row by row with 32-bit reads and writes. Strides are in words
+    template <uint32_t WordsPerRow>
+    FORCEINLINE void copyBlock(uint32_t *dst, const uint32_t *src, uint32_t nrOfRows, uint32_t dstStride, uint32_t srcStride)
+    {
+        do
+        {
+            for (uint32_t i = 0; i < WordsPerRow; ++i)
+            {
+                dst[i] = src[i];
+            }
+            dst += dstStride;
+            src += srcStride;
+        } while (--nrOfRows > 0);
+    }
+
+    FORCEINLINE void copyBlock(uint32_t *dst, const uint32_t *src, uint32_t wordsPerRow, uint32_t nrOfRows, uint32_t dstStride, uint32_t srcStride)
+    {
+        switch (wordsPerRow)
+        {
+        case 1:
+            copyBlock<1>(dst, src, nrOfRows, dstStride, srcStride);
+            break;
+        case 2:
+            copyBlock<2>(dst, src, nrOfRows, dstStride, srcStride);
+            break;
+        default:
+            copyBlock<4>(dst, src, nrOfRows, dstStride, srcStride);
+            break;
+        }
+    }
+
+    IWRAM_FUNC const FrameHeader *decodeFrame(const MovieHeader *movie, const FrameHeader *frame, uint32_t *dst, const uint32_t *previous, uint32_t *literalBuffer)
+    {
+        const uint32_t blockSize = movie->blockSize;
+        const uint32_t stride = movie->width * movie->bytesPerPixel / 4;
+        const uint32_t wordsPerRow = blockSize * movie->bytesPerPixel / 4;
+        const uint32_t blockWords = blockSize * wordsPerRow;
+        const uint32_t nrOfBlocks = (movie->width / blockSize) * (movie->height / blockSize);
+        // block types, motion vectors and literal data follow the frame header
+        auto types = reinterpret_cast<const uint32_t *>(frame + 1);
+        auto motion = reinterpret_cast<const int8_t *>(types + (nrOfBlocks + 15) / 16);
+        auto literalData = reinterpret_cast<const uint32_t *>(motion + ((frame->nrOfCopyBlocks * 2 + 3) & ~3));
+        Compression::LZ4StreamState literalState;
+        if (frame->nrOfLiteralBlocks > 0)
+        {
+            Compression::LZ4StreamInit(literalState, literalData, literalBuffer);
+        }
+        // literal data is decoded alternately into both halves of the literal buffer. the encoder limits the match
+        // distance, so matches never reach before the other half
+        const uint32_t *literal = nullptr;
+        uint32_t literalWordsLeft = 0;
+        uint32_t literalHalf = 0;
+        uint32_t literalPreviousSize = 0;
+        uint32_t typeBits = 0;
+        uint32_t block = 0;
+        for (uint32_t y = 0; y < movie->height; y += blockSize)
+        {
+            uint32_t *dstRow = dst + y * stride;
+            for (uint32_t x = 0; x < movie->width; x += blockSize, ++block)
+            {
+                if ((block & 15) == 0)
+                {
+                    typeBits = *types++;
+                }
+                const auto type = static_cast<BlockType>(typeBits & 3);
+                typeBits >>= 2;
+                if (type == BlockType::Copy)
+                {
+                    const int32_t dx = motion[0];
+                    const int32_t dy = motion[1];
+                    motion += 2;
+                    auto src = previous + ((int32_t(y) + dy) * int32_t(stride)) + (int32_t(x) + dx) * int32_t(movie->bytesPerPixel) / 4;
+                    copyBlock(dstRow + x * movie->bytesPerPixel / 4, src, wordsPerRow, blockSize, stride, stride);
+                }
+                else if (type == BlockType::Literal)
+                {
+                    if (literalWordsLeft == 0)
+                    {
+                        auto window = literalBuffer + literalHalf * (LiteralBufferSize / 4);
+                        auto previousWindow = literalBuffer + (literalHalf ^ 1) * (LiteralBufferSize / 4);
+                        Compression::LZ4StreamSetWindow(literalState, window, previousWindow, literalPreviousSize, nullptr);
+                        literalWordsLeft = Compression::LZ4StreamDecode(literalState, LiteralBufferSize) / 4;
+                        literal = window;
+                        literalHalf ^= 1;
+                        literalPreviousSize = LiteralBufferSize;
+                    }
+                    copyBlock(dstRow + x * movie->bytesPerPixel / 4, literal, wordsPerRow, blockSize, stride, wordsPerRow);
+                    literal += blockWords;
+                    literalWordsLeft -= blockWords;
+                }
+            }
+        }
+        return reinterpret_cast<const FrameHeader *>(reinterpret_cast<const uint8_t *>(frame) + frame->size);
+    }
+
+#ifndef TARGET_PC
+
+    constexpr uint32_t RefreshRate = 60;         // Screen refreshes per second, rounded
+    constexpr uint32_t ScanlinesPerRefresh = 228; // Scanlines per screen refresh including Vblank
+    constexpr uint32_t CyclesPerScanline = 1232;  // CPU cycles per scanline
+
+    IWRAM_DATA const MovieHeader *m_movie = nullptr;
+    IWRAM_DATA const FrameHeader *m_frame = nullptr; // Next frame to decode
+    IWRAM_DATA uint32_t m_nextFrame = 0;             // Number of next frame to decode
+    IWRAM_DATA uint32_t *m_literalBuffer = nullptr;  // LZ4 literal buffer in IWRAM
+    IWRAM_DATA bool m_loop = false;
+    IWRAM_DATA uint32_t m_vblanksPerFrame = 1; // Screen refreshes a frame is shown
+    IWRAM_DATA uint32_t m_dueVblank = 0;       // Vblank count the next frame is due at
+    IWRAM_DATA volatile uint32_t m_vblanks = 0;
+    IWRAM_DATA Stats m_stats = {0, 0, 0, 0};
+
+    IWRAM_FUNC void countVblank()
+    {
+        m_vblanks = m_vblanks + 1;
+    }
+
+    // Scanlines since play(). Measures decoding cost without using a timer, so movies can play along with sound
+    uint32_t scanlineCounter()
+    {
+        uint32_t vblanks = 0;
+        uint32_t line = 0;
+        do
+        {
+            vblanks = m_vblanks;
+            line = REG_VCOUNT;
+        } while (vblanks != m_vblanks);
+        // the vblank interrupt fires at the start of line 160
+        return vblanks * ScanlinesPerRefresh + (line + ScanlinesPerRefresh - 160) % ScanlinesPerRefresh;
+    }
+
+    bool play(const void *movie, bool loop)
+    {
+        stop();
+        auto header = reinterpret_cast<const MovieHeader *>(movie);
+        const uint32_t nrOfBuffers = Graphics::frontBuffer() == Graphics::backBuffer() ? 1 : 2;
+        if (header == nullptr || header->magic != MovieMagic || header->nrOfFrames == 0 ||
+            header->width != Graphics::width() || header->height != Graphics::height() ||
+            header->bytesPerPixel != Graphics::bytesPerPixel() || header->nrOfBuffers != nrOfBuffers ||
+            (header->blockSize != 4 && header->blockSize != 8) ||
+            (header->width % header->blockSize) != 0 || (header->height % header->blockSize) != 0 ||
+            header->framesPerSecond == 0 || header->framesPerSecond > RefreshRate)
+        {
+            return false;
+        }
+        m_literalBuffer = Memory::malloc_IWRAM<uint32_t>(2 * LiteralBufferSize / 4);
+        if (m_literalBuffer == nullptr)
+        {
+            return false;
+        }
+        // present() paces frames with the vblank count, so playing without it would hang
+        if (!Graphics::callAtVblank(countVblank))
+        {
+            Memory::free(m_literalBuffer);
+            m_literalBuffer = nullptr;
+            return false;
+        }
+        if (header->nrOfColors > 0)
+        {
+            Memory::memcpy16(Palette::Background, header + 1, header->nrOfColors);
+        }
+        m_movie = header;
+        m_frame = firstFrame(header);
+        m_nextFrame = 0;
+        m_loop = loop;
+        m_vblanksPerFrame = (RefreshRate + header->framesPerSecond / 2) / header->framesPerSecond;
+        m_vblanks = 0;
+        m_dueVblank = 0;
+        m_stats = {0, 0, 0, 0};
+        return true;
+    }
+
+    IWRAM_FUNC bool decodeNextFrame()
+    {
+        if (m_movie == nullptr)
+        {
+            return false;
+        }
+        if (m_nextFrame >= m_movie->nrOfFrames)
+        {
+            if (!m_loop)
+            {
+                return false;
+            }
+            // frames never depend on pixels from before the first frame, so looping needs no clearing
+            m_frame = firstFrame(m_movie);
+            m_nextFrame = 0;
+        }
+        const uint32_t start = scanlineCounter();
+        m_frame = decodeFrame(m_movie, m_frame, reinterpret_cast<uint32_t *>(Graphics::backBuffer()), reinterpret_cast<const uint32_t *>(Graphics::frontBuffer()), m_literalBuffer);
+        m_nextFrame++;
+        const uint32_t cycles = (scanlineCounter() - start) * CyclesPerScanline;
+        m_stats.nrOfFrames++;
+        m_stats.lastCycles = cycles;
+        m_stats.maxCycles = cycles > m_stats.maxCycles ? cycles : m_stats.maxCycles;
+        return true;
+    }
+
+    void present()
+    {
+        if (m_movie == nullptr)
+        {
+            return;
+        }
+        if (m_stats.nrOfFrames > 1 && m_vblanks > m_dueVblank)
+        {
+            m_stats.droppedFrames++;
+        }
+        while (m_vblanks < m_dueVblank)
+        {
+        }
+        Graphics::swap(true);
+        // late frames shift the schedule instead of making later frames hurry
+        const uint32_t now = m_vblanks;
+        m_dueVblank = (now > m_dueVblank ? now : m_dueVblank) + m_vblanksPerFrame;
+    }
+
+    void stop()
+    {
+        if (m_movie == nullptr)
+        {
+            return;
+        }
+        Graphics::removeAtVblank(countVblank);
+        Memory::free(m_literalBuffer);
+        m_literalBuffer = nullptr;
+        m_movie = nullptr;
+    }
+
+    uint32_t currentFrame()
+    {
+        return m_nextFrame > 0 ? m_nextFrame - 1 : 0;
+    }
+
+    Stats getStats()
+    {
+        return m_stats;
+    }
+
+#endif
+
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+
+// Block-based delta video for mode 3, 4 and 5, packed at build time with tools/moviepack.
+// Every frame is split into square blocks that either keep the pixels in the back buffer, are copied from the previous
+// frame with a motion offset or are decompressed from LZ4 literal data. Frames are decoded straight from ROM into
+// Graphics::backBuffer() with 32-bit writes, so nothing is unpacked into EWRAM.
+//
+// Usage:
+//
+// Irq::init();
+// Graphics::setMode(MODE_4 | BG2_ON);
+// Graphics::vblankEnable();
+// Movie::play(intro_movie);
+// while (Movie::decodeNextFrame())
+// {
+//     Movie::present();
+// }
+// Movie::stop();
+namespace Movie
+{
+
+    /// @brief Movie magic "MOVI".
+    constexpr uint32_t MovieMagic = 0x49564F4D;
+
+    /// @brief Size of the IWRAM buffer LZ4 literal data is decoded into. The encoder limits the LZ4 match distance to this,
+    /// so matches never reach further back than the previous buffer.
+    constexpr uint32_t LiteralBufferSize = 2048;
+
+    /// @brief Maximum horizontal and vertical motion offset of copy blocks in pixels.
+    constexpr int32_t MaxMotion = 64;
+
+    /// @brief How a block of a frame is decoded. Stored with 2 bits per block.
+    enum class BlockType : uint8_t
+    {
+        Skip = 0,   // Pixels are already in the back buffer. That is the previous frame with one buffer and the frame before it with two buffers
+        Copy = 1,   // Copy pixels from the previous frame, offset by a motion vector
+        Literal = 2 // Copy next block of pixels from the LZ4 literal data
+    };
+
+    /// @brief Movie header. Followed by nrOfColors palette colors, padded to a multiple of 4 bytes, followed by nrOfFrames frames.
+    struct MovieHeader
+    {
+        uint32_t magic;          // MovieMagic
+        uint16_t width;          // Frame width in pixels. Must match the screen width of the graphics mode
+        uint16_t height;         // Frame height in pixels. Must match the screen height of the graphics mode
+        uint16_t nrOfFrames;     // Number of frames
+        uint16_t nrOfColors;     // Number of palette colors for 8-bit pixels. 0 for 16-bit pixels
+        uint8_t framesPerSecond; // Playback rate. Frames are shown for a whole number of 60 Hz screen refreshes
+        uint8_t bytesPerPixel;   // 1 for mode 4, 2 for mode 3 and 5
+        uint8_t blockSize;       // Block width and height in pixels. 4 or 8
+        uint8_t nrOfBuffers;     // Frame buffers the encoder assumed. 2 for mode 4 and 5, 1 for mode 3
+    } __attribute__((aligned(4), packed));
+
+    /// @brief Frame header. Followed by the block types with 2 bits per block, first block in the lowest bits, padded to a
+    /// multiple of 4 bytes, followed by the motion vectors of the copy blocks as int8_t dx, dy pairs, padded to a multiple
+    /// of 4 bytes, followed by LZ4 40h data with the pixels of all literal blocks, if there are any.
+    /// Motion vectors are in pixels. dx is a multiple of 4 / bytesPerPixel, so blocks can be copied with 32-bit reads.
+    struct FrameHeader
+    {
+        uint32_t size;              // Size of frame in bytes including this header. Multiple of 4
+        uint16_t nrOfCopyBlocks;    // Number of copy blocks and motion vectors
+        uint16_t nrOfLiteralBlocks; // Number of literal blocks in LZ4 data
+    } __attribute__((aligned(4), packed));
+
+    /// @brief Get first frame of movie.
+    inline const FrameHeader *firstFrame(const MovieHeader *movie)
+    {
+        auto palette = reinterpret_cast<const uint8_t *>(movie + 1);
+        return reinterpret_cast<const FrameHeader *>(palette + ((movie->nrOfColors * 2 + 3) & ~3));
+    }
+
+    /// @brief Decode frame into buffer.
+    /// @param movie Movie header.
+    /// @param frame Frame to decode.
+    /// @param dst Destination buffer of width * height pixels. Usually Graphics::backBuffer(). Must be 4-byte-aligned
+    /// @param previous Buffer holding the previous frame. Usually Graphics::frontBuffer(). Same as dst with one buffer
+    /// @param literalBuffer Scratch buffer of 2 * LiteralBufferSize bytes for LZ4 literal data. Should be in IWRAM
+    /// @return Returns the next frame.
+    const FrameHeader *decodeFrame(const MovieHeader *movie, const FrameHeader *frame, uint32_t *dst, const uint32_t *previous, uint32_t *literalBuffer);
+
+    /// @brief Decode cost statistics. Cycles are measured with scanline resolution, so no timer is needed.
+    struct Stats
+    {
+        uint32_t nrOfFrames;    // Number of frames decoded since play()
+        uint32_t lastCycles;    // CPU cycles needed for the last frame
+        uint32_t maxCycles;     // Maximum CPU cycles needed for a frame
+        uint32_t droppedFrames; // Number of frames presented later than their due time
+    } __attribute__((aligned(4), packed));
+
+    /// @brief Start playing movie. Sets the palette. Graphics::setMode() must have been called with a matching mode and
+    /// Vblank interrupts must be enabled with Graphics::vblankEnable() for frame pacing.
+    /// @param movie Movie in ROM starting with a MovieHeader. Must be 4-byte-aligned
+    /// @param loop If true the movie restarts at the first frame when it ends
+    /// @return Returns false if the movie header is invalid, does not match the graphics mode, there is not enough IWRAM or all
+    /// Graphics::callAtVblank() slots are in use.
+    bool play(const void *movie, bool loop = false);
+
+    /// @brief Decode the next frame into Graphics::backBuffer(). Call present() afterwards to show it.
+    /// @return Returns false if the movie has ended or is not playing.
+    bool decodeNextFrame();
+
+    /// @brief Wait until the frame decoded last is due, then show it with Graphics::swap().
+    void present();
+
+    /// @brief Stop playing and free the literal buffer.
+    void stop();
+
+    /// @brief Returns the number of the frame decoded last.
+    uint32_t currentFrame();
+
+    /// @brief Get decode cost statistics.
+    Stats getStats();
+
+}
@@ -0,0 +1,187 @@
+#include "palettebanks.h"
+
+#include "sys/base.h"
+
+namespace Palette
+{
+
+    struct BankTable
+    {
+        uint32_t data[NrOfBanks][8]; // Shadow copy of palette data. Stays valid after a bank is released
+        uint32_t hash[NrOfBanks];    // Hash of palette data
+        uint8_t refCount[NrOfBanks]; // Number of users. 0 if bank is free
+        uint16_t reserved;           // Bit n set if bank n is reserved for exclusive use
+        uint16_t dirty;              // Bit n set if bank n needs to be uploaded
+    } __attribute__((aligned(4), packed));
+
+    EWRAM_BSS BankTable m_banks[2];
+
+    inline BankTable &table(BankTarget target)
+    {
+        return m_banks[static_cast<uint32_t>(target)];
+    }
+
+    inline uint32_t *paletteMemory(BankTarget target, uint32_t bank)
+    {
+        return reinterpret_cast<uint32_t *>(target == BankTarget::Sprite ? Sprite16[bank] : Background16[bank]);
+    }
+
+    // FNV-1a over palette words
+    inline uint32_t hashPalette(const uint32_t *data)
+    {
+        uint32_t hash = 0x811C9DC5;
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            hash = (hash ^ data[i]) * 0x01000193;
+        }
+        return hash;
+    }
+
+    inline bool isEqual(const uint32_t *a, const uint32_t *b)
+    {
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            if (a[i] != b[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline void copyPalette(uint32_t *dst, const uint32_t *src)
+    {
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            dst[i] = src[i];
+        }
+    }
+
+    int32_t acquireBank(BankTarget target, const Palette16 &palette)
+    {
+        auto &banks = table(target);
+        const uint32_t *data = reinterpret_cast<const uint32_t *>(palette);
+        const uint32_t hash = hashPalette(data);
+        // check if a used, shared bank has the same data
+        int32_t freeBank = -1;
+        int32_t freeBankSameData = -1;
+        for (uint32_t i = 0; i < NrOfBanks; ++i)
+        {
+            const bool sameData = banks.hash[i] == hash && isEqual(banks.data[i], data);
+            if (banks.refCount[i] > 0)
+            {
+                if (sameData && (banks.reserved & (1 << i)) == 0 && banks.refCount[i] < 255)
+                {
+                    banks.refCount[i]++;
+                    return i;
+                }
+            }
+            else
+            {
+                freeBank = freeBank < 0 ? i : freeBank;
+                freeBankSameData = (freeBankSameData < 0 && sameData) ? i : freeBankSameData;
+            }
+        }
+        // prefer a free bank that still has the same data, so other free banks keep theirs. palette RAM might have
+        // been written directly since the bank was released, e.g. by a fade, so upload it again
+        if (freeBankSameData >= 0)
+        {
+            banks.refCount[freeBankSameData] = 1;
+            banks.dirty |= 1 << freeBankSameData;
+            return freeBankSameData;
+        }
+        if (freeBank >= 0)
+        {
+            copyPalette(banks.data[freeBank], data);
+            banks.hash[freeBank] = hash;
+            banks.refCount[freeBank] = 1;
+            banks.dirty |= 1 << freeBank;
+        }
+        return freeBank;
+    }
+
+    void releaseBank(BankTarget target, uint32_t bank)
+    {
+        auto &banks = table(target);
+        if (bank < NrOfBanks && banks.refCount[bank] > 0)
+        {
+            banks.refCount[bank]--;
+            if (banks.refCount[bank] == 0)
+            {
+                banks.reserved &= ~(1 << bank);
+            }
+        }
+    }
+
+    int32_t reserveBank(BankTarget target)
+    {
+        auto &banks = table(target);
+        for (uint32_t i = 0; i < NrOfBanks; ++i)
+        {
+            if (banks.refCount[i] == 0)
+            {
+                banks.refCount[i] = 1;
+                banks.reserved |= 1 << i;
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void updateBank(BankTarget target, uint32_t bank, const Palette16 &palette)
+    {
+        auto &banks = table(target);
+        if (bank < NrOfBanks)
+        {
+            const uint32_t *data = reinterpret_cast<const uint32_t *>(palette);
+            const uint32_t hash = hashPalette(data);
+            if (banks.hash[bank] != hash || !isEqual(banks.data[bank], data))
+            {
+                copyPalette(banks.data[bank], data);
+                banks.hash[bank] = hash;
+                banks.dirty |= 1 << bank;
+            }
+        }
+    }
+
+    void clearBanks()
+    {
+        // keep data and hashes. banks reacquired with the same data are uploaded again in acquireBank()
+        for (auto &banks : m_banks)
+        {
+            for (uint32_t i = 0; i < NrOfBanks; ++i)
+            {
+                banks.refCount[i] = 0;
+            }
+            banks.reserved = 0;
+        }
+    }
+
+    void uploadBanks()
+    {
+        for (uint32_t t = 0; t < 2; ++t)
+        {
+            auto &banks = m_banks[t];
+            uint32_t dirty = banks.dirty;
+            while (dirty != 0)
+            {
+                const uint32_t bank = __builtin_ctz(dirty);
+                copyPalette(paletteMemory(static_cast<BankTarget>(t), bank), banks.data[bank]);
+                dirty &= ~(1 << bank);
+            }
+            banks.dirty = 0;
+        }
+    }
+
+    uint32_t usedBanks(BankTarget target)
+    {
+        auto &banks = table(target);
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < NrOfBanks; ++i)
+        {
+            count += banks.refCount[i] > 0 ? 1 : 0;
+        }
+        return count;
+    }
+
+} // namespace Palette
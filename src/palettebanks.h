@@ -0,0 +1,51 @@
+#pragma once
+
+#include "palette.h"
+
+#include <cstdint>
+
+// Management of the 16 color palette banks in sprite and background palette memory.
+// Identical palettes share a bank and banks are reference counted, so effects get more free banks.
+// Palette data is kept in a shadow copy and only changed banks are written to palette RAM in uploadBanks().
+// Register uploadBanks() with Graphics::callAtVblank(Palette::uploadBanks) to upload changes every frame.
+namespace Palette
+{
+
+    /// @brief Palette memory the banks are in.
+    enum class BankTarget : uint8_t
+    {
+        Background = 0, // Palette::Background16
+        Sprite = 1      // Palette::Sprite16
+    };
+
+    /// @brief Number of 16 color banks per target.
+    constexpr uint32_t NrOfBanks = 16;
+
+    /// @brief Get a bank containing the palette. Reuses a bank with identical contents if possible.
+    /// A free bank reused this way is uploaded again, as palette RAM may have been written directly since it was released.
+    /// @param target Background or sprite palette memory.
+    /// @param palette 16 color palette data.
+    /// @return Returns the bank index, e.g. for Sprite2D::paletteIndex, or -1 if all banks are in use.
+    int32_t acquireBank(BankTarget target, const Palette16 &palette);
+
+    /// @brief Release a bank acquired with acquireBank() or reserveBank(). The bank will be free when all users have released it.
+    void releaseBank(BankTarget target, uint32_t bank);
+
+    /// @brief Reserve a bank for exclusive use, e.g. for palette effects. The bank will not be shared.
+    /// @return Returns the bank index or -1 if all banks are in use.
+    int32_t reserveBank(BankTarget target);
+
+    /// @brief Change the contents of a bank. All users of the bank will see the change.
+    /// Only upload if the contents actually changed.
+    void updateBank(BankTarget target, uint32_t bank, const Palette16 &palette);
+
+    /// @brief Release all banks.
+    void clearBanks();
+
+    /// @brief Copy changed banks to palette memory. Call only in vblank.
+    void uploadBanks();
+
+    /// @brief Number of banks currently used for target.
+    uint32_t usedBanks(BankTarget target);
+
+} // namespace Palette
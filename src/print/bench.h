@@ -2,6 +2,7 @@
 
 #include <cstdint>
 
+#include <sys/interrupts.h>
 #include <sys/timers.h>
 
 namespace Debug
@@ -39,6 +40,44 @@ namespace Debug
         return REG_TM2CNT_L;
     }
 
+    /// @brief Start a cycle counter for benchmarking routines with cycle resolution (< 256s).
+    /// Runs on Timer #1 cascaded into Timer #2, so do not use at the same time as startTimer().
+    inline void startCycles()
+    {
+        REG_TM1CNT_H = 0;
+        REG_TM2CNT_H = 0;
+        REG_TM1CNT_L = 0;
+        REG_TM2CNT_L = 0;
+        REG_TM2CNT_H = TIMER_START | TIMER_COUNT;
+        REG_TM1CNT_H = TIMER_START;
+    }
+
+    /// @brief Stop cycle counter and return number of cycles since startCycles().
+    /// Runs on Timer #1 cascaded into Timer #2.
+    inline uint32_t endCycles()
+    {
+        REG_TM1CNT_H = 0;
+        const uint32_t cycles = (static_cast<uint32_t>(REG_TM2CNT_L) << 16) | REG_TM1CNT_L;
+        REG_TM2CNT_H = 0;
+        return cycles;
+    }
+
+    /// @brief Measure the cycles a function takes with startCycles() / endCycles().
+    /// Interrupts are disabled during the measurement, so results are reproducible.
+    /// @param function Function to measure, e.g. a lambda
+    /// @param overhead Cycles to subtract from the result. Pass measureCycles([]() {}) to remove the cost of the measurement itself
+    template <typename F>
+    uint32_t measureCycles(F function, uint32_t overhead = 0)
+    {
+        const uint16_t ime = Irq::RegIme;
+        Irq::RegIme = 0;
+        startCycles();
+        function();
+        const uint32_t cycles = endCycles();
+        Irq::RegIme = ime;
+        return cycles > overhead ? cycles - overhead : 0;
+    }
+
 } // namespace Time
 
 /// @brief Start timing of a section
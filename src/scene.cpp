@@ -1,5 +1,6 @@
 #include "scene.h"
 #include "time.h"
+#include "memory/overlay.h"
 #include "sound/sound.h"
 
 // #define DEBUG_SCENE
@@ -53,6 +54,8 @@ namespace Scene
             sceneData.startTime = startTime;
             sceneData.duration = entry.duration;
             sceneData.t = 0;
+            // copy scene code to IWRAM
+            Memory::loadOverlay(entry.iwramOverlay);
             // set up scene
             if (entry.setup != nullptr)
             {
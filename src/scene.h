@@ -33,6 +33,7 @@ namespace Scene
         void (*setup)(const Data &);           /// Initialize all your data / gfx etc. here when the scene starts.
         void (*loop)(const Data &);            /// Will called repeatedly until endTime has been reached.
         void (*cleanup)(const Data &);         /// Clean up all your data / gfx etc. here when the scene ends.
+        int32_t iwramOverlay = -1;             /// IWRAM code overlay loaded before setup() is called. -1 means nothing is done.
     } __attribute__((aligned(4), packed));
 
     /// @brief Starts play a sequence of scenes.
@@ -0,0 +1,288 @@
+#include "sound/adpcmplayer.h"
+
+#include "compression/adpcm.h"
+#include "compression/adpcm_structs.h"
+#include "memory/dma.h"
+#include "memory/memory.h"
+#include "sys/interrupts.h"
+#include "sys/sound.h"
+#include "sys/timers.h"
+
+namespace AdpcmPlayer
+{
+    constexpr uint32_t CpuFrequency = 16777216;      // CPU cycles per second
+    constexpr uint32_t FifoSize = 32;                // Size of a DirectSound FIFO in bytes
+    constexpr uint16_t SoundMasterEnable = BIT(7);   // REG_SOUNDCNT_X sound master enable
+    constexpr uint16_t DirectSoundMask = 0xFF0C;     // REG_SOUNDCNT_H DirectSound A / B bits
+    constexpr uint16_t FifoDmaControl = DMA_DST_FIXED | DMA_SRC_INC | DMA_REPEAT | DMA32 | DMA_SPECIAL | DMA_ENABLE;
+
+    IWRAM_DATA const StreamHeader *m_stream = nullptr;
+    IWRAM_DATA const uint8_t *m_frames = nullptr; // First ADPCM frame in ROM
+    IWRAM_DATA int8_t *m_buffer = nullptr;        // PCM buffers in IWRAM. Per channel two consecutive halves of samplesPerFrame samples
+    IWRAM_DATA uint32_t m_halfSize = 0;           // Size of one buffer half of one channel in bytes
+    IWRAM_DATA uint32_t m_nextFrame = 0;          // Next frame to decode
+    IWRAM_DATA uint32_t m_playHalf = 0;           // Buffer half currently played
+    IWRAM_DATA bool m_silent[2] = {false, false}; // True if buffer half was filled with silence after the end of the stream
+    IWRAM_DATA bool m_loop = false;
+    IWRAM_DATA uint16_t m_soundControl = 0;     // REG_SOUNDCNT_H DirectSound bits
+    IWRAM_DATA uint32_t m_cyclesPerSample = 0;  // Timer 0 period
+    IWRAM_DATA uint32_t m_samplesReload = 0;    // Timer 1 reload value
+    IWRAM_DATA volatile bool m_playing = false; // Cleared by the interrupt handler when the stream ended
+    IWRAM_DATA volatile uint32_t m_playedFrames = 0;
+    IWRAM_DATA Stats m_stats = {0, 0, 0, 0, 0};
+    IWRAM_DATA uint64_t m_totalCycles = 0;
+
+    // Cycles since the last buffer switch, derived from the sample clock timers. Only valid while timer 0 runs
+    IWRAM_FUNC uint32_t sampleClockCycles()
+    {
+        uint32_t samples = REG_TM1CNT_L;
+        uint32_t ticks = REG_TM0CNT_L;
+        // timer 0 might have overflown between reads
+        if (REG_TM1CNT_L != samples)
+        {
+            samples = REG_TM1CNT_L;
+            ticks = REG_TM0CNT_L;
+        }
+        return (samples - m_samplesReload) * m_cyclesPerSample + (ticks - (0x10000 - m_cyclesPerSample));
+    }
+
+    // Decode the next frame into buffer half or fill it with silence if the stream has ended
+    IWRAM_FUNC void fillHalf(uint32_t half)
+    {
+        auto pcm = m_buffer + half * m_halfSize;
+        auto pcmRight = pcm + 2 * m_halfSize;
+        if (m_nextFrame >= m_stream->nrOfFrames && m_loop)
+        {
+            m_nextFrame = 0;
+        }
+        if (m_nextFrame < m_stream->nrOfFrames)
+        {
+            auto frame = reinterpret_cast<const uint32_t *>(m_frames + m_nextFrame * m_stream->frameSize);
+            if (m_stream->nrOfChannels == 2)
+            {
+                Adpcm_UnCompWriteStereo32bit_8bit(frame, m_stream->frameSize, reinterpret_cast<uint32_t *>(pcm), reinterpret_cast<uint32_t *>(pcmRight));
+            }
+            else
+            {
+                Adpcm_UnCompWrite32bit_8bit(frame, m_stream->frameSize, reinterpret_cast<uint32_t *>(pcm));
+            }
+            m_nextFrame++;
+            m_silent[half] = false;
+        }
+        else
+        {
+            Memory::memset32(pcm, 0, m_halfSize / 4);
+            if (m_stream->nrOfChannels == 2)
+            {
+                Memory::memset32(pcmRight, 0, m_halfSize / 4);
+            }
+            m_silent[half] = true;
+        }
+    }
+
+    // Point FIFO DMAs to the start of buffer half
+    IWRAM_FUNC void startDma(uint32_t half)
+    {
+        // the DMAs read up to a FIFO size ahead, which is past the buffer end after the second half. drop that and prefill
+        // the FIFOs with the start of the half, so playback continues at the right sample without a gap
+        auto pcm = reinterpret_cast<const uint32_t *>(m_buffer + half * m_halfSize);
+        REG_DMA[1].control = 0;
+        REG_DMA[2].control = 0;
+        REG_SOUNDCNT_H = (REG_SOUNDCNT_H & ~DirectSoundMask) | m_soundControl | SNDA_RESET_FIFO | SNDB_RESET_FIFO;
+        for (uint32_t channel = 0; channel < m_stream->nrOfChannels; ++channel)
+        {
+            volatile uint32_t *fifo = channel == 0 ? &REG_FIFO_A : &REG_FIFO_B;
+            for (uint32_t i = 0; i < FifoSize / 4; ++i)
+            {
+                *fifo = pcm[i];
+            }
+            REG_DMA[1 + channel].source = reinterpret_cast<uint32_t>(pcm + FifoSize / 4);
+            REG_DMA[1 + channel].destination = reinterpret_cast<uint32_t>(fifo);
+            REG_DMA[1 + channel].count = 4;
+            REG_DMA[1 + channel].control = FifoDmaControl;
+            pcm += 2 * m_halfSize / 4;
+        }
+    }
+
+    // Stop timers, DMAs and DirectSound output. No more timer 1 interrupts happen after this
+    IWRAM_FUNC void stopOutput()
+    {
+        REG_TM0CNT_H = 0;
+        REG_TM1CNT_H = 0;
+        REG_DMA[1].control = 0;
+        REG_DMA[2].control = 0;
+        REG_SOUNDCNT_H = (REG_SOUNDCNT_H & ~DirectSoundMask) | SNDA_RESET_FIFO | SNDB_RESET_FIFO;
+        m_playing = false;
+    }
+
+    // Reserve the FIFO DMA channels. Both are used for mono too, so startDma() and stopOutput() never touch a channel
+    // someone else owns
+    bool reserveDma()
+    {
+        if (!DMA::reserveChannel(1))
+        {
+            return false;
+        }
+        if (!DMA::reserveChannel(2))
+        {
+            DMA::releaseChannel(1);
+            return false;
+        }
+        return true;
+    }
+
+    void releaseDma()
+    {
+        DMA::releaseChannel(1);
+        DMA::releaseChannel(2);
+    }
+
+    // Timer 1 interrupt. Called when a buffer half has been played
+    IWRAM_FUNC void onHalfPlayed()
+    {
+        const uint32_t start = sampleClockCycles();
+        m_playedFrames = m_playedFrames + 1;
+        m_playHalf ^= 1;
+        if (m_silent[m_playHalf])
+        {
+            stopOutput();
+            return;
+        }
+        startDma(m_playHalf);
+        fillHalf(m_playHalf ^ 1);
+        const uint32_t cycles = sampleClockCycles() - start;
+        m_stats.nrOfFrames++;
+        m_stats.lastCycles = cycles;
+        m_stats.maxCycles = cycles > m_stats.maxCycles ? cycles : m_stats.maxCycles;
+        m_totalCycles += cycles;
+    }
+
+    bool play(const void *stream, bool loop)
+    {
+        stop();
+        auto header = reinterpret_cast<const StreamHeader *>(stream);
+        if (header == nullptr || header->magic != StreamMagic || header->nrOfFrames == 0 ||
+            header->nrOfChannels < 1 || header->nrOfChannels > 2 || (header->frameSize & 3) != 0 ||
+            header->samplesPerFrame < FifoSize || header->samplesPerFrame > MaxSamplesPerFrame || (header->samplesPerFrame & 15) != 0 ||
+            header->sampleRate <= (CpuFrequency >> 16) || header->sampleRate > CpuFrequency)
+        {
+            return false;
+        }
+        // a channel block of n bytes decodes to 2 * (n - 4) samples. anything else would make the decoders write past
+        // the end of a buffer half or leave stale samples in it
+        const uint32_t blockSize = header->frameSize > ADPCM_FRAMEHEADER_SIZE ? (header->frameSize - ADPCM_FRAMEHEADER_SIZE) / header->nrOfChannels : 0;
+        if (blockSize * header->nrOfChannels + ADPCM_FRAMEHEADER_SIZE != header->frameSize || blockSize <= 4 ||
+            header->samplesPerFrame != 2 * (blockSize - 4))
+        {
+            return false;
+        }
+        if (!reserveDma())
+        {
+            return false;
+        }
+        m_halfSize = header->samplesPerFrame;
+        m_buffer = static_cast<int8_t *>(Memory::malloc_IWRAM(header->nrOfChannels * 2 * m_halfSize));
+        if (m_buffer == nullptr)
+        {
+            releaseDma();
+            return false;
+        }
+        m_stream = header;
+        m_frames = reinterpret_cast<const uint8_t *>(header + 1);
+        m_loop = loop;
+        m_nextFrame = 0;
+        m_playHalf = 0;
+        m_playedFrames = 0;
+        m_cyclesPerSample = (CpuFrequency + header->sampleRate / 2) / header->sampleRate;
+        m_samplesReload = 0x10000 - header->samplesPerFrame;
+        fillHalf(0);
+        fillHalf(1);
+        resetStats();
+        // mono plays on FIFO A on both speakers, stereo plays left on FIFO A and right on FIFO B. both use timer 0
+        m_soundControl = header->nrOfChannels == 1 ? (SNDA_VOL_100 | SNDA_L_ENABLE | SNDA_R_ENABLE) : (SNDA_VOL_100 | SNDA_L_ENABLE | SNDB_VOL_100 | SNDB_R_ENABLE);
+        REG_SOUNDCNT_X = SoundMasterEnable;
+        startDma(0);
+        // timer 1 counts samples and fires when a buffer half has been played
+        REG_TM1CNT_L = m_samplesReload;
+        REG_TM1CNT_H = TIMER_START | TIMER_COUNT | TIMER_IRQ;
+        Irq::setHandler(Irq::Mask::Timer1, onHalfPlayed);
+        Irq::enable(Irq::Mask::Timer1);
+        m_playing = true;
+        // timer 0 is the sample clock
+        REG_TM0CNT_L = 0x10000 - m_cyclesPerSample;
+        REG_TM0CNT_H = TIMER_START;
+        return true;
+    }
+
+    void stop()
+    {
+        if (m_stream == nullptr)
+        {
+            return;
+        }
+        stopOutput();
+        Irq::disable(Irq::Mask::Timer1);
+        releaseDma();
+        Memory::free(m_buffer);
+        m_buffer = nullptr;
+        m_stream = nullptr;
+    }
+
+    void pause()
+    {
+        if (m_playing)
+        {
+            REG_TM0CNT_H = 0;
+        }
+    }
+
+    void resume()
+    {
+        if (m_playing)
+        {
+            REG_TM0CNT_H = TIMER_START;
+        }
+    }
+
+    bool isPlaying()
+    {
+        return m_playing;
+    }
+
+    uint32_t getPlayedSamples()
+    {
+        if (m_stream == nullptr)
+        {
+            return 0;
+        }
+        if (!m_playing)
+        {
+            return m_playedFrames * m_stream->samplesPerFrame;
+        }
+        uint32_t frames = 0;
+        uint32_t samples = 0;
+        do
+        {
+            frames = m_playedFrames;
+            samples = REG_TM1CNT_L - m_samplesReload;
+        } while (frames != m_playedFrames);
+        return frames * m_stream->samplesPerFrame + samples;
+    }
+
+    Stats getStats()
+    {
+        Stats stats = m_stats;
+        stats.averageCycles = stats.nrOfFrames > 0 ? static_cast<uint32_t>(m_totalCycles / stats.nrOfFrames) : 0;
+        stats.cyclesPerFrame = m_stream != nullptr ? m_stream->samplesPerFrame * m_cyclesPerSample : 0;
+        return stats;
+    }
+
+    void resetStats()
+    {
+        const uint16_t ime = Irq::RegIme;
+        Irq::RegIme = 0;
+        m_stats = {0, 0, 0, 0, 0};
+        m_totalCycles = 0;
+        Irq::RegIme = ime;
+    }
+}
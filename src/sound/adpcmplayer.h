@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+
+/// @brief Streaming DirectSound player for long ADPCM tracks in ROM, independent of MaxMod.
+/// ADPCM frames are decoded into double-buffered PCM buffers in IWRAM. DMA1 (left / mono) and DMA2 (right) feed
+/// the DirectSound FIFOs A / B in special mode, clocked by timer 0 at the sample rate. Timer 1 counts samples and
+/// raises an interrupt when a buffer has been played. The interrupt switches the DMAs to the other buffer and decodes
+/// the next frame into the buffer that just finished, so the CPU cost is one frame decode per buffer.
+///
+/// The player uses timer 0, timer 1, DMA1 and DMA2. It reserves the DMA channels with DMA::reserveChannel() while a
+/// stream is loaded, so play() fails if another module holds one of them. It can not run at the same time as MaxMod (Player::),
+/// Debug::startCycles() or Debug::startTimer(). Interrupts are disabled while the interrupt handler decodes a frame,
+/// so keep frames short enough for your other interrupts, e.g. one frame of video (~280000 cycles) or less.
+///
+/// Usage:
+///
+/// Irq::init();
+/// AdpcmPlayer::play(track_adpcm, true);
+/// ...
+/// auto stats = AdpcmPlayer::getStats(); // decode cost per frame
+namespace AdpcmPlayer
+{
+    /// @brief Stream magic "APCM".
+    constexpr uint32_t StreamMagic = 0x4D435041;
+
+    /// @brief Maximum number of samples per channel in a frame.
+    constexpr uint32_t MaxSamplesPerFrame = 2048;
+
+    /// @brief ADPCM stream header. Followed by nrOfFrames ADPCM frames of frameSize bytes each. Mono frames are decoded by
+    /// Adpcm_UnCompWrite32bit_8bit, stereo frames by Adpcm_UnCompWriteStereo32bit_8bit straight into the FIFO buffers.
+    /// All frames have the same size, because ADPCM has a fixed bit rate. The last frame should be padded with silence.
+    struct StreamHeader
+    {
+        uint32_t magic;           // StreamMagic
+        uint32_t sampleRate;      // Samples per second and channel
+        uint32_t nrOfFrames;      // Number of ADPCM frames following the header
+        uint16_t frameSize;       // Size of one ADPCM frame in bytes including the frame header. Multiple of 4. 4 + nrOfChannels * (4 + samplesPerFrame / 2)
+        uint16_t samplesPerFrame; // Samples per channel in a frame. Multiple of 16, 32 - MaxSamplesPerFrame
+        uint8_t nrOfChannels;     // 1 for mono, 2 for stereo. Must match the frame headers
+        uint8_t padding[3];
+    } __attribute__((aligned(4), packed));
+
+    /// @brief Decode cost statistics.
+    struct Stats
+    {
+        uint32_t nrOfFrames;     // Number of frames decoded since play() or resetStats()
+        uint32_t lastCycles;     // CPU cycles needed for the last frame, including buffer switch
+        uint32_t maxCycles;      // Maximum CPU cycles needed for a frame
+        uint32_t averageCycles;  // Average CPU cycles needed for a frame
+        uint32_t cyclesPerFrame; // CPU cycles it takes to play one frame. averageCycles / cyclesPerFrame is the CPU load
+    } __attribute__((aligned(4), packed));
+
+    /// @brief Start playing stream. Stops the current stream.
+    /// @param stream ADPCM stream in ROM starting with a StreamHeader. Must be 4-byte-aligned
+    /// @param loop If true the stream restarts at the first frame when it ends
+    /// @return Returns false if the stream header is invalid, DMA1 or DMA2 is reserved by someone else or there is not enough
+    /// IWRAM for the PCM buffers.
+    bool play(const void *stream, bool loop = false);
+
+    /// @brief Stop playing, free the PCM buffers and release DMA1 and DMA2.
+    void stop();
+
+    /// @brief Pause playback. Sound output stops until resume() is called.
+    void pause();
+
+    /// @brief Resume playback after pause().
+    void resume();
+
+    /// @brief Returns true if a stream is playing or paused and has not ended yet.
+    bool isPlaying();
+
+    /// @brief Get number of samples per channel played since play().
+    uint32_t getPlayedSamples();
+
+    /// @brief Get decode cost statistics.
+    Stats getStats();
+
+    /// @brief Reset decode cost statistics.
+    void resetStats();
+}
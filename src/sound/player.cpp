@@ -1,5 +1,6 @@
 #include "sound/player.h"
 #include "graphics.h"
+#include "memory/dma.h"
 #include "memory/memory.h"
 #include "sys/interrupts.h"
 
@@ -292,6 +293,8 @@ namespace Player
         system.mixing_memory = (mm_addr)m_mixingBuffer;
         system.wave_memory = (mm_addr)(m_maxmodBuffer + (PlayerModChannels * (MM_SIZEOF_MODCH + MM_SIZEOF_ACTCH + MM_SIZEOF_MIXCH)));
         system.soundbank = (mm_addr)soundbank;
+        // Maxmod feeds the DirectSound FIFO using DMA1, so scanline effects must not use it
+        DMA::reserveChannel(1);
         mmInit(&system);
         // Register our event handler to call if a song event occurrs
         mmSetEventHandler(eventHandler);
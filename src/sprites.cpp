@@ -1,5 +1,7 @@
 #include "sprites.h"
 
+#include "affineslots.h"
+#include "graphics.h"
 #include "memory/memory.h"
 #include "sys/video.h"
 #include "math/fp32.h"
@@ -33,6 +35,38 @@ namespace Sprites
         int16_t pd;
     } ALIGN(4) OBJAFFINE;
 
+    // Shadow copy of OAM. All OAM functions write here and uploadOAM() copies changes to OAM in vblank
+    IWRAM_BSS OBJATTR m_shadowOAM[128];
+    // Bit n set if shadow OAM entry n changed since the last upload
+    IWRAM_BSS uint32_t m_dirtyOAM[4];
+    // True if uploadOAM() has been registered with Graphics::callAtVblank()
+    IWRAM_BSS bool m_uploadRegistered;
+
+    // Make sure changes reach OAM. Called on every change, so existing callers need no explicit upload.
+    // If all vblank function slots are in use, registering is tried again on the next change
+    FORCEINLINE void registerUpload()
+    {
+        if (!m_uploadRegistered)
+        {
+            m_uploadRegistered = Graphics::callAtVblank(uploadOAM);
+        }
+    }
+
+    // Mark entries dirty. Call after the last write to the shadow entries. If uploadOAM() runs in between,
+    // it uploads the entries again in the next vblank instead of losing the later writes
+    FORCEINLINE void markDirty(uint32_t dirtyIndex, uint32_t dirtyBits)
+    {
+        // keep the compiler from moving the shadow OAM writes behind the dirty bits
+        asm volatile("" ::: "memory");
+        m_dirtyOAM[dirtyIndex & 3] |= dirtyBits;
+        registerUpload();
+    }
+
+    FORCEINLINE void markDirty(uint32_t index)
+    {
+        markDirty(index >> 5, 1 << (index & 31));
+    }
+
     uint16_t getSpriteScale(SizeCode size)
     {
         switch (size)
@@ -118,7 +152,7 @@ namespace Sprites
 
     void copyToOAM(const Sprite2D &sprite)
     {
-        auto &obj = reinterpret_cast<OBJATTR *>(OAM)[sprite.index];
+        auto &obj = m_shadowOAM[sprite.index & 127];
         obj.attr0 = OBJ_Y(sprite.y) | getSpriteScale(sprite.size);
         obj.attr0 |= (sprite.visible ? 0 : OBJ_DISABLE) | (sprite.mosaic ? OBJ_MOSAIC : 0) | (sprite.depth == ColorDepth::Depth256 ? ATTR0_COLOR_256 : ATTR0_COLOR_16);
         obj.attr0 |= (sprite.mode == Mode::Transparent ? OBJ_TRANSLUCENT : 0) | (sprite.mode == Mode::Window ? OBJ_OBJWINDOW : 0);
@@ -136,6 +170,7 @@ namespace Sprites
         obj.attr2 = (sprite.tileIndex & 1023);
         obj.attr2 |= ATTR2_PALETTE(sprite.depth == ColorDepth::Depth256 ? 0 : (sprite.paletteIndex & 15));
         obj.attr2 |= ATTR2_PRIORITY(static_cast<uint16_t>(sprite.priority));
+        markDirty(sprite.index);
     }
 
     void copyToOAM(const Sprite2D *sprites, uint32_t start, uint32_t count)
@@ -150,17 +185,27 @@ namespace Sprites
     {
         for (uint32_t i = 0; i < 128; i++)
         {
-            auto &obj = reinterpret_cast<OBJATTR *>(OAM)[i];
+            auto &obj = m_shadowOAM[i];
             obj.attr0 = OBJ_DISABLE;
             obj.attr1 = 0;
             obj.attr2 = 0;
             obj.dummy = 0;
         }
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            m_dirtyOAM[i] = ~0U;
+        }
+        // the matrices are zero now, so slot contents are invalid
+        clearAffineSlots();
+        // register again, in case the vblank functions have been cleared in the meantime
+        Graphics::removeAtVblank(uploadOAM);
+        m_uploadRegistered = false;
+        registerUpload();
     }
 
     void setVisibleOAM(uint16_t index, bool visible, bool affine)
     {
-        auto &obj = reinterpret_cast<OBJATTR *>(OAM)[index];
+        auto &obj = m_shadowOAM[index & 127];
         if (affine)
         {
             obj.attr0 = (obj.attr0 & 0b1111111011111111) | (visible ? OBJ_ROT_SCALE_ON : 0);
@@ -169,6 +214,7 @@ namespace Sprites
         {
             obj.attr0 = (obj.attr0 & 0b1111110111111111) | (visible ? 0 : OBJ_DISABLE);
         }
+        markDirty(index);
     }
 
     void setVisibleOAM(const Sprite2D &sprite)
@@ -182,9 +228,10 @@ namespace Sprites
         x = x < -64 ? 240 : x;
         y = y > 255 ? 255 : y;
         y = y < -64 ? 160 : y;
-        auto &obj = reinterpret_cast<OBJATTR *>(OAM)[index];
+        auto &obj = m_shadowOAM[index & 127];
         obj.attr0 = (obj.attr0 & 0b1111111100000000) | OBJ_Y(y);
         obj.attr1 = (obj.attr1 & 0b1111111000000000) | OBJ_X(x);
+        markDirty(index);
     }
 
     void setPositionOAM(const Sprite2D &sprite)
@@ -194,11 +241,13 @@ namespace Sprites
 
     void setMatrixOAM(uint8_t matrixIndex, const AffineData &matrix)
     {
-        auto &objAffine = reinterpret_cast<OBJAFFINE *>(OAM)[matrixIndex & 0x1F];
+        auto &objAffine = reinterpret_cast<OBJAFFINE *>(m_shadowOAM)[matrixIndex & 0x1F];
         objAffine.pa = matrix.dx;
         objAffine.pb = matrix.dmx;
         objAffine.pc = matrix.dy;
         objAffine.pd = matrix.dmy;
+        // the matrix is interleaved with the attributes of 4 consecutive entries
+        markDirty(matrixIndex >> 3, 0xF << ((matrixIndex & 7) * 4));
     }
 
     void setMatrixOAM(const Sprite2D &sprite)
@@ -206,6 +255,53 @@ namespace Sprites
         setMatrixOAM(sprite.matrixIndex, sprite.matrix);
     }
 
+    void uploadOAM()
+    {
+        // find the first and last changed entry and copy everything in between in one go.
+        // copying a few unchanged entries with ldm / stm bursts is cheaper than multiple copies
+        int32_t first = -1;
+        int32_t last = -1;
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            const uint32_t dirty = m_dirtyOAM[i];
+            if (dirty != 0)
+            {
+                first = first < 0 ? (i << 5) + __builtin_ctz(dirty) : first;
+                last = (i << 5) + 31 - __builtin_clz(dirty);
+                m_dirtyOAM[i] = 0;
+            }
+        }
+        // copy with the CPU. this runs in the vblank interrupt and using DMA3 would break a transfer the main loop is setting up
+        if (first >= 0)
+        {
+            Memory::memcpy32(reinterpret_cast<OBJATTR *>(OAM) + first, m_shadowOAM + first, (last - first + 1) * (sizeof(OBJATTR) / 4));
+        }
+    }
+
+    void uploadAllOAM()
+    {
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            m_dirtyOAM[i] = 0;
+        }
+        Memory::memcpy32(reinterpret_cast<void *>(OAM), m_shadowOAM, sizeof(m_shadowOAM) / 4);
+    }
+
+    bool isUploadRegistered()
+    {
+        return m_uploadRegistered;
+    }
+
+    uint32_t dirtyOAMEntries()
+    {
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            count += __builtin_popcount(m_dirtyOAM[i]);
+        }
+        return count;
+    }
+
     void copyTileData16(const Sprite2D *sprite, const uint32_t *tileData)
     {
         copyTileData16(sprite, tileData, 1);
@@ -146,28 +146,48 @@ namespace Sprites
     /// @brief Check if a sprite is visible inside bounds [0,right] horizontally and [0,bottom] vertically
     bool isInside(const Sprite2D &sprite, uint32_t right = 239, uint32_t bottom = 159);
 
-    /// @brief Set only the visible portion of the sprite to OAM. Call only in vblank.
+    // All OAM functions write to a shadow copy of OAM in IWRAM and can be called any time.
+    // The first change registers uploadOAM() with Graphics::callAtVblank(), so changes become visible in the next vblank
+    // as long as the vblank interrupt is enabled. If all vblank function slots are in use, every change tries again and
+    // isUploadRegistered() returns false until it worked. uploadOAM() or uploadAllOAM() can also be called manually in vblank.
+    // Call clearOAM() after Graphics::clearAtVblank() to register the upload again.
+
+    /// @brief Set only the visible portion of the sprite to OAM.
     void setVisibleOAM(const Sprite2D *sprite);
-    /// @brief Set only the visible portion of the sprite to OAM. Call only in vblank.
+    /// @brief Set only the visible portion of the sprite to OAM.
     void setVisibleOAM(uint16_t index, bool visible, bool affine = false);
 
-    /// @brief Set only the position portion of the sprite to OAM. Call only in vblank.
+    /// @brief Set only the position portion of the sprite to OAM.
     /// Clamps x and y to (-255, 511) resp. (-127, 255).
     void setPositionOAM(uint16_t index, int16_t x, int16_t y);
-    /// @brief Set only the position portion of the sprite to OAM. Call only in vblank.
+    /// @brief Set only the position portion of the sprite to OAM.
     void setPositionOAM(const Sprite2D &sprite);
 
-    /// @brief Set only the matrix portion of the sprite to OAM. Call only in vblank.
+    /// @brief Set only the matrix portion of the sprite to OAM.
     void setMatrixOAM(uint8_t matrixIndex, const AffineData &matrix);
-    /// @brief Set only the matrix portion of the sprite to OAM. Call only in vblank.
+    /// @brief Set only the matrix portion of the sprite to OAM.
     void setMatrixOAM(const Sprite2D &sprite);
 
-    /// @brief Copy sprite data to OAM. Call only in vblank.
+    /// @brief Copy sprite data to OAM.
     void copyToOAM(const Sprite2D &sprite);
-    /// @brief Copy sprite data to OAM. Call only in vblank.
+    /// @brief Copy sprite data to OAM.
     void copyToOAM(const Sprite2D *sprites, uint32_t start = 0, uint32_t count = 1);
 
-    /// @brief Clear all sprite data in OAM and disable all sprites. Call only in vblank.
+    /// @brief Clear all sprite data in OAM and disable all sprites. This also clears all matrices and affine slots, see clearAffineSlots().
     void clearOAM();
 
+    /// @brief Copy the range of changed OAM entries to OAM in one CPU copy. Call only in vblank.
+    /// Does not use DMA3, so it can't break a DMA3 transfer the interrupted code is setting up.
+    void uploadOAM();
+
+    /// @brief Copy the whole 1KB shadow OAM to OAM in one CPU copy. Call only in vblank.
+    /// Cheaper than uploadOAM() when most entries change every frame.
+    void uploadAllOAM();
+
+    /// @brief Returns true if uploadOAM() has been registered with Graphics::callAtVblank().
+    bool isUploadRegistered();
+
+    /// @brief Number of OAM entries changed since the last upload.
+    uint32_t dirtyOAMEntries();
+
 } // namespace Sprites
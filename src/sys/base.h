@@ -74,6 +74,14 @@
 #define EWRAM_DATA __attribute__((section(".ewram.data." SECTION_COUNTER)))
 #define EWRAM_BSS __attribute__((section(".sbss." SECTION_COUNTER)))
 
+/// @brief Put function into IWRAM overlay nr [0,9]. The code is stored in ROM and all overlays share the same IWRAM region.
+/// Load the overlay with Memory::loadOverlay(nr) before calling the function. Combine with ARM_CODE for speed.
+#define IWRAM_OVERLAY_FUNC(nr) __attribute__((section(".iwram" STRINGIFY(nr)))) NOINLINE
+/// @brief Put function into the IWRAM overlay of its source file, set by gba_iwram_overlay() in cmake/OverlaysGBA.cmake.
+#ifdef IWRAM_OVERLAY_NR
+#define IWRAM_OVERLAY_CODE IWRAM_OVERLAY_FUNC(IWRAM_OVERLAY_NR)
+#endif
+
 /// @brief Use for default 0 initialized static variables
 #define STATIC_BSS static EWRAM_BSS
 /// @brief Use for initialized static variables
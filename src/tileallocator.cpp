@@ -0,0 +1,200 @@
+#include "tileallocator.h"
+
+namespace Tiles
+{
+
+    void Allocator::init(uint32_t nrOfSlots)
+    {
+        m_nrOfSlots = nrOfSlots > MaxSlots ? MaxSlots : nrOfSlots;
+        for (uint32_t i = 0; i < MaxSlots / 32; ++i)
+        {
+            m_bitmap[i] = 0;
+        }
+    }
+
+    uint32_t Allocator::findUsed(uint32_t startSlot, uint32_t nrOfSlots) const
+    {
+        const uint32_t endSlot = startSlot + nrOfSlots;
+        uint32_t slot = startSlot;
+        while (slot < endSlot)
+        {
+            // check all bits of range in this word at once
+            const uint32_t bit = slot & 31;
+            const uint32_t bitsInWord = (endSlot - slot) < (32 - bit) ? (endSlot - slot) : (32 - bit);
+            const uint32_t mask = (bitsInWord == 32 ? ~0U : ((1U << bitsInWord) - 1)) << bit;
+            const uint32_t used = m_bitmap[slot >> 5] & mask;
+            if (used != 0)
+            {
+                return (slot & ~31U) + __builtin_ctz(used);
+            }
+            slot += bitsInWord;
+        }
+        return endSlot;
+    }
+
+    void Allocator::setRange(uint32_t startSlot, uint32_t nrOfSlots, bool used)
+    {
+        const uint32_t endSlot = startSlot + nrOfSlots;
+        uint32_t slot = startSlot;
+        while (slot < endSlot)
+        {
+            const uint32_t bit = slot & 31;
+            const uint32_t bitsInWord = (endSlot - slot) < (32 - bit) ? (endSlot - slot) : (32 - bit);
+            const uint32_t mask = (bitsInWord == 32 ? ~0U : ((1U << bitsInWord) - 1)) << bit;
+            m_bitmap[slot >> 5] = used ? (m_bitmap[slot >> 5] | mask) : (m_bitmap[slot >> 5] & ~mask);
+            slot += bitsInWord;
+        }
+    }
+
+    int32_t Allocator::allocate(uint32_t nrOfSlots, uint32_t alignment, uint32_t firstSlot, uint32_t endSlot)
+    {
+        endSlot = endSlot > m_nrOfSlots ? m_nrOfSlots : endSlot;
+        if (nrOfSlots == 0 || alignment == 0)
+        {
+            return -1;
+        }
+        // first fit: try aligned start slots and skip behind the first used slot found
+        uint32_t slot = (firstSlot + alignment - 1) & ~(alignment - 1);
+        while (slot + nrOfSlots <= endSlot)
+        {
+            const uint32_t used = findUsed(slot, nrOfSlots);
+            if (used == slot + nrOfSlots)
+            {
+                setRange(slot, nrOfSlots, true);
+                return slot;
+            }
+            slot = (used + alignment) & ~(alignment - 1);
+        }
+        return -1;
+    }
+
+    void Allocator::reserve(uint32_t startSlot, uint32_t nrOfSlots)
+    {
+        if (startSlot < m_nrOfSlots)
+        {
+            setRange(startSlot, startSlot + nrOfSlots > m_nrOfSlots ? m_nrOfSlots - startSlot : nrOfSlots, true);
+        }
+    }
+
+    void Allocator::free(uint32_t startSlot, uint32_t nrOfSlots)
+    {
+        if (startSlot < m_nrOfSlots)
+        {
+            setRange(startSlot, startSlot + nrOfSlots > m_nrOfSlots ? m_nrOfSlots - startSlot : nrOfSlots, false);
+        }
+    }
+
+    bool Allocator::isFree(uint32_t startSlot, uint32_t nrOfSlots) const
+    {
+        return startSlot + nrOfSlots <= m_nrOfSlots && findUsed(startSlot, nrOfSlots) == startSlot + nrOfSlots;
+    }
+
+    Allocator::Stats Allocator::stats() const
+    {
+        Stats result = {static_cast<uint16_t>(m_nrOfSlots), 0, 0, 0};
+        uint32_t freeRange = 0;
+        for (uint32_t slot = 0; slot < m_nrOfSlots; ++slot)
+        {
+            if (m_bitmap[slot >> 5] & (1U << (slot & 31)))
+            {
+                result.usedSlots++;
+                freeRange = 0;
+            }
+            else
+            {
+                result.nrOfFreeRanges += freeRange == 0 ? 1 : 0;
+                freeRange++;
+                result.largestFree = freeRange > result.largestFree ? freeRange : result.largestFree;
+            }
+        }
+        return result;
+    }
+
+    // Sprite tile memory is 32KB = 1024 slots. The sprite tile index is the slot index for both 16 and 256 color tiles
+    constexpr uint32_t SpriteSlots = 1024;
+    // Background memory is 64KB = 4 tile bases with 512 slots each. Screen blocks share this memory
+    constexpr uint32_t BackgroundSlots = 2048;
+    constexpr uint32_t SlotsPerTileBase = 512;
+    constexpr uint32_t SlotsPerScreenBlock = 64;
+    // Backgrounds can address 1024 tiles starting at their tile base
+    constexpr uint32_t MaxBackgroundTiles = 1024;
+
+    EWRAM_BSS Allocator m_spriteTiles;
+    EWRAM_BSS Allocator m_backgroundTiles;
+
+    inline uint32_t slotsPerTile(bool is256Color)
+    {
+        return is256Color ? 2 : 1;
+    }
+
+    void resetSpriteTiles(bool bitmapMode)
+    {
+        m_spriteTiles.init(SpriteSlots);
+        if (bitmapMode)
+        {
+            m_spriteTiles.reserve(0, SpriteSlots / 2);
+        }
+    }
+
+    int32_t allocateSpriteTiles(Sprites::SizeCode size, Sprites::ColorDepth depth, uint32_t nrOfSprites)
+    {
+        if (m_spriteTiles.nrOfSlots() == 0)
+        {
+            resetSpriteTiles();
+        }
+        const uint32_t perTile = slotsPerTile(depth == Sprites::ColorDepth::Depth256);
+        const uint32_t nrOfSlots = TileCountForSizeCode[static_cast<uint32_t>(size)] * perTile * nrOfSprites;
+        return m_spriteTiles.allocate(nrOfSlots, perTile);
+    }
+
+    void freeSpriteTiles(uint32_t tileIndex, Sprites::SizeCode size, Sprites::ColorDepth depth, uint32_t nrOfSprites)
+    {
+        const uint32_t perTile = slotsPerTile(depth == Sprites::ColorDepth::Depth256);
+        m_spriteTiles.free(tileIndex, TileCountForSizeCode[static_cast<uint32_t>(size)] * perTile * nrOfSprites);
+    }
+
+    Allocator::Stats spriteTileStats()
+    {
+        return m_spriteTiles.stats();
+    }
+
+    void resetBackgroundTiles()
+    {
+        m_backgroundTiles.init(BackgroundSlots);
+    }
+
+    void reserveBackgroundScreen(ScreenBase screenBase, uint32_t nrOfScreenBlocks)
+    {
+        if (m_backgroundTiles.nrOfSlots() == 0)
+        {
+            resetBackgroundTiles();
+        }
+        const uint32_t screenBlock = static_cast<uint32_t>(screenBase) >> 8;
+        m_backgroundTiles.reserve(screenBlock * SlotsPerScreenBlock, nrOfScreenBlocks * SlotsPerScreenBlock);
+    }
+
+    int32_t allocateBackgroundTiles(TileBase tileBase, uint32_t nrOfTiles, Backgrounds::ColorDepth depth)
+    {
+        if (m_backgroundTiles.nrOfSlots() == 0)
+        {
+            resetBackgroundTiles();
+        }
+        const uint32_t perTile = slotsPerTile(depth == Backgrounds::ColorDepth::Depth256);
+        const uint32_t baseSlot = (static_cast<uint32_t>(tileBase) >> 2) * SlotsPerTileBase;
+        const int32_t slot = m_backgroundTiles.allocate(nrOfTiles * perTile, perTile, baseSlot, baseSlot + MaxBackgroundTiles * perTile);
+        return slot < 0 ? -1 : (slot - baseSlot) / perTile;
+    }
+
+    void freeBackgroundTiles(TileBase tileBase, uint32_t tileIndex, uint32_t nrOfTiles, Backgrounds::ColorDepth depth)
+    {
+        const uint32_t perTile = slotsPerTile(depth == Backgrounds::ColorDepth::Depth256);
+        const uint32_t baseSlot = (static_cast<uint32_t>(tileBase) >> 2) * SlotsPerTileBase;
+        m_backgroundTiles.free(baseSlot + tileIndex * perTile, nrOfTiles * perTile);
+    }
+
+    Allocator::Stats backgroundTileStats()
+    {
+        return m_backgroundTiles.stats();
+    }
+
+} // namespace Tiles
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "backgrounds.h"
+#include "sprites.h"
+#include "tiles.h"
+
+#include <cstdint>
+
+// Allocation of tile ranges in sprite and background character memory, so scenes can share VRAM without overlaps.
+namespace Tiles
+{
+
+    /// @brief Bitmap allocator for ranges of 32 byte tile slots (one 8x8@4bpp tile).
+    /// An 8x8@8bpp tile uses two slots and must start on an even slot.
+    class Allocator
+    {
+    public:
+        /// @brief Maximum number of slots an allocator can manage.
+        static constexpr uint32_t MaxSlots = 2048;
+
+        /// @brief Fragmentation report.
+        struct Stats
+        {
+            uint16_t nrOfSlots;      // Number of slots managed
+            uint16_t usedSlots;      // Number of slots allocated
+            uint16_t largestFree;    // Size of largest free range in slots
+            uint16_t nrOfFreeRanges; // Number of free ranges. Many free ranges mean fragmentation
+        } __attribute__((aligned(4), packed));
+
+        /// @brief Set number of slots and mark all slots free.
+        void init(uint32_t nrOfSlots);
+
+        /// @brief Allocate a range of consecutive slots.
+        /// @param nrOfSlots Number of slots to allocate.
+        /// @param alignment Start slot will be a multiple of this. Must be a power of 2.
+        /// @param firstSlot Search for free range starting at this slot.
+        /// @param endSlot Free range must end before this slot.
+        /// @return Returns the start slot or -1 if no free range was found.
+        int32_t allocate(uint32_t nrOfSlots, uint32_t alignment = 1, uint32_t firstSlot = 0, uint32_t endSlot = MaxSlots);
+
+        /// @brief Mark a range of slots as allocated, e.g. because it is used for screen map data.
+        void reserve(uint32_t startSlot, uint32_t nrOfSlots);
+
+        /// @brief Free a range of slots allocated with allocate() or reserve().
+        void free(uint32_t startSlot, uint32_t nrOfSlots);
+
+        /// @brief Check if all slots in range are free.
+        bool isFree(uint32_t startSlot, uint32_t nrOfSlots) const;
+
+        /// @brief Get usage and fragmentation report.
+        Stats stats() const;
+
+        /// @brief Number of slots managed. 0 if init() has not been called yet.
+        uint32_t nrOfSlots() const { return m_nrOfSlots; }
+
+    private:
+        /// @brief Return first used slot in range or startSlot + nrOfSlots if all are free.
+        uint32_t findUsed(uint32_t startSlot, uint32_t nrOfSlots) const;
+        void setRange(uint32_t startSlot, uint32_t nrOfSlots, bool used);
+
+        uint32_t m_bitmap[MaxSlots / 32]; // Bit set if slot is used
+        uint32_t m_nrOfSlots = 0;
+    };
+
+    /// @brief Set up sprite tile memory allocation. All sprite tiles are freed.
+    /// @param bitmapMode Pass true for modes 3-5, where only the upper half of sprite tile memory (tile index >= 512) can be used.
+    void resetSpriteTiles(bool bitmapMode = false);
+
+    /// @brief Allocate tiles in sprite tile memory for sprites.
+    /// @param size Sprite size.
+    /// @param depth Sprite color depth. 256 color tiles use two tile indices each.
+    /// @param nrOfSprites Number of sprites to allocate consecutive tiles for.
+    /// @return Returns a tile index for Sprite2D::tileIndex or -1 if not enough free tile memory.
+    int32_t allocateSpriteTiles(Sprites::SizeCode size, Sprites::ColorDepth depth, uint32_t nrOfSprites = 1);
+
+    /// @brief Free sprite tiles allocated with allocateSpriteTiles().
+    void freeSpriteTiles(uint32_t tileIndex, Sprites::SizeCode size, Sprites::ColorDepth depth, uint32_t nrOfSprites = 1);
+
+    /// @brief Get sprite tile memory usage report.
+    Allocator::Stats spriteTileStats();
+
+    /// @brief Set up background character memory allocation for all 4 tile bases. All background tiles are freed.
+    void resetBackgroundTiles();
+
+    /// @brief Mark screen blocks as used, so no tiles are allocated where the map data is.
+    /// @param screenBase First screen block.
+    /// @param nrOfScreenBlocks Number of 2KB screen blocks used, e.g. 4 for a 512x512 text background.
+    void reserveBackgroundScreen(ScreenBase screenBase, uint32_t nrOfScreenBlocks = 1);
+
+    /// @brief Allocate tiles in background character memory.
+    /// Tiles are searched starting at tileBase and may extend into the following tile bases like the hardware allows.
+    /// @param tileBase Tile base the background uses.
+    /// @param nrOfTiles Number of tiles to allocate.
+    /// @param depth Background color depth. 256 color tiles use twice the memory.
+    /// @return Returns a tile index relative to tileBase for Backgrounds::Config::tileIndex or -1 if not enough free tile memory.
+    int32_t allocateBackgroundTiles(TileBase tileBase, uint32_t nrOfTiles, Backgrounds::ColorDepth depth);
+
+    /// @brief Free background tiles allocated with allocateBackgroundTiles().
+    void freeBackgroundTiles(TileBase tileBase, uint32_t tileIndex, uint32_t nrOfTiles, Backgrounds::ColorDepth depth);
+
+    /// @brief Get background character memory usage report.
+    Allocator::Stats backgroundTileStats();
+
+} // namespace Tiles
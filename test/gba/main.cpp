@@ -4,21 +4,33 @@
 #include <graphics.h>
 #include <sys/interrupts.h>
 #include <sys/memctrl.h>
+#include <sys/syscall.h>
+#include <print/print.h>
 
 int main()
 {
     // Lets set some cool waitstates
     MemCtrl::RegWaitCnt = MemCtrl::WaitCntFast;
-    MemCtrl::RegWaitEwram = MemCtrl::WaitEwramFast;
-    // Clear memory and initialize interrupts
-    irqInit();
+    MemCtrl::RegIntMemCnt = MemCtrl::WaitEwramFast;
+    // Clear memory and initialize interrupts. AdpcmPlayer and Time use Irq:: handlers
+    Irq::init();
     // Set up video mode 4, no sprites
     Graphics::setMode(MODE_4 | BG2_ON);
     // Start internal timer
     Time::start();
     // Run tests on the GBA
     Test::memory();
-    Test::copy();
+    Test::bandwidth();
+    Test::assets();
+    Test::rans();
+    Test::adpcm();
+    Test::fuzz();
+    Test::adpcmPlayer();
+    Test::overlay();
+    Test::oam();
     Test::math_fp32();
+    // End the run for headless test runners, see cmake/EmulatorGBA.cmake. Stops the CPU on hardware
+    printf("All tests done\n");
+    SYSCALL(0x03);
     return 0;
 }
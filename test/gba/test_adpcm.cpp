@@ -0,0 +1,105 @@
+#include <compression/adpcm.h>
+#include <compression/adpcm_structs.h>
+#include <compression/adpcm_tables.h>
+#include <memory/memory.h>
+#include <print/bench.h>
+#include <print/print.h>
+
+//disable GCC warnings for using char * here...
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+
+namespace Test
+{
+
+    constexpr uint32_t AdpcmHeaderSize = sizeof(Audio::AdpcmFrameHeader);
+    constexpr uint32_t AdpcmGuard = 0xEEEEEEEE;
+
+    // Build stereo frame with random data. Any nibble sequence is valid ADPCM data
+    uint32_t randomStereoFrame(uint8_t *frame, uint32_t channelBlockSize, uint32_t &seed)
+    {
+        auto random = [&seed]()
+        {
+            seed = seed * 1664525 + 1013904223;
+            return seed >> 16;
+        };
+        // 2 channels, 16 bits per sample
+        *reinterpret_cast<uint16_t *>(frame) = (2 << 5) | (16 << 7);
+        for (uint32_t i = 2; i < AdpcmHeaderSize; ++i)
+        {
+            frame[i] = 0;
+        }
+        for (uint32_t channel = 0; channel < 2; ++channel)
+        {
+            auto block = frame + AdpcmHeaderSize + channel * channelBlockSize;
+            // first sample and index
+            *reinterpret_cast<int16_t *>(block) = random();
+            *reinterpret_cast<int16_t *>(block + 2) = random() % 89;
+            for (uint32_t i = 4; i < channelBlockSize; ++i)
+            {
+                block[i] = random();
+            }
+        }
+        return AdpcmHeaderSize + 2 * channelBlockSize;
+    }
+
+    void adpcm()
+    {
+        printf("ADPCM decoder tests...\n");
+        Memory::init();
+        const uint32_t BlockSizes[] = {5, 6, 7, 36, 261, 516};
+        constexpr uint32_t MaxBlockSize = 516;
+        constexpr uint32_t MaxSamples = 2 * (MaxBlockSize - 4);
+        auto frame = Memory::malloc_EWRAM<uint8_t>(AdpcmHeaderSize + 2 * MaxBlockSize);
+        auto buffers = Memory::malloc_IWRAM<uint32_t>(4 * (MaxSamples / 4 + 1));
+        uint32_t *refLeft = buffers;
+        uint32_t *refRight = refLeft + MaxSamples / 4 + 1;
+        uint32_t *left = refRight + MaxSamples / 4 + 1;
+        uint32_t *right = left + MaxSamples / 4 + 1;
+        uint32_t seed = 0x1234567;
+        bool ok = frame != nullptr && buffers != nullptr;
+        // assembler output must match the reference exactly, including the dither state afterwards
+        for (uint32_t i = 0; ok && i < sizeof(BlockSizes) / sizeof(BlockSizes[0]); ++i)
+        {
+            const uint32_t samples = 2 * (BlockSizes[i] - 4);
+            const uint32_t frameSize = randomStereoFrame(frame, BlockSizes[i], seed);
+            const uint32_t ditherState[2] = {seed & 0xFF, seed * 7919};
+            Memory::memset32(buffers, AdpcmGuard, 4 * (MaxSamples / 4 + 1));
+            ADPCM_DitherState[0] = ditherState[0];
+            ADPCM_DitherState[1] = ditherState[1];
+            Adpcm::UnCompWriteStereo32bit_8bit(reinterpret_cast<const uint32_t *>(frame), frameSize, refLeft, refRight);
+            const uint32_t refDitherState[2] = {ADPCM_DitherState[0], ADPCM_DitherState[1]};
+            ADPCM_DitherState[0] = ditherState[0];
+            ADPCM_DitherState[1] = ditherState[1];
+            Adpcm_UnCompWriteStereo32bit_8bit(reinterpret_cast<const uint32_t *>(frame), frameSize, left, right);
+            bool frameOk = ADPCM_DitherState[0] == refDitherState[0] && ADPCM_DitherState[1] == refDitherState[1];
+            // compare including the guard bytes after the samples
+            auto left8 = reinterpret_cast<const uint8_t *>(left);
+            auto right8 = reinterpret_cast<const uint8_t *>(right);
+            auto refLeft8 = reinterpret_cast<const uint8_t *>(refLeft);
+            auto refRight8 = reinterpret_cast<const uint8_t *>(refRight);
+            for (uint32_t s = 0; frameOk && s < samples + 4; ++s)
+            {
+                frameOk = left8[s] == refLeft8[s] && right8[s] == refRight8[s];
+            }
+            frameOk = frameOk && left8[samples] == (AdpcmGuard & 0xFF) && right8[samples] == (AdpcmGuard & 0xFF);
+            printf("Stereo frame, %d samples: %s\n", samples, frameOk ? "ok" : "FAILED");
+            ok = ok && frameOk;
+        }
+        // decode cost of planar vs. lockstep stereo decoding
+        if (ok)
+        {
+            const uint32_t frameSize = randomStereoFrame(frame, MaxBlockSize, seed);
+            Debug::startCycles();
+            Adpcm_UnCompWrite32bit_8bit(reinterpret_cast<const uint32_t *>(frame), frameSize, refLeft);
+            const uint32_t cyclesPlanar = Debug::endCycles();
+            Debug::startCycles();
+            Adpcm_UnCompWriteStereo32bit_8bit(reinterpret_cast<const uint32_t *>(frame), frameSize, left, right);
+            const uint32_t cyclesStereo = Debug::endCycles();
+            printf("%d stereo samples planar: %d cycles, lockstep: %d cycles\n", MaxSamples, cyclesPlanar, cyclesStereo);
+        }
+        Memory::free(buffers);
+        Memory::free(frame);
+        printf("Results: %s\n", ok ? "ok" : "FAILED");
+    }
+
+} // namespace Test
@@ -0,0 +1,139 @@
+#include <graphics.h>
+#include <memory/dma.h>
+#include <memory/memory.h>
+#include <print/print.h>
+#include <sound/adpcmplayer.h>
+
+#include "../../tools/fuzzpack/fuzzvectors.h"
+
+// Generated by gba_add_fuzz_vectors() in CMakeLists.txt
+#include "fuzz.h"
+
+// disable GCC warnings for using char * here...
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+
+// AdpcmPlayer test. Plays the short tone streams fuzzpack puts into the fuzz vectors once and looped, and checks
+// invalid headers and DMA channels held by someone else are rejected
+namespace Test
+{
+
+    // Find the first ADPCM stream with nrOfChannels channels in the fuzz vectors
+    const AdpcmPlayer::StreamHeader *findAdpcmStream(uint32_t nrOfChannels)
+    {
+        auto header = reinterpret_cast<const Fuzz::VectorHeader *>(fuzz_vectors);
+        auto current = reinterpret_cast<const uint8_t *>(header + 1);
+        for (uint32_t i = 0; header->magic == Fuzz::VectorMagic && i < header->nrOfCases; ++i)
+        {
+            auto c = reinterpret_cast<const Fuzz::CaseHeader *>(current);
+            auto stream = reinterpret_cast<const AdpcmPlayer::StreamHeader *>(c + 1);
+            if (c->type == Fuzz::CaseType::AdpcmStream && stream->nrOfChannels == nrOfChannels)
+            {
+                return stream;
+            }
+            current = reinterpret_cast<const uint8_t *>(stream) + ((c->inputSize + 3) & ~3) + ((c->referenceSize + 3) & ~3);
+        }
+        return nullptr;
+    }
+
+    // Wait until the stream has ended, at most maxVblanks. Returns the number of Vblanks waited
+    uint32_t waitForAdpcmEnd(uint32_t maxVblanks)
+    {
+        uint32_t vblanks = 0;
+        for (; AdpcmPlayer::isPlaying() && vblanks < maxVblanks; ++vblanks)
+        {
+            Graphics::waitForVblank();
+        }
+        return vblanks;
+    }
+
+    bool isAdpcmDmaReserved()
+    {
+        return DMA::isChannelReserved(1) && DMA::isChannelReserved(2);
+    }
+
+    bool isAdpcmDmaReleased()
+    {
+        return !DMA::isChannelReserved(1) && !DMA::isChannelReserved(2);
+    }
+
+    // Headers whose frame size does not match samplesPerFrame must be rejected without reserving anything
+    bool checkAdpcmInvalidHeaders(const AdpcmPlayer::StreamHeader *stream)
+    {
+        AdpcmPlayer::StreamHeader header = *stream;
+        header.samplesPerFrame += 16;
+        bool ok = !AdpcmPlayer::play(&header) && isAdpcmDmaReleased();
+        header = *stream;
+        header.frameSize += 4;
+        ok = ok && !AdpcmPlayer::play(&header) && isAdpcmDmaReleased();
+        header = *stream;
+        header.frameSize = 4;
+        ok = ok && !AdpcmPlayer::play(&header) && isAdpcmDmaReleased();
+        return ok;
+    }
+
+    // play() must fail if another module holds a FIFO DMA channel and must not keep the other one
+    bool checkAdpcmDmaConflict(const AdpcmPlayer::StreamHeader *stream)
+    {
+        bool ok = DMA::reserveChannel(2);
+        ok = ok && !AdpcmPlayer::play(stream) && !DMA::isChannelReserved(1);
+        DMA::releaseChannel(2);
+        ok = ok && DMA::reserveChannel(1);
+        ok = ok && !AdpcmPlayer::play(stream) && !DMA::isChannelReserved(2);
+        DMA::releaseChannel(1);
+        return ok;
+    }
+
+    // Play stream once, then looped
+    bool checkAdpcmPlayback(const AdpcmPlayer::StreamHeader *stream)
+    {
+        const uint32_t nrOfSamples = stream->nrOfFrames * stream->samplesPerFrame;
+        // the display runs at ~59.73 Hz. wait twice the stream duration before giving up
+        const uint32_t minVblanks = (nrOfSamples * 59) / stream->sampleRate;
+        const uint32_t maxVblanks = 2 * (nrOfSamples * 60) / stream->sampleRate + 10;
+        bool ok = AdpcmPlayer::play(stream) && AdpcmPlayer::isPlaying() && isAdpcmDmaReserved();
+        const uint32_t vblanks = waitForAdpcmEnd(maxVblanks);
+        const auto stats = AdpcmPlayer::getStats();
+        // the first two frames are decoded by play(), every other buffer switch decodes a frame or the final silence
+        ok = ok && !AdpcmPlayer::isPlaying() && vblanks + 1 >= minVblanks && AdpcmPlayer::getPlayedSamples() == nrOfSamples;
+        ok = ok && stats.nrOfFrames == stream->nrOfFrames - 1 && stats.maxCycles > 0 && stats.maxCycles < stats.cyclesPerFrame;
+        // the channels stay reserved until the stream is stopped
+        ok = ok && isAdpcmDmaReserved();
+        AdpcmPlayer::stop();
+        ok = ok && isAdpcmDmaReleased();
+        printf("%d samples in %d frames: avg. %d, max. %d of %d cycles per frame\n", nrOfSamples, vblanks, stats.averageCycles, stats.maxCycles, stats.cyclesPerFrame);
+        // a looped stream never ends
+        ok = ok && AdpcmPlayer::play(stream, true);
+        waitForAdpcmEnd(maxVblanks);
+        ok = ok && AdpcmPlayer::isPlaying() && AdpcmPlayer::getPlayedSamples() > nrOfSamples;
+        AdpcmPlayer::stop();
+        ok = ok && !AdpcmPlayer::isPlaying() && isAdpcmDmaReleased();
+        return ok;
+    }
+
+    void adpcmPlayer()
+    {
+        printf("ADPCM player tests...\n");
+        Memory::init();
+        bool ok = true;
+        for (uint32_t nrOfChannels = 1; nrOfChannels <= 2; ++nrOfChannels)
+        {
+            const char *name = nrOfChannels == 1 ? "Mono" : "Stereo";
+            const auto stream = findAdpcmStream(nrOfChannels);
+            if (stream == nullptr)
+            {
+                printf("%s stream not found in fuzz vectors: FAILED\n", name);
+                ok = false;
+                continue;
+            }
+            const bool headersOk = checkAdpcmInvalidHeaders(stream);
+            printf("%s invalid headers: %s\n", name, headersOk ? "ok" : "FAILED");
+            const bool dmaOk = checkAdpcmDmaConflict(stream);
+            printf("%s DMA reserved elsewhere: %s\n", name, dmaOk ? "ok" : "FAILED");
+            const bool playOk = checkAdpcmPlayback(stream);
+            printf("%s playback: %s\n", name, playOk ? "ok" : "FAILED");
+            ok = ok && headersOk && dmaOk && playOk;
+        }
+        printf("Results: %s\n", ok ? "ok" : "FAILED");
+    }
+
+} // namespace Test
@@ -0,0 +1,61 @@
+#include <assets.h>
+#include <memory/memory.h>
+#include <print/bench.h>
+#include <print/print.h>
+
+// Generated by gba_add_assets() in CMakeLists.txt
+#include "test_assets.h"
+
+//disable GCC warnings for using char * here...
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+
+namespace Test
+{
+
+    bool isEqualBytes(const uint8_t *a, const uint8_t *b, uint32_t size)
+    {
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            if (a[i] != b[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void assets()
+    {
+        printf("Asset archive tests...\n");
+        Memory::init();
+        bool ok = Assets::init(test_assets_archive, 16 * 1024);
+        // uncompressed data comes straight from ROM
+        auto raw = Assets::get<uint8_t>(test_assets::main_raw);
+        ok = ok && raw != nullptr && reinterpret_cast<uint32_t>(raw) >= 0x08000000 && Assets::cacheStats().misses == 0;
+        // compressed data is decompressed once, then served from cache
+        Debug::startCycles();
+        auto decompressed = Assets::get<uint8_t>(test_assets::main);
+        const uint32_t cyclesMiss = Debug::endCycles();
+        Debug::startCycles();
+        auto cached = Assets::get<uint8_t>(test_assets::main);
+        const uint32_t cyclesHit = Debug::endCycles();
+        ok = ok && decompressed != nullptr && cached == decompressed && Assets::size(test_assets::main) == Assets::size(test_assets::main_raw);
+        ok = ok && isEqualBytes(raw, decompressed, Assets::size(test_assets::main));
+        auto stats = Assets::cacheStats();
+        ok = ok && stats.hits == 1 && stats.misses == 1 && stats.entries == 1;
+        printf("get() miss: %d cycles, hit: %d cycles\n", cyclesMiss, cyclesHit);
+        // least recently used entry is evicted when the budget is exceeded
+        Assets::get(test_assets::tests);
+        Assets::get(test_assets::main);
+        Assets::setCacheBudget(Assets::cacheStats().bytes - 1);
+        ok = ok && Assets::isCached(test_assets::main) && !Assets::isCached(test_assets::tests) && Assets::cacheStats().evictions == 1;
+        Assets::setCacheBudget(Assets::size(test_assets::test_memory) + 3);
+        ok = ok && Assets::get(test_assets::test_memory) != nullptr && !Assets::isCached(test_assets::main) && Assets::cacheStats().entries == 1;
+        // unknown ids
+        ok = ok && Assets::get(Assets::id("unknown")) == nullptr && Assets::size(Assets::id("unknown")) == 0;
+        Assets::clearCache();
+        ok = ok && Assets::cacheStats().entries == 0 && Assets::cacheStats().bytes == 0;
+        printf("Results: %s\n", ok ? "ok" : "FAILED");
+    }
+
+} // namespace Test
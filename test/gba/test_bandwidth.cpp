@@ -0,0 +1,606 @@
+#include <graphics.h>
+#include <compression/bios.h>
+#include <compression/decode.h>
+#include <compression/lz4.h>
+#include <compression/lz77.h>
+#include <memory/dma.h>
+#include <memory/memory.h>
+#include <print/bench.h>
+#include <print/output.h>
+#include <print/print.h>
+#include <sys/memctrl.h>
+#include <sys/syscall.h>
+
+#include <cstring>
+
+// disable GCC warnings for using char * here...
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+
+// Memory bandwidth benchmark. Measures copy, fill and decompression routines in cycles per byte
+// for all source and destination memory regions and outputs CSV lines over the mGBA debug channel:
+// routine,source,destination,bytes,cycles,cycles_per_byte,ok
+// Lines starting with # are comments, e.g. the wait state settings the benchmark ran with.
+namespace Test
+{
+
+    constexpr uint32_t BenchSize = 4096;
+
+    // Source data in ROM. Filled with an index hash at compile time, so every word differs
+    // and a copy that skips or duplicates words fails the comparison against the source
+    struct RomPattern
+    {
+        uint32_t data[BenchSize / 4];
+
+        constexpr RomPattern() : data()
+        {
+            for (uint32_t i = 0; i < BenchSize / 4; ++i)
+            {
+                data[i] = ((i + 1) * 0x9E3779B1) ^ (i << 16);
+            }
+        }
+    };
+    constexpr RomPattern RomData;
+
+    struct Region
+    {
+        const char *name;
+        uint8_t *buffer;
+    };
+
+    //-----BIOS functions-------------------------------------------------------
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+    NOINLINE void CpuSet(const void *source, void *dest, uint32_t mode)
+    {
+        SYSCALL(0x0B);
+    }
+
+    NOINLINE void CpuFastSet(const void *source, void *dest, uint32_t mode)
+    {
+        SYSCALL(0x0C);
+    }
+#pragma GCC diagnostic pop
+
+    //-----Copy and fill functions with common signature------------------------
+
+    struct CopyFunction
+    {
+        const char *name;
+        void (*function)(void *, const void *, uint32_t);
+    };
+
+    void copyMemcpy16(void *dst, const void *src, uint32_t bytes) { Memory::memcpy16(dst, src, bytes >> 1); }
+    void copyMemcpy32(void *dst, const void *src, uint32_t bytes) { Memory::memcpy32(dst, src, bytes >> 2); }
+    void copyDma16(void *dst, const void *src, uint32_t bytes) { DMA::dma_copy16(dst, reinterpret_cast<const uint16_t *>(src), bytes >> 1); }
+    void copyDma32(void *dst, const void *src, uint32_t bytes) { DMA::dma_copy32(dst, reinterpret_cast<const uint32_t *>(src), bytes >> 2); }
+    void copyCpuSet16(void *dst, const void *src, uint32_t bytes) { CpuSet(src, dst, bytes >> 1); }
+    void copyCpuSet32(void *dst, const void *src, uint32_t bytes) { CpuSet(src, dst, (bytes >> 2) | (1 << 26)); }
+    void copyCpuFastSet(void *dst, const void *src, uint32_t bytes) { CpuFastSet(src, dst, bytes >> 2); }
+    void copyMemcpy8(void *dst, const void *src, uint32_t bytes) { Memory::memcpy8(dst, src, bytes); }
+    void copyMemcpy8Write16bit(void *dst, const void *src, uint32_t bytes) { Memory::memcpy8Write16bit(dst, src, bytes); }
+    void copyMemmove8(void *dst, const void *src, uint32_t bytes) { Memory::memmove8(dst, src, bytes); }
+    void copyLibcMemcpy(void *dst, const void *src, uint32_t bytes) { ::memcpy(dst, src, bytes); }
+    void copyLibcMemmove(void *dst, const void *src, uint32_t bytes) { ::memmove(dst, src, bytes); }
+
+    const CopyFunction CopyFunctions[] = {
+        {"memcpy16", copyMemcpy16},
+        {"memcpy32", copyMemcpy32},
+        {"dma_copy16", copyDma16},
+        {"dma_copy32", copyDma32},
+        {"CpuSet16", copyCpuSet16},
+        {"CpuSet32", copyCpuSet32},
+        {"CpuFastSet", copyCpuFastSet},
+        {"memcpy8", copyMemcpy8},
+        {"memcpy8Write16bit", copyMemcpy8Write16bit},
+        {"memcpy", copyLibcMemcpy}};
+
+    struct UnalignedCopyFunction
+    {
+        const char *name;
+        void (*function)(void *, const void *, uint32_t);
+        bool vramSafe; // True if the function never writes single bytes
+    };
+
+    const UnalignedCopyFunction UnalignedCopyFunctions[] = {
+        {"memcpy8", copyMemcpy8, false},
+        {"memcpy8Write16bit", copyMemcpy8Write16bit, true},
+        {"memmove8", copyMemmove8, false},
+        {"memcpy", copyLibcMemcpy, false},
+        {"memmove", copyLibcMemmove, false}};
+
+    struct Misalignment
+    {
+        uint32_t srcOffset;
+        uint32_t dstOffset;
+        const char *srcName;
+        const char *dstName;
+    };
+
+    // Byte offsets of source and destination from word alignment
+    const Misalignment Misalignments[] = {
+        {0, 0, "+0", "+0"},
+        {1, 0, "+1", "+0"},
+        {2, 0, "+2", "+0"},
+        {3, 1, "+3", "+1"},
+        {1, 3, "+1", "+3"}};
+
+    const CopyFunction MoveFunctions[] = {
+        {"memmove8", copyMemmove8},
+        {"memmove", copyLibcMemmove}};
+
+    // Destination offsets from source for overlapping moves in the same buffer
+    const int32_t MoveOffsets[] = {-3, -1, 1, 3, 4};
+
+    struct FillFunction
+    {
+        const char *name;
+        void (*function)(void *, uint32_t, uint32_t);
+    };
+
+    void fillMemset16(void *dst, uint32_t value, uint32_t bytes) { Memory::memset16(dst, value, bytes >> 1); }
+    void fillMemset32(void *dst, uint32_t value, uint32_t bytes) { Memory::memset32(dst, value, bytes >> 2); }
+    void fillDma16(void *dst, uint32_t value, uint32_t bytes) { DMA::dma_fill16(dst, value, bytes >> 1); }
+    void fillDma32(void *dst, uint32_t value, uint32_t bytes) { DMA::dma_fill32(dst, value, bytes >> 2); }
+    void fillCpuFastSet(void *dst, uint32_t value, uint32_t bytes) { CpuFastSet(&value, dst, (bytes >> 2) | (1 << 24)); }
+
+    const FillFunction FillFunctions[] = {
+        {"memset16", fillMemset16},
+        {"memset32", fillMemset32},
+        {"dma_fill16", fillDma16},
+        {"dma_fill32", fillDma32},
+        {"CpuFastSet_fill", fillCpuFastSet}};
+
+    struct DecompressFunction
+    {
+        const char *name;
+        void (*function)(const void *, void *);
+        uint8_t type;  // Compression type byte of data
+        bool vramSafe; // True if the function writes 16 bit units
+    };
+
+    void decodeLZ77_8(const void *src, void *dst) { Compression::LZ77UnCompWrite8bit_ASM(src, dst); }
+    void decodeLZ77_16(const void *src, void *dst) { Compression::LZ77UnCompWrite16bit_ASM(src, dst); }
+    void decodeLZ4_8C(const void *src, void *dst) { Compression::LZ4UnCompWrite8bit(reinterpret_cast<const uint32_t *>(src), reinterpret_cast<uint32_t *>(dst)); }
+    void decodeLZ4_8(const void *src, void *dst) { Compression::LZ4UnCompWrite8bit_ASM(reinterpret_cast<const uint32_t *>(src), reinterpret_cast<uint32_t *>(dst)); }
+    void decodeLZ4_16(const void *src, void *dst) { Compression::LZ4UnCompWrite16bit_ASM(reinterpret_cast<const uint32_t *>(src), reinterpret_cast<uint32_t *>(dst)); }
+    void decodeLZ4_DMA(const void *src, void *dst) { Compression::LZ4UnCompWriteDMA(reinterpret_cast<const uint32_t *>(src), reinterpret_cast<uint32_t *>(dst)); }
+    void decodeRL_8(const void *src, void *dst) { Compression::RLUnCompReadNormalWrite8bit(src, dst); }
+    void decodeRL_16(const void *src, void *dst) { Compression::RLUnCompReadNormalWrite16bit(src, dst); }
+
+    const DecompressFunction DecompressFunctions[] = {
+        {"LZ77UnCompWrite8bit_ASM", decodeLZ77_8, 0x10, false},
+        {"LZ77UnCompWrite16bit_ASM", decodeLZ77_16, 0x10, true},
+        {"LZ4UnCompWrite8bit", decodeLZ4_8C, 0x40, false},
+        {"LZ4UnCompWrite8bit_ASM", decodeLZ4_8, 0x40, false},
+        {"LZ4UnCompWrite16bit_ASM", decodeLZ4_16, 0x40, true},
+        {"LZ4UnCompWriteDMA", decodeLZ4_DMA, 0x40, true},
+        {"RLUnCompReadNormalWrite8bit", decodeRL_8, 0x30, false},
+        {"RLUnCompReadNormalWrite16bit", decodeRL_16, 0x30, true}};
+
+    // Compression types with a runtime encoder below
+    const uint8_t DecompressTypes[] = {0x10, 0x30, 0x40};
+
+    //-----Test data------------------------------------------------------------
+
+    // Image-like data with flat areas, repeated patterns and some noise
+    void generateData(uint8_t *data, uint32_t size)
+    {
+        uint32_t seed = 0x1234567;
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            seed = seed * 1664525 + 1013904223;
+            const uint32_t x = i & 63;
+            const uint32_t y = i >> 6;
+            data[i] = ((x >> 3) ^ (y >> 2)) * 17 + ((seed >> 29) == 0 ? (seed >> 16) & 0xFF : 0);
+        }
+    }
+
+    // Find longest match before pos in window
+    uint32_t findMatch(const uint8_t *src, uint32_t size, uint32_t pos, uint32_t minDistance, uint32_t maxDistance, uint32_t maxLength, uint32_t &bestDistance)
+    {
+        uint32_t bestLength = 0;
+        maxDistance = pos < maxDistance ? pos : maxDistance;
+        for (uint32_t distance = minDistance; distance <= maxDistance; ++distance)
+        {
+            uint32_t length = 0;
+            while (length < maxLength && pos + length < size && src[pos + length] == src[pos + length - distance])
+            {
+                length++;
+            }
+            if (length > bestLength)
+            {
+                bestLength = length;
+                bestDistance = distance;
+                if (length == maxLength)
+                {
+                    break;
+                }
+            }
+        }
+        return bestLength;
+    }
+
+    uint32_t padSize(uint8_t *dst, uint8_t *out)
+    {
+        while ((out - dst) & 3)
+        {
+            *out++ = 0;
+        }
+        return out - dst;
+    }
+
+    // Greedy LZ77 10h compression. Distance >= 2, so data can be decoded to VRAM
+    uint32_t compressLZ77(const uint8_t *src, uint32_t size, uint8_t *dst)
+    {
+        *reinterpret_cast<uint32_t *>(dst) = 0x10 | (size << 8);
+        auto out = dst + 4;
+        uint32_t pos = 0;
+        while (pos < size)
+        {
+            auto flags = out++;
+            *flags = 0;
+            for (uint32_t block = 0; block < 8 && pos < size; ++block)
+            {
+                uint32_t distance = 0;
+                const uint32_t length = findMatch(src, size, pos, 2, 512, 18, distance);
+                if (length >= 3)
+                {
+                    *flags |= 0x80 >> block;
+                    *out++ = ((length - 3) << 4) | ((distance - 1) >> 8);
+                    *out++ = (distance - 1) & 0xFF;
+                    pos += length;
+                }
+                else
+                {
+                    *out++ = src[pos++];
+                }
+            }
+        }
+        return padSize(dst, out);
+    }
+
+    uint8_t *writeLZ4Length(uint8_t *out, uint32_t length)
+    {
+        for (length -= 15; length >= 255; length -= 255)
+        {
+            *out++ = 255;
+        }
+        *out++ = length;
+        return out;
+    }
+
+    uint8_t *writeLZ4Sequence(uint8_t *out, const uint8_t *literals, uint32_t literalLength, uint32_t distance, uint32_t matchLength)
+    {
+        const uint32_t matchCode = matchLength > 0 ? matchLength - 3 : 0;
+        *out++ = ((literalLength < 15 ? literalLength : 15) << 4) | (matchCode < 15 ? matchCode : 15);
+        if (literalLength >= 15)
+        {
+            out = writeLZ4Length(out, literalLength);
+        }
+        for (uint32_t i = 0; i < literalLength; ++i)
+        {
+            *out++ = literals[i];
+        }
+        if (matchLength > 0)
+        {
+            *out++ = distance >> 8;
+            *out++ = distance & 0xFF;
+            if (matchCode >= 15)
+            {
+                out = writeLZ4Length(out, matchCode);
+            }
+        }
+        return out;
+    }
+
+    // Greedy LZ4 40h compression
+    uint32_t compressLZ4(const uint8_t *src, uint32_t size, uint8_t *dst)
+    {
+        *reinterpret_cast<uint32_t *>(dst) = 0x40 | (size << 8);
+        auto out = dst + 4;
+        uint32_t pos = 0;
+        uint32_t literalStart = 0;
+        while (pos < size)
+        {
+            uint32_t distance = 0;
+            const uint32_t length = findMatch(src, size, pos, 1, 512, 255, distance);
+            if (length >= 4)
+            {
+                out = writeLZ4Sequence(out, src + literalStart, pos - literalStart, distance, length);
+                pos += length;
+                literalStart = pos;
+            }
+            else
+            {
+                pos++;
+            }
+        }
+        if (literalStart < size)
+        {
+            out = writeLZ4Sequence(out, src + literalStart, size - literalStart, 0, 0);
+        }
+        return padSize(dst, out);
+    }
+
+    uint32_t runLength(const uint8_t *src, uint32_t size, uint32_t pos)
+    {
+        uint32_t length = 1;
+        while (length < 130 && pos + length < size && src[pos + length] == src[pos])
+        {
+            length++;
+        }
+        return length;
+    }
+
+    // RLE 30h compression
+    uint32_t compressRL(const uint8_t *src, uint32_t size, uint8_t *dst)
+    {
+        *reinterpret_cast<uint32_t *>(dst) = 0x30 | (size << 8);
+        auto out = dst + 4;
+        uint32_t pos = 0;
+        while (pos < size)
+        {
+            const uint32_t run = runLength(src, size, pos);
+            if (run >= 3)
+            {
+                *out++ = 0x80 | (run - 3);
+                *out++ = src[pos];
+                pos += run;
+            }
+            else
+            {
+                const uint32_t start = pos;
+                while (pos < size && pos - start < 128 && runLength(src, size, pos) < 3)
+                {
+                    pos++;
+                }
+                *out++ = pos - start - 1;
+                for (uint32_t i = start; i < pos; ++i)
+                {
+                    *out++ = src[i];
+                }
+            }
+        }
+        return padSize(dst, out);
+    }
+
+    // Compress BenchSize bytes with the encoder for the compression type
+    uint32_t compressData(uint8_t type, const uint8_t *src, uint8_t *dst)
+    {
+        switch (type)
+        {
+        case 0x10:
+            return compressLZ77(src, BenchSize, dst);
+        case 0x40:
+            return compressLZ4(src, BenchSize, dst);
+        default:
+            return compressRL(src, BenchSize, dst);
+        }
+    }
+
+    //-----Measurement----------------------------------------------------------
+
+    // Cycles of an empty measurement, subtracted from all results
+    uint32_t m_overhead = 0;
+
+    // Cycles per byte as 16.16 fixed-point for %f
+    int32_t cyclesPerByte(uint32_t cycles, uint32_t bytes)
+    {
+        return static_cast<int32_t>((static_cast<uint64_t>(cycles) << 16) / bytes);
+    }
+
+    void printResult(const char *routine, const char *source, const char *destination, uint32_t bytes, uint32_t cycles, bool ok)
+    {
+        Debug::printf("%s,%s,%s,%d,%d,%.3f,%d", routine, source, destination, bytes, cycles, cyclesPerByte(cycles, bytes), ok ? 1 : 0);
+    }
+
+    bool isEqual(const uint8_t *a, const uint8_t *b, uint32_t size)
+    {
+        for (uint32_t i = 0; i < size; ++i)
+        {
+            if (a[i] != b[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isFilled(const uint8_t *data, uint32_t value, uint32_t size)
+    {
+        auto data32 = reinterpret_cast<const uint32_t *>(data);
+        for (uint32_t i = 0; i < size / 4; ++i)
+        {
+            if (data32[i] != value)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void bandwidth()
+    {
+        printf("Memory bandwidth benchmark...\n");
+        Memory::init();
+        m_overhead = Debug::measureCycles([]() {});
+        auto vram = reinterpret_cast<uint8_t *>(Graphics::backBuffer());
+        const Region sources[] = {
+            {"ROM", reinterpret_cast<uint8_t *>(const_cast<uint32_t *>(RomData.data))},
+            {"IWRAM", static_cast<uint8_t *>(Memory::malloc_IWRAM(BenchSize))},
+            {"EWRAM", static_cast<uint8_t *>(Memory::malloc_EWRAM(BenchSize))},
+            {"VRAM", vram + 2 * BenchSize}};
+        const Region destinations[] = {
+            {"IWRAM", static_cast<uint8_t *>(Memory::malloc_IWRAM(BenchSize))},
+            {"EWRAM", static_cast<uint8_t *>(Memory::malloc_EWRAM(BenchSize))},
+            {"VRAM", vram}};
+        // fill RAM sources with test data
+        auto original = static_cast<uint8_t *>(Memory::malloc_EWRAM(BenchSize));
+        generateData(original, BenchSize);
+        for (uint32_t s = 1; s < sizeof(sources) / sizeof(sources[0]); ++s)
+        {
+            Memory::memcpy32(sources[s].buffer, original, BenchSize / 4);
+        }
+        Debug::printf("# waitcnt=%x ewram=%x overhead=%d", static_cast<int32_t>(MemCtrl::RegWaitCnt), static_cast<int32_t>(MemCtrl::RegIntMemCnt), m_overhead);
+        Debug::printf("routine,source,destination,bytes,cycles,cycles_per_byte,ok");
+        // copy
+        for (const auto &copy : CopyFunctions)
+        {
+            for (const auto &src : sources)
+            {
+                for (const auto &dst : destinations)
+                {
+                    Memory::memset32(dst.buffer, 0, BenchSize / 4);
+                    const uint32_t cycles = Debug::measureCycles([&]() { copy.function(dst.buffer, src.buffer, BenchSize); }, m_overhead);
+                    printResult(copy.name, src.name, dst.name, BenchSize, cycles, isEqual(dst.buffer, src.buffer, BenchSize));
+                }
+            }
+        }
+        // copy with misaligned source and destination. name columns are region and byte offset
+        const uint32_t unalignedSize = BenchSize - 4;
+        for (const auto &copy : UnalignedCopyFunctions)
+        {
+            for (const auto &offset : Misalignments)
+            {
+                for (const auto &dst : destinations)
+                {
+                    if (dst.buffer == vram && !copy.vramSafe)
+                    {
+                        continue;
+                    }
+                    const auto srcBuffer = sources[2].buffer + offset.srcOffset;
+                    const auto dstBuffer = dst.buffer + offset.dstOffset;
+                    Memory::memset32(dst.buffer, 0, BenchSize / 4);
+                    const uint32_t cycles = Debug::measureCycles([&]() { copy.function(dstBuffer, srcBuffer, unalignedSize); }, m_overhead);
+                    // check that bytes around the destination are untouched
+                    const bool ok = isEqual(dstBuffer, srcBuffer, unalignedSize) && (offset.dstOffset == 0 || dstBuffer[-1] == 0) && dstBuffer[unalignedSize] == 0;
+                    Debug::printf("%s,EWRAM%s,%s%s,%d,%d,%.3f,%d", copy.name, offset.srcName, dst.name, offset.dstName, unalignedSize, cycles, cyclesPerByte(cycles, unalignedSize), ok ? 1 : 0);
+                }
+            }
+        }
+        // overlapping moves in IWRAM
+        for (const auto &move : MoveFunctions)
+        {
+            for (const auto offset : MoveOffsets)
+            {
+                auto buffer = destinations[0].buffer;
+                Memory::memcpy32(buffer, original, BenchSize / 4);
+                const auto srcBuffer = buffer + 4;
+                const auto dstBuffer = srcBuffer + offset;
+                const uint32_t cycles = Debug::measureCycles([&]() { move.function(dstBuffer, srcBuffer, unalignedSize - 4); }, m_overhead);
+                const bool ok = isEqual(dstBuffer, original + 4, unalignedSize - 4);
+                Debug::printf("%s,IWRAM+0,IWRAM%s%d,%d,%d,%.3f,%d", move.name, offset < 0 ? "" : "+", offset, unalignedSize - 4, cycles, cyclesPerByte(cycles, unalignedSize - 4), ok ? 1 : 0);
+            }
+        }
+        // fill
+        for (const auto &fill : FillFunctions)
+        {
+            for (const auto &dst : destinations)
+            {
+                const uint32_t value = fill.function == fillMemset16 || fill.function == fillDma16 ? 0x5A5A5A5A : 0x12345678;
+                const uint32_t cycles = Debug::measureCycles([&]() { fill.function(dst.buffer, value, BenchSize); }, m_overhead);
+                printResult(fill.name, "-", dst.name, BenchSize, cycles, isFilled(dst.buffer, value, BenchSize));
+            }
+        }
+        // decompress. compressed data is in EWRAM and IWRAM
+        auto compressed = static_cast<uint8_t *>(Memory::malloc_EWRAM(BenchSize + BenchSize / 2));
+        for (const auto &decompress : DecompressFunctions)
+        {
+            const uint32_t compressedSize = compressData(decompress.type, original, compressed);
+            auto compressedIWRAM = static_cast<uint8_t *>(Memory::malloc_IWRAM(compressedSize));
+            Memory::memcpy32(compressedIWRAM, compressed, compressedSize / 4);
+            const Region compressedSources[] = {{"IWRAM", compressedIWRAM}, {"EWRAM", compressed}};
+            for (const auto &src : compressedSources)
+            {
+                for (const auto &dst : destinations)
+                {
+                    if (dst.buffer == vram && !decompress.vramSafe)
+                    {
+                        continue;
+                    }
+                    Memory::memset32(dst.buffer, 0, BenchSize / 4);
+                    const uint32_t cycles = Debug::measureCycles([&]() { decompress.function(src.buffer, dst.buffer); }, m_overhead);
+                    printResult(decompress.name, src.name, dst.name, BenchSize, cycles, isEqual(dst.buffer, original, BenchSize));
+                }
+            }
+            Memory::free(compressedIWRAM);
+        }
+        // LZ4 IWRAM window + DMA3 pipeline vs. decoding directly to the destination. speedup > 1 means the pipeline is faster
+        {
+            auto window = Memory::malloc_IWRAM(2 * Compression::LZ4ChunkSize);
+            if (window == nullptr)
+            {
+                Debug::printf("# lz4 pipeline: no IWRAM for window. LZ4UnCompWriteDMA falls back to LZ4UnCompWrite16bit_ASM");
+            }
+            Memory::free(window);
+            const uint32_t compressedSize = compressLZ4(original, BenchSize, compressed);
+            auto compressedIWRAM = static_cast<uint8_t *>(Memory::malloc_IWRAM(compressedSize));
+            Memory::memcpy32(compressedIWRAM, compressed, compressedSize / 4);
+            const Region compressedSources[] = {{"IWRAM", compressedIWRAM}, {"EWRAM", compressed}};
+            Debug::printf("# lz4 pipeline,source,destination,pipeline_cycles,asm16_cycles,speedup,ok");
+            for (const auto &src : compressedSources)
+            {
+                for (const auto &dst : destinations)
+                {
+                    Memory::memset32(dst.buffer, 0, BenchSize / 4);
+                    const uint32_t pipelineCycles = Debug::measureCycles([&]() { decodeLZ4_DMA(src.buffer, dst.buffer); }, m_overhead);
+                    bool ok = isEqual(dst.buffer, original, BenchSize);
+                    Memory::memset32(dst.buffer, 0, BenchSize / 4);
+                    const uint32_t asmCycles = Debug::measureCycles([&]() { decodeLZ4_16(src.buffer, dst.buffer); }, m_overhead);
+                    ok = ok && isEqual(dst.buffer, original, BenchSize);
+                    Debug::printf("# lz4 pipeline,%s,%s,%d,%d,%.3f,%d", src.name, dst.name, pipelineCycles, asmCycles, cyclesPerByte(asmCycles, pipelineCycles), ok ? 1 : 0);
+                }
+            }
+            Memory::free(compressedIWRAM);
+        }
+        // codec dispatch. compare Compression::decode() with the fastest decoder for each type, source and destination
+        Debug::printf("# fastest,type,source,destination,fastest_routine,decode_routine");
+        for (const uint8_t type : DecompressTypes)
+        {
+            const uint32_t compressedSize = compressData(type, original, compressed);
+            auto compressedIWRAM = static_cast<uint8_t *>(Memory::malloc_IWRAM(compressedSize));
+            Memory::memcpy32(compressedIWRAM, compressed, compressedSize / 4);
+            const Region compressedSources[] = {{"IWRAM", compressedIWRAM}, {"EWRAM", compressed}};
+            for (const auto &src : compressedSources)
+            {
+                for (const auto &dst : destinations)
+                {
+                    const char *fastest = nullptr;
+                    uint32_t fastestCycles = 0xFFFFFFFF;
+                    for (const auto &decompress : DecompressFunctions)
+                    {
+                        if (decompress.type != type || (dst.buffer == vram && !decompress.vramSafe))
+                        {
+                            continue;
+                        }
+                        Memory::memset32(dst.buffer, 0, BenchSize / 4);
+                        const uint32_t cycles = Debug::measureCycles([&]() { decompress.function(src.buffer, dst.buffer); }, m_overhead);
+                        if (cycles < fastestCycles && isEqual(dst.buffer, original, BenchSize))
+                        {
+                            fastest = decompress.name;
+                            fastestCycles = cycles;
+                        }
+                    }
+                    Memory::memset32(dst.buffer, 0, BenchSize / 4);
+                    uint32_t size = 0;
+                    const uint32_t cycles = Debug::measureCycles([&]() { size = Compression::decode(src.buffer, dst.buffer); }, m_overhead);
+                    printResult("decode", src.name, dst.name, BenchSize, cycles, size == BenchSize && isEqual(dst.buffer, original, BenchSize));
+                    const auto kind = Compression::destKindOf(dst.buffer);
+                    Debug::printf("# fastest,%x,%s,%s,%s,%s", static_cast<int32_t>(type), src.name, dst.name, fastest, Compression::decoderName(src.buffer, kind));
+                }
+            }
+            Memory::free(compressedIWRAM);
+        }
+        // free all memory again
+        Memory::free(compressed);
+        Memory::free(original);
+        for (uint32_t s = 1; s < 3; ++s)
+        {
+            Memory::free(sources[s].buffer);
+        }
+        Memory::free(destinations[0].buffer);
+        Memory::free(destinations[1].buffer);
+    }
+
+} // namespace Test
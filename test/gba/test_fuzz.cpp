@@ -0,0 +1,275 @@
+#include <compression/adpcm.h>
+#include <compression/adpcm_structs.h>
+#include <compression/adpcm_tables.h>
+#include <compression/lz4.h>
+#include <compression/lz4stream.h>
+#include <compression/rans.h>
+#include <memory/memory.h>
+#include <print/bench.h>
+#include <print/output.h>
+#include <print/print.h>
+
+#include "../../tools/fuzzpack/fuzzvectors.h"
+
+// Generated by gba_add_fuzz_vectors() in CMakeLists.txt
+#include "fuzz.h"
+
+// disable GCC warnings for using char * here...
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+
+// Decoder fuzz test. Runs every decoder on the vectors from tools/fuzzpack and compares the output to the reference
+// output and, for ADPCM, the dither state afterwards to the one in the reference. Outputs CSV lines over the mGBA debug channel:
+// decoder,case,kind,bytes,cycles,ok
+// followed by one summary line per decoder:
+// # summary,decoder,cases,mismatches,bytes,cycles
+namespace Test
+{
+
+    constexpr uint32_t FuzzStreamChunkSize = 97;
+    constexpr uint32_t FuzzAdpcmHeaderSize = sizeof(Audio::AdpcmFrameHeader);
+
+    const char *const FuzzKindNames[Fuzz::NrOfCaseKinds] = {"random", "overlapping_match", "literal_run", "extreme_length", "far_match", "tiny", "saturate", "index_limits", "tone"};
+
+    uint32_t *m_fuzzTables = nullptr;
+
+    // All decoders have the same signature, so they can be run from one table. dataSize is only used by ADPCM, dstRight only by stereo ADPCM
+    using FuzzFunction = void (*)(const uint32_t *data, uint32_t dataSize, uint32_t *dst, uint32_t *dstRight);
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+    void fuzzLZ4(const uint32_t *data, uint32_t dataSize, uint32_t *dst, uint32_t *dstRight) { Compression::LZ4UnCompWrite8bit(data, dst); }
+    void fuzzLZ4_ASM(const uint32_t *data, uint32_t dataSize, uint32_t *dst, uint32_t *dstRight) { Compression::LZ4UnCompWrite8bit_ASM(data, dst); }
+    void fuzzLZ4_16(const uint32_t *data, uint32_t dataSize, uint32_t *dst, uint32_t *dstRight) { Compression::LZ4UnCompWrite16bit_ASM(data, dst); }
+    void fuzzLZ4_DMA(const uint32_t *data, uint32_t dataSize, uint32_t *dst, uint32_t *dstRight) { Compression::LZ4UnCompWriteDMA(data, dst); }
+    void fuzzLZ4Stream(const uint32_t *data, uint32_t dataSize, uint32_t *dst, uint32_t *dstRight)
+    {
+        // odd chunk size, so decoding stops in the middle of literal runs, matches and length bytes
+        Compression::LZ4StreamState state;
+        Compression::LZ4StreamInit(state, data, dst);
+        while (!Compression::LZ4StreamDone(state))
+        {
+            Compression::LZ4StreamDecode(state, FuzzStreamChunkSize);
+        }
+    }
+    void fuzzLZ4Stream_ASM(const uint32_t *data, uint32_t dataSize, uint32_t *dst, uint32_t *dstRight)
+    {
+        Compression::LZ4StreamState state;
+        Compression::LZ4StreamInit(state, data, dst);
+        while (!Compression::LZ4StreamDone(state))
+        {
+            Compression::LZ4StreamDecode_ASM(state, FuzzStreamChunkSize);
+        }
+    }
+    void fuzzRANS(const uint32_t *data, uint32_t dataSize, uint32_t *dst, uint32_t *dstRight) { Compression::RANSUnCompWrite8bit(data, dst, m_fuzzTables); }
+    void fuzzRANS_ASM(const uint32_t *data, uint32_t dataSize, uint32_t *dst, uint32_t *dstRight) { Compression::RANSUnCompWrite8bit_ASM(data, dst, m_fuzzTables); }
+    void fuzzRANSIWRAM(const uint32_t *data, uint32_t dataSize, uint32_t *dst, uint32_t *dstRight) { Compression::RANSUnCompWrite8bitIWRAM(data, dst); }
+    void fuzzAdpcm(const uint32_t *data, uint32_t dataSize, uint32_t *dst, uint32_t *dstRight) { Adpcm::UnCompWrite32bit_8bit(data, dataSize, dst); }
+    void fuzzAdpcm_ASM(const uint32_t *data, uint32_t dataSize, uint32_t *dst, uint32_t *dstRight) { Adpcm_UnCompWrite32bit_8bit(data, dataSize, dst); }
+#pragma GCC diagnostic pop
+    void fuzzAdpcmStereo(const uint32_t *data, uint32_t dataSize, uint32_t *dst, uint32_t *dstRight) { Adpcm::UnCompWriteStereo32bit_8bit(data, dataSize, dst, dstRight); }
+    void fuzzAdpcmStereo_ASM(const uint32_t *data, uint32_t dataSize, uint32_t *dst, uint32_t *dstRight) { Adpcm_UnCompWriteStereo32bit_8bit(data, dataSize, dst, dstRight); }
+
+    struct FuzzDecoder
+    {
+        const char *name;
+        Fuzz::CaseType type;
+        FuzzFunction function;
+    };
+
+    // For ADPCM the first decoder of a type is the reference for the others
+    const FuzzDecoder FuzzDecoders[] = {
+        {"LZ4UnCompWrite8bit", Fuzz::CaseType::LZ4, fuzzLZ4},
+        {"LZ4UnCompWrite8bit_ASM", Fuzz::CaseType::LZ4, fuzzLZ4_ASM},
+        {"LZ4UnCompWrite16bit_ASM", Fuzz::CaseType::LZ4, fuzzLZ4_16},
+        {"LZ4UnCompWriteDMA", Fuzz::CaseType::LZ4, fuzzLZ4_DMA},
+        {"LZ4StreamDecode", Fuzz::CaseType::LZ4, fuzzLZ4Stream},
+        {"LZ4StreamDecode_ASM", Fuzz::CaseType::LZ4, fuzzLZ4Stream_ASM},
+        {"RANSUnCompWrite8bit", Fuzz::CaseType::RANS, fuzzRANS},
+        {"RANSUnCompWrite8bit_ASM", Fuzz::CaseType::RANS, fuzzRANS_ASM},
+        {"RANSUnCompWrite8bitIWRAM", Fuzz::CaseType::RANS, fuzzRANSIWRAM},
+        {"RANSUnCompWrite8bitIWRAM", Fuzz::CaseType::RANSLZ4, fuzzRANSIWRAM},
+        {"Adpcm::UnCompWrite32bit_8bit", Fuzz::CaseType::AdpcmMono, fuzzAdpcm},
+        {"Adpcm_UnCompWrite32bit_8bit", Fuzz::CaseType::AdpcmMono, fuzzAdpcm_ASM},
+        {"Adpcm::UnCompWrite32bit_8bit (planar)", Fuzz::CaseType::AdpcmPlanar, fuzzAdpcm},
+        {"Adpcm_UnCompWrite32bit_8bit (planar)", Fuzz::CaseType::AdpcmPlanar, fuzzAdpcm_ASM},
+        {"Adpcm::UnCompWriteStereo32bit_8bit", Fuzz::CaseType::AdpcmStereo, fuzzAdpcmStereo},
+        {"Adpcm_UnCompWriteStereo32bit_8bit", Fuzz::CaseType::AdpcmStereo, fuzzAdpcmStereo_ASM}};
+
+    constexpr uint32_t NrOfFuzzDecoders = sizeof(FuzzDecoders) / sizeof(FuzzDecoders[0]);
+
+    struct FuzzStats
+    {
+        uint32_t cases;
+        uint32_t mismatches;
+        uint32_t bytes;
+        uint32_t cycles;
+    };
+
+    // Case from vector file
+    struct FuzzCase
+    {
+        const Fuzz::CaseHeader *header;
+        const uint32_t *input;
+        const uint8_t *reference;
+    };
+
+    FuzzCase nextFuzzCase(const uint8_t *&current)
+    {
+        FuzzCase result;
+        result.header = reinterpret_cast<const Fuzz::CaseHeader *>(current);
+        result.input = reinterpret_cast<const uint32_t *>(result.header + 1);
+        result.reference = reinterpret_cast<const uint8_t *>(result.input) + ((result.header->inputSize + 3) & ~3);
+        current = result.reference + ((result.header->referenceSize + 3) & ~3);
+        return result;
+    }
+
+    bool isAdpcm(Fuzz::CaseType type)
+    {
+        return type == Fuzz::CaseType::AdpcmMono || type == Fuzz::CaseType::AdpcmStereo || type == Fuzz::CaseType::AdpcmPlanar;
+    }
+
+    // Number of channels in ADPCM frame
+    uint32_t fuzzAdpcmChannels(Fuzz::CaseType type)
+    {
+        return type == Fuzz::CaseType::AdpcmStereo || type == Fuzz::CaseType::AdpcmPlanar ? 2 : 1;
+    }
+
+    // Size of decoded data per output buffer. Planar stereo decodes to one buffer with the right channel at the next word boundary
+    uint32_t fuzzOutputSize(const FuzzCase &c)
+    {
+        if (isAdpcm(c.header->type))
+        {
+            const uint32_t channelSize = 2 * (c.header->inputSize / fuzzAdpcmChannels(c.header->type) - 4);
+            return c.header->type == Fuzz::CaseType::AdpcmPlanar ? ((channelSize + 3) & ~3) + channelSize : channelSize;
+        }
+        return c.header->referenceSize;
+    }
+
+    // Compare decoded data to reference. The decoders may write whole words, but nothing after that
+    bool isFuzzEqual(const uint8_t *data, const uint8_t *reference, uint32_t size, uint32_t &mismatch)
+    {
+        for (mismatch = 0; mismatch < size; ++mismatch)
+        {
+            if (data[mismatch] != reference[mismatch])
+            {
+                return false;
+            }
+        }
+        return *reinterpret_cast<const uint32_t *>(data + ((size + 3) & ~3)) == Fuzz::OutputGuard;
+    }
+
+    void fuzz()
+    {
+        printf("Decoder fuzz tests...\n");
+        Memory::init();
+        auto header = reinterpret_cast<const Fuzz::VectorHeader *>(fuzz_vectors);
+        bool ok = header->magic == Fuzz::VectorMagic;
+        // find buffer sizes
+        uint32_t maxOutputSize = 0;
+        uint32_t maxAdpcmOutputSize = 0;
+        uint32_t maxAdpcmInputSize = 0;
+        auto current = reinterpret_cast<const uint8_t *>(header + 1);
+        for (uint32_t i = 0; ok && i < header->nrOfCases; ++i)
+        {
+            const auto c = nextFuzzCase(current);
+            const uint32_t size = fuzzOutputSize(c);
+            maxOutputSize = size > maxOutputSize ? size : maxOutputSize;
+            if (isAdpcm(c.header->type))
+            {
+                maxAdpcmOutputSize = size > maxAdpcmOutputSize ? size : maxAdpcmOutputSize;
+                maxAdpcmInputSize = c.header->inputSize > maxAdpcmInputSize ? c.header->inputSize : maxAdpcmInputSize;
+            }
+        }
+        // output buffer plus guard word. the right channel buffer is only needed for ADPCM, which decodes to much less
+        // data. ADPCM frames get a frame header, so they are built in EWRAM
+        const uint32_t bufferWords = maxOutputSize / 4 + 2;
+        const uint32_t adpcmWords = maxAdpcmOutputSize / 4 + 2;
+        auto buffer = Memory::malloc_EWRAM<uint32_t>(bufferWords);
+        auto rightBuffer = Memory::malloc_EWRAM<uint32_t>(adpcmWords);
+        auto frame = Memory::malloc_EWRAM<uint32_t>((FuzzAdpcmHeaderSize + maxAdpcmInputSize + 3) / 4);
+        m_fuzzTables = Memory::malloc_IWRAM<uint32_t>(Compression::RANSTableSize / 4);
+        uint32_t *const dst[2] = {buffer, rightBuffer};
+        ok = ok && buffer != nullptr && rightBuffer != nullptr && frame != nullptr && m_fuzzTables != nullptr;
+        FuzzStats stats[NrOfFuzzDecoders] = {};
+        Debug::printf("# seed=%d cases=%d", header->seed, header->nrOfCases);
+        Debug::printf("decoder,case,kind,bytes,cycles,ok");
+        current = reinterpret_cast<const uint8_t *>(header + 1);
+        for (uint32_t i = 0; ok && i < header->nrOfCases; ++i)
+        {
+            const auto c = nextFuzzCase(current);
+            const auto type = c.header->type;
+            const uint32_t size = fuzzOutputSize(c);
+            // lockstep stereo decodes to separate left and right buffers
+            const uint32_t nrOfOutputs = type == Fuzz::CaseType::AdpcmStereo ? 2 : 1;
+            const uint32_t *input = c.input;
+            uint32_t inputSize = c.header->inputSize;
+            const uint8_t *expected[2] = {c.reference, nullptr};
+            const uint32_t *expectedDither = nullptr;
+            uint32_t ditherState[2] = {0, 0};
+            if (isAdpcm(type))
+            {
+                // reference holds the output buffers padded to 4 bytes, then the dither state after decoding
+                const uint32_t paddedSize = (size + 3) & ~3;
+                expected[1] = c.reference + paddedSize;
+                expectedDither = reinterpret_cast<const uint32_t *>(c.reference + nrOfOutputs * paddedSize);
+                Fuzz::getAdpcmDitherState(i, ditherState);
+                ok = c.header->referenceSize == nrOfOutputs * paddedSize + 2 * sizeof(uint32_t);
+                if (!ok)
+                {
+                    printf("Case %d has a reference of %d bytes. Regenerate the vectors\n", i, c.header->referenceSize);
+                    break;
+                }
+                // put ADPCM frame header in front of the channel blocks, 16 bits per sample
+                Memory::memset32(frame, 0, FuzzAdpcmHeaderSize / 4);
+                *reinterpret_cast<uint16_t *>(frame) = (fuzzAdpcmChannels(type) << 5) | (16 << 7);
+                Memory::memcpy32(frame + FuzzAdpcmHeaderSize / 4, c.input, (inputSize + 3) / 4);
+                input = frame;
+                inputSize += FuzzAdpcmHeaderSize;
+            }
+            for (uint32_t d = 0; d < NrOfFuzzDecoders; ++d)
+            {
+                const auto &decoder = FuzzDecoders[d];
+                if (decoder.type != type)
+                {
+                    continue;
+                }
+                // same dither state fuzzpack computed the reference with
+                ADPCM_DitherState[0] = ditherState[0];
+                ADPCM_DitherState[1] = ditherState[1];
+                Memory::memset32(dst[0], Fuzz::OutputGuard, bufferWords);
+                Memory::memset32(dst[1], Fuzz::OutputGuard, adpcmWords);
+                const uint32_t cycles = Debug::measureCycles([&]()
+                                                             { decoder.function(input, inputSize, dst[0], dst[1]); });
+                bool decoderOk = true;
+                uint32_t mismatch = 0;
+                for (uint32_t channel = 0; decoderOk && channel < nrOfOutputs; ++channel)
+                {
+                    decoderOk = isFuzzEqual(reinterpret_cast<const uint8_t *>(dst[channel]), expected[channel], size, mismatch);
+                }
+                decoderOk = decoderOk && (expectedDither == nullptr || (ADPCM_DitherState[0] == expectedDither[0] && ADPCM_DitherState[1] == expectedDither[1]));
+                stats[d].cases++;
+                stats[d].mismatches += decoderOk ? 0 : 1;
+                stats[d].bytes += nrOfOutputs * size;
+                stats[d].cycles += cycles;
+                Debug::printf("%s,%d,%s,%d,%d,%d", decoder.name, i, FuzzKindNames[static_cast<uint32_t>(c.header->kind)], nrOfOutputs * size, cycles, decoderOk ? 1 : 0);
+                if (!decoderOk)
+                {
+                    printf("%s case %d (%s) differs at %d\n", decoder.name, i, FuzzKindNames[static_cast<uint32_t>(c.header->kind)], mismatch);
+                }
+            }
+        }
+        for (uint32_t d = 0; d < NrOfFuzzDecoders; ++d)
+        {
+            const auto &s = stats[d];
+            Debug::printf("# summary,%s,%d,%d,%d,%d", FuzzDecoders[d].name, s.cases, s.mismatches, s.bytes, s.cycles);
+            printf("%s: %d/%d ok\n", FuzzDecoders[d].name, s.cases - s.mismatches, s.cases);
+            ok = ok && s.mismatches == 0;
+        }
+        Memory::free(m_fuzzTables);
+        Memory::free(frame);
+        Memory::free(rightBuffer);
+        Memory::free(buffer);
+        printf("Results: %s\n", ok ? "ok" : "FAILED");
+    }
+
+} // namespace Test
@@ -59,6 +59,40 @@ namespace Test
         malloc_and_free(malloc_IWRAM, BlockOrder2, BlockOrder1);
         malloc_and_free(malloc_IWRAM, BlockOrder2, BlockOrder2);
         printf("done\n");
+        printf("Testing relocatable memory...");
+        Memory::init();
+        Handle handles[NR_OF_BLOCKS];
+        for (int i = 0; i < NR_OF_BLOCKS; ++i)
+        {
+            handles[i] = malloc_Handle(TestBlocks[i].size);
+            auto data = lock<uint8_t>(handles[i]);
+            for (uint32_t j = 0; j < TestBlocks[i].size; ++j)
+            {
+                data[j] = i;
+            }
+            unlock(handles[i]);
+        }
+        freeHandle(handles[0]);
+        freeHandle(handles[2]);
+        const auto nrOfMovedBlocks = compact();
+        bool ok = nrOfMovedBlocks > 0;
+        for (int i = 0; i < NR_OF_BLOCKS; ++i)
+        {
+            auto data = lock<uint8_t>(handles[i]);
+            if (i == 0 || i == 2)
+            {
+                ok = ok && data == nullptr;
+                continue;
+            }
+            for (uint32_t j = 0; j < TestBlocks[i].size; ++j)
+            {
+                ok = ok && data[j] == i;
+            }
+            unlock(handles[i]);
+            freeHandle(handles[i]);
+        }
+        printf("%s\n", ok ? "done" : "FAILED");
+        printf("Stack used: %d of %d bytes, overflow: %s\n", stackHighWatermark(), StackSize, stackOverflowed() ? "YES" : "no");
     }
 
 } // namespace Test
\ No newline at end of file
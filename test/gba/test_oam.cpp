@@ -0,0 +1,164 @@
+#include <affineslots.h>
+#include <memory/memory.h>
+#include <print/bench.h>
+#include <print/print.h>
+#include <sprites.h>
+
+//disable GCC warnings for using char * here...
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+
+namespace Test
+{
+
+    // Write sprite positions directly to OAM like the setters did before shadow OAM
+    NOINLINE void setPositionsDirect(const int16_t *positions, uint32_t count)
+    {
+        auto oam = reinterpret_cast<volatile uint16_t *>(OAM);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            oam[i * 4] = (oam[i * 4] & 0xFF00) | (positions[i * 2 + 1] & 0xFF);
+            oam[i * 4 + 1] = (oam[i * 4 + 1] & 0xFE00) | (positions[i * 2] & 0x1FF);
+        }
+    }
+
+    NOINLINE void setPositionsShadow(const int16_t *positions, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            Sprites::setPositionOAM(i, positions[i * 2], positions[i * 2 + 1]);
+        }
+    }
+
+    bool compareOAMPositions(const int16_t *positions, uint32_t count)
+    {
+        auto oam = reinterpret_cast<const volatile uint16_t *>(OAM);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if ((oam[i * 4] & 0xFF) != (positions[i * 2 + 1] & 0xFF) || (oam[i * 4 + 1] & 0x1FF) != (positions[i * 2] & 0x1FF))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // One matrix per sprite group, assigned by hand. Trig for every group every frame
+    NOINLINE void setMatricesDirect(Sprites::Sprite2D *sprites, uint32_t count, int32_t frame)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            auto &sprite = sprites[i];
+            sprite.matrixIndex = i & 31;
+            sprite.matrix = Sprites::calculateAffineData(Math::fp1616_t::fromRaw((frame + (i & 7)) * 0x1000));
+            Sprites::setMatrixOAM(sprite);
+        }
+    }
+
+    // Matrices shared through slot manager
+    NOINLINE void setMatricesSlots(Sprites::Sprite2D *sprites, uint32_t count, int32_t frame)
+    {
+        Sprites::beginAffineFrame();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            Sprites::assignAffineSlot(sprites[i], Math::fp1616_t::fromRaw((frame + (i & 7)) * 0x1000));
+        }
+        Sprites::uploadAffineSlots();
+    }
+
+    // Check matrix of slot in OAM. The matrix is interleaved with the attributes of 4 consecutive entries
+    bool compareOAMMatrix(uint32_t slot, const Sprites::AffineData &matrix)
+    {
+        auto oam = reinterpret_cast<const volatile int16_t *>(OAM) + slot * 16;
+        return oam[3] == matrix.dx && oam[7] == matrix.dmx && oam[11] == matrix.dy && oam[15] == matrix.dmy;
+    }
+
+    void oam()
+    {
+        printf("Shadow OAM tests...\n");
+        Memory::init();
+        constexpr uint32_t count = 128;
+        auto positions = Memory::malloc_EWRAM<int16_t>(count * 2);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            positions[i * 2] = (i * 37) % 240;
+            positions[i * 2 + 1] = (i * 13) % 160;
+        }
+        Sprites::clearOAM();
+        Sprites::uploadAllOAM();
+        // timer 2 counts in 256 cycle steps. Measure 16 frames worth of updates
+        Debug::startTimer();
+        for (uint32_t f = 0; f < 16; ++f)
+        {
+            setPositionsDirect(positions, count);
+        }
+        const auto ticksDirect = Debug::endTimer();
+        const bool directOk = compareOAMPositions(positions, count);
+        Sprites::clearOAM();
+        Sprites::uploadAllOAM();
+        Debug::startTimer();
+        for (uint32_t f = 0; f < 16; ++f)
+        {
+            setPositionsShadow(positions, count);
+            Sprites::uploadOAM();
+        }
+        const auto ticksShadow = Debug::endTimer();
+        const bool shadowOk = compareOAMPositions(positions, count);
+        // only a few sprites change
+        Debug::startTimer();
+        for (uint32_t f = 0; f < 16; ++f)
+        {
+            setPositionsShadow(positions + 64 * 2, 8);
+            Sprites::uploadOAM();
+        }
+        const auto ticksFew = Debug::endTimer();
+        Debug::startTimer();
+        for (uint32_t f = 0; f < 16; ++f)
+        {
+            Sprites::uploadAllOAM();
+        }
+        const auto ticksAll = Debug::endTimer();
+        printf("128 sprites direct: %d x 256 cycles\n", ticksDirect);
+        printf("128 sprites shadow + upload: %d x 256 cycles\n", ticksShadow);
+        printf("8 sprites shadow + upload: %d x 256 cycles\n", ticksFew);
+        printf("Upload whole OAM: %d x 256 cycles\n", ticksAll);
+        printf("Results: %s\n", directOk && shadowOk && Sprites::dirtyOAMEntries() == 0 && Sprites::isUploadRegistered() ? "ok" : "FAILED");
+        Memory::free(positions);
+        // rotating swarm of 128 affine sprites with 8 different angles
+        printf("Affine slot tests...\n");
+        auto sprites = Memory::malloc_EWRAM<Sprites::Sprite2D>(count);
+        Sprites::clearAffineSlots();
+        Debug::startTimer();
+        for (uint32_t f = 0; f < 16; ++f)
+        {
+            setMatricesDirect(sprites, count, f & 3);
+            Sprites::uploadOAM();
+        }
+        const auto ticksMatrixDirect = Debug::endTimer();
+        Debug::startTimer();
+        for (uint32_t f = 0; f < 16; ++f)
+        {
+            setMatricesSlots(sprites, count, f & 3);
+            Sprites::uploadOAM();
+        }
+        const auto ticksMatrixSlots = Debug::endTimer();
+        bool slotsOk = Sprites::usedAffineSlots() == 8;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            slotsOk = slotsOk && sprites[i].matrixIndex == sprites[i & 7].matrixIndex;
+        }
+        printf("128 matrices direct: %d x 256 cycles\n", ticksMatrixDirect);
+        printf("128 matrices slots: %d x 256 cycles\n", ticksMatrixSlots);
+        printf("Slots used: %d, results: %s\n", Sprites::usedAffineSlots(), slotsOk ? "ok" : "FAILED");
+        // clearing OAM zeroes the matrices, so acquiring the same matrix again must upload it again
+        Sprites::clearOAM();
+        Sprites::beginAffineFrame();
+        auto &sprite = sprites[0];
+        bool clearOk = Sprites::assignAffineSlot(sprite, Math::fp1616_t::fromRaw(3 * 0x1000));
+        Sprites::uploadAffineSlots();
+        Sprites::uploadOAM();
+        clearOk = clearOk && sprite.matrix.dx != 0 && compareOAMMatrix(sprite.matrixIndex, sprite.matrix);
+        printf("Matrix after clearOAM(): %s\n", clearOk ? "ok" : "FAILED");
+        Memory::free(sprites);
+    }
+
+} // namespace Test
@@ -0,0 +1,78 @@
+#include <memory/memory.h>
+#include <memory/overlay.h>
+#include <print/bench.h>
+#include <print/print.h>
+
+//disable GCC warnings for using char * here...
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+
+namespace Test
+{
+
+    // Sample inner loop: fixed-point multiply-accumulate like in a vertex transform or mixer
+    FORCEINLINE uint32_t multiplyAccumulate(const int32_t *a, const int32_t *b, uint32_t count)
+    {
+        int32_t result = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            result += (a[i] * b[i]) >> 8;
+        }
+        return result;
+    }
+
+    NOINLINE uint32_t multiplyAccumulateROM(const int32_t *a, const int32_t *b, uint32_t count)
+    {
+        return multiplyAccumulate(a, b, count);
+    }
+
+    ARM_CODE NOINLINE uint32_t multiplyAccumulateROMARM(const int32_t *a, const int32_t *b, uint32_t count)
+    {
+        return multiplyAccumulate(a, b, count);
+    }
+
+    IWRAM_OVERLAY_FUNC(0)
+    ARM_CODE uint32_t multiplyAccumulateOverlay(const int32_t *a, const int32_t *b, uint32_t count)
+    {
+        return multiplyAccumulate(a, b, count);
+    }
+
+    int32_t timeLoop(uint32_t (*loopFunc)(const int32_t *, const int32_t *, uint32_t), const int32_t *a, const int32_t *b, uint32_t count, uint32_t &result)
+    {
+        Debug::startTimer();
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            result = loopFunc(a, b, count);
+        }
+        return Debug::endTimer();
+    }
+
+    void overlay()
+    {
+        printf("IWRAM overlay tests...\n");
+        Memory::init();
+        constexpr uint32_t count = 1024;
+        auto a = Memory::malloc_EWRAM<int32_t>(count);
+        auto b = Memory::malloc_EWRAM<int32_t>(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            a[i] = i * 3;
+            b[i] = 1000 - i;
+        }
+        Memory::loadOverlay(0);
+        printf("Overlay 0: %d bytes, loaded: %s\n", Memory::overlaySize(0), Memory::currentOverlay() == 0 ? "ok" : "FAILED");
+        // timer 2 counts in 256 cycle steps
+        uint32_t resultROM = 0;
+        uint32_t resultROMARM = 0;
+        uint32_t resultOverlay = 0;
+        const auto ticksROM = timeLoop(multiplyAccumulateROM, a, b, count, resultROM);
+        const auto ticksROMARM = timeLoop(multiplyAccumulateROMARM, a, b, count, resultROMARM);
+        const auto ticksOverlay = timeLoop(multiplyAccumulateOverlay, a, b, count, resultOverlay);
+        printf("ROM Thumb: %d x 256 cycles\n", ticksROM);
+        printf("ROM ARM: %d x 256 cycles\n", ticksROMARM);
+        printf("IWRAM overlay ARM: %d x 256 cycles\n", ticksOverlay);
+        printf("Results: %s\n", resultROM == resultOverlay && resultROMARM == resultOverlay ? "ok" : "FAILED");
+        Memory::free(a);
+        Memory::free(b);
+    }
+
+} // namespace Test
@@ -0,0 +1,119 @@
+#include <assets.h>
+#include <compression/lz4.h>
+#include <compression/lz77.h>
+#include <compression/rans.h>
+#include <memory/memory.h>
+#include <print/bench.h>
+#include <print/output.h>
+#include <print/print.h>
+
+// Generated by gba_add_assets() in CMakeLists.txt
+#include "test_rans_assets.h"
+
+// disable GCC warnings for using char * here...
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+
+// Entropy coding benchmark. Compares the rANS decoders to the LZ77 and LZ4 decoders on the same sample data
+// and outputs CSV lines over the mGBA debug channel:
+// routine,sample,bytes,compressed_bytes,ratio,cycles,bytes_per_cycle,ok
+// All compressed data is decoded from EWRAM to EWRAM.
+namespace Test
+{
+
+    // From test_bandwidth.cpp
+    uint32_t compressLZ77(const uint8_t *src, uint32_t size, uint8_t *dst);
+    bool isEqual(const uint8_t *a, const uint8_t *b, uint32_t size);
+
+    struct EntropySample
+    {
+        const char *name;
+        uint32_t raw;     // Asset id of uncompressed data
+        uint32_t lz4;     // Asset id of LZ4 40h data
+        uint32_t rans;    // Asset id of rANS 50h data
+        uint32_t ransLz4; // Asset id of LZ4 + rANS 51h data
+    };
+
+    const EntropySample EntropySamples[] = {
+        {"test_bandwidth.cpp", test_rans_assets::bandwidth_raw, test_rans_assets::bandwidth_lz4, test_rans_assets::bandwidth_rans, test_rans_assets::bandwidth_lz4rans},
+        {"test_fp32.cpp", test_rans_assets::fp32_raw, test_rans_assets::fp32_lz4, test_rans_assets::fp32_rans, test_rans_assets::fp32_lz4rans}};
+
+    uint32_t *m_ransTables = nullptr;
+
+    void decodeLZ77(const uint32_t *src, uint32_t *dst) { Compression::LZ77UnCompWrite8bit_ASM(src, dst); }
+    void decodeRANS(const uint32_t *src, uint32_t *dst) { Compression::RANSUnCompWrite8bit(src, dst, m_ransTables); }
+    void decodeRANS_ASM(const uint32_t *src, uint32_t *dst) { Compression::RANSUnCompWrite8bit_ASM(src, dst, m_ransTables); }
+    void decodeRANSIWRAM(const uint32_t *src, uint32_t *dst) { Compression::RANSUnCompWrite8bitIWRAM(src, dst); }
+
+    struct EntropyDecoder
+    {
+        const char *name;
+        void (*function)(const uint32_t *, uint32_t *);
+        uint8_t type; // Type byte of data header
+    };
+
+    const EntropyDecoder EntropyDecoders[] = {
+        {"LZ77UnCompWrite8bit_ASM", decodeLZ77, 0x10},
+        {"LZ4UnCompWrite8bit_ASM", Compression::LZ4UnCompWrite8bit_ASM, 0x40},
+        {"RANSUnCompWrite8bit", decodeRANS, 0x50},
+        {"RANSUnCompWrite8bit_ASM", decodeRANS_ASM, 0x50},
+        {"RANSUnCompWrite8bitIWRAM", decodeRANSIWRAM, 0x51}};
+
+    // Copy compressed data for type to dst and return its size. LZ77 data is compressed here, the rest comes from the archive
+    uint32_t getEntropyData(const EntropySample &sample, uint8_t type, uint8_t *dst)
+    {
+        const auto raw = Assets::get<uint8_t>(sample.raw);
+        const uint32_t size = Assets::size(sample.raw);
+        if (type == 0x10)
+        {
+            return compressLZ77(raw, size, dst);
+        }
+        const uint32_t id = type == 0x40 ? sample.lz4 : (type == 0x50 ? sample.rans : sample.ransLz4);
+        const uint32_t storedSize = Assets::storedSize(id);
+        Memory::memcpy32(dst, Assets::getStored(id), storedSize / 4);
+        return storedSize;
+    }
+
+    void rans()
+    {
+        printf("Entropy coding benchmark...\n");
+        Memory::init();
+        bool ok = Assets::init(test_rans_assets_archive, 0);
+        m_ransTables = Memory::malloc_IWRAM<uint32_t>(Compression::RANSTableSize / 4);
+        const uint32_t overhead = Debug::measureCycles([]() {});
+        Debug::printf("# overhead=%d", overhead);
+        Debug::printf("routine,sample,bytes,compressed_bytes,ratio,cycles,bytes_per_cycle,ok");
+        for (const auto &sample : EntropySamples)
+        {
+            const auto raw = Assets::get<uint8_t>(sample.raw);
+            const uint32_t size = Assets::size(sample.raw);
+            // LZ77 can expand data by 1/8 plus flags and padding
+            auto compressed = Memory::malloc_EWRAM<uint8_t>(size + size / 8 + 16);
+            auto decompressed = Memory::malloc_EWRAM<uint8_t>((size + 3) & ~3);
+            ok = ok && raw != nullptr && compressed != nullptr && decompressed != nullptr && m_ransTables != nullptr;
+            if (!ok)
+            {
+                break;
+            }
+            for (const auto &decoder : EntropyDecoders)
+            {
+                const uint32_t compressedSize = getEntropyData(sample, decoder.type, compressed);
+                Memory::memset32(decompressed, 0, (size + 3) / 4);
+                const uint32_t cycles = Debug::measureCycles([&]()
+                                                             { decoder.function(reinterpret_cast<const uint32_t *>(compressed), reinterpret_cast<uint32_t *>(decompressed)); },
+                                                             overhead);
+                const bool decoderOk = isEqual(decompressed, raw, size);
+                // ratio and bytes / cycle as 16.16 fixed-point for %f
+                const int32_t ratio = static_cast<int32_t>((static_cast<uint64_t>(compressedSize) << 16) / size);
+                const int32_t bytesPerCycle = cycles > 0 ? static_cast<int32_t>((static_cast<uint64_t>(size) << 16) / cycles) : 0;
+                Debug::printf("%s,%s,%d,%d,%.3f,%d,%.3f,%d", decoder.name, sample.name, size, compressedSize, ratio, cycles, bytesPerCycle, decoderOk ? 1 : 0);
+                printf("%s %s: %d cycles\n", decoder.name, decoderOk ? "ok" : "FAILED", cycles);
+                ok = ok && decoderOk;
+            }
+            Memory::free(decompressed);
+            Memory::free(compressed);
+        }
+        Memory::free(m_ransTables);
+        printf("Results: %s\n", ok ? "ok" : "FAILED");
+    }
+
+} // namespace Test
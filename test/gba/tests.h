@@ -4,7 +4,14 @@ namespace Test
 {
 
 	void memory();
-    void copy();
+    void bandwidth();
+    void assets();
+    void rans();
+    void adpcm();
+    void fuzz();
+    void adpcmPlayer();
+    void overlay();
+    void oam();
     void math_fp32();
 
 }
\ No newline at end of file
@@ -5,5 +5,15 @@ int main()
 	// run tests on the PC
     Test::math_fp32();
     Test::math_vec();
+    Test::memory();
+    Test::tiles();
+    Test::palette();
+    Test::dmaqueue();
+    Test::lz4stream();
+    Test::lz4encoder();
+    Test::movie();
+    Test::rans();
+    Test::fuzz();
+    Test::adpcm();
     return 0;
 }
@@ -0,0 +1,170 @@
+#include <compression/adpcm.h>
+#include <compression/adpcm_structs.h>
+#include <compression/adpcm_tables.h>
+#include <sound/adpcmplayer.h>
+
+#include "../../tools/fuzzpack/adpcmencoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace Test
+{
+
+    // Channel blocks of 12 bytes: initial sample, step index, 8 bytes of nibbles. Decode to 16 samples each
+    const uint8_t AdpcmLeftBlock[] = {0xEF, 0x1F, 0x42, 0x00, 0x69, 0x42, 0x2C, 0xB1, 0xF3, 0x84, 0x23, 0x64};
+    const uint8_t AdpcmRightBlock[] = {0x2A, 0x17, 0x32, 0x00, 0x7E, 0xD8, 0x85, 0xCE, 0xF9, 0x03, 0x87, 0x82};
+    constexpr uint32_t AdpcmSamples = 16;
+    constexpr uint32_t AdpcmDither[2] = {0x5A, 0x12345678};
+
+    // Expected output for AdpcmDither, from an independent IMA ADPCM decoder with the same dither generator
+    const uint8_t AdpcmMonoExpected[AdpcmSamples] = {0x1F, 0x19, 0x31, 0x41, 0x5B, 0x3C, 0x51, 0x5C, 0x44, 0x59, 0x2E, 0x66, 0x5E, 0x7F, 0x7F, 0x7F};
+    constexpr uint32_t AdpcmMonoExpectedDither[2] = {0x1C, 0xACFDB5E8};
+    // Lockstep stereo uses one dither value per left / right sample pair, so the left channel matches mono
+    const uint8_t AdpcmStereoLeftExpected[AdpcmSamples] = {0x1F, 0x19, 0x31, 0x41, 0x5B, 0x3C, 0x51, 0x5C, 0x44, 0x59, 0x2E, 0x66, 0x5E, 0x7F, 0x7F, 0x7F};
+    const uint8_t AdpcmStereoRightExpected[AdpcmSamples] = {0x16, 0x11, 0x1D, 0x1B, 0x0B, 0x23, 0x20, 0xFA, 0xCC, 0xB9, 0x80, 0xD4, 0xDF, 0x74, 0x64, 0x7F};
+    constexpr uint32_t AdpcmStereoExpectedDither[2] = {0x1C, 0xACFDB5E8};
+
+    // Build frame from frame header and channel blocks
+    std::vector<uint32_t> adpcmFrame(const std::vector<std::vector<uint8_t>> &blocks)
+    {
+        const uint32_t nrOfChannels = blocks.size();
+        // 16 bits per sample
+        std::vector<uint32_t> frame(1, (nrOfChannels << 5) | (16 << 7));
+        uint32_t size = ADPCM_FRAMEHEADER_SIZE;
+        for (const auto &block : blocks)
+        {
+            frame.resize((size + block.size() + 3) / 4, 0);
+            memcpy(reinterpret_cast<uint8_t *>(frame.data()) + size, block.data(), block.size());
+            size += block.size();
+        }
+        return frame;
+    }
+
+    // Compare output to expected samples and check the guard byte after them
+    bool isAdpcmEqual(const std::vector<uint32_t> &output, const uint8_t *expected, uint32_t size)
+    {
+        auto output8 = reinterpret_cast<const uint8_t *>(output.data());
+        return std::equal(expected, expected + size, output8) && output8[size] == 0xEE;
+    }
+
+    // Encode a tone, decode the stream frame by frame and return the largest and average error in 8 bit units
+    bool checkAdpcmStream(uint32_t nrOfChannels, uint32_t &maxError, double &averageError)
+    {
+        constexpr uint32_t SampleRate = 16384;
+        constexpr uint32_t SamplesPerFrame = 256;
+        constexpr uint32_t NrOfSamples = 7 * SamplesPerFrame + 100;
+        std::vector<std::vector<int16_t>> channels(nrOfChannels, std::vector<int16_t>(NrOfSamples));
+        for (uint32_t channel = 0; channel < nrOfChannels; ++channel)
+        {
+            for (uint32_t i = 0; i < NrOfSamples; ++i)
+            {
+                channels[channel][i] = std::lround(12000 * std::sin(2 * M_PI * (440 + 220 * channel) * i / SampleRate));
+            }
+        }
+        const auto stream = Audio::AdpcmEncodeStream(channels, SampleRate, SamplesPerFrame);
+        AdpcmPlayer::StreamHeader header;
+        if (stream.size() < sizeof(header))
+        {
+            return false;
+        }
+        memcpy(&header, stream.data(), sizeof(header));
+        // the header must pass the consistency checks of AdpcmPlayer::play()
+        const uint32_t nrOfFrames = (NrOfSamples + SamplesPerFrame - 1) / SamplesPerFrame;
+        if (header.magic != AdpcmPlayer::StreamMagic || header.nrOfFrames != nrOfFrames || header.nrOfChannels != nrOfChannels ||
+            header.samplesPerFrame != SamplesPerFrame || header.frameSize != ADPCM_FRAMEHEADER_SIZE + nrOfChannels * (4 + SamplesPerFrame / 2) ||
+            (header.frameSize & 3) != 0 || stream.size() != sizeof(header) + nrOfFrames * header.frameSize)
+        {
+            return false;
+        }
+        ADPCM_DitherState[0] = 0;
+        ADPCM_DitherState[1] = 0;
+        maxError = 0;
+        uint64_t totalError = 0;
+        std::vector<uint32_t> frame(header.frameSize / 4);
+        std::vector<std::vector<uint32_t>> pcm(2, std::vector<uint32_t>(SamplesPerFrame / 4 + 1, 0xEEEEEEEE));
+        for (uint32_t f = 0; f < nrOfFrames; ++f)
+        {
+            memcpy(frame.data(), stream.data() + sizeof(header) + f * header.frameSize, header.frameSize);
+            if (nrOfChannels == 2)
+            {
+                Adpcm::UnCompWriteStereo32bit_8bit(frame.data(), header.frameSize, pcm[0].data(), pcm[1].data());
+            }
+            else
+            {
+                Adpcm::UnCompWrite32bit_8bit(frame.data(), header.frameSize, pcm[0].data());
+            }
+            for (uint32_t channel = 0; channel < nrOfChannels; ++channel)
+            {
+                auto pcm8 = reinterpret_cast<const int8_t *>(pcm[channel].data());
+                if (static_cast<uint8_t>(pcm8[SamplesPerFrame]) != 0xEE)
+                {
+                    return false;
+                }
+                for (uint32_t i = 0; i < SamplesPerFrame && f * SamplesPerFrame + i < NrOfSamples; ++i)
+                {
+                    const uint32_t error = std::abs(pcm8[i] - (channels[channel][f * SamplesPerFrame + i] >> 8));
+                    maxError = std::max(maxError, error);
+                    totalError += error;
+                }
+            }
+        }
+        averageError = static_cast<double>(totalError) / (NrOfSamples * nrOfChannels);
+        return true;
+    }
+
+    void adpcm()
+    {
+        printf("ADPCM decoder tests...\n");
+        const std::vector<uint8_t> left(std::begin(AdpcmLeftBlock), std::end(AdpcmLeftBlock));
+        const std::vector<uint8_t> right(std::begin(AdpcmRightBlock), std::end(AdpcmRightBlock));
+        // mono
+        auto frame = adpcmFrame({left});
+        std::vector<uint32_t> dstLeft(AdpcmSamples / 4 + 1, 0xEEEEEEEE);
+        std::vector<uint32_t> dstRight(AdpcmSamples / 4 + 1, 0xEEEEEEEE);
+        ADPCM_DitherState[0] = AdpcmDither[0];
+        ADPCM_DitherState[1] = AdpcmDither[1];
+        Adpcm::UnCompWrite32bit_8bit(frame.data(), ADPCM_FRAMEHEADER_SIZE + left.size(), dstLeft.data());
+        bool ok = isAdpcmEqual(dstLeft, AdpcmMonoExpected, AdpcmSamples);
+        ok = ok && ADPCM_DitherState[0] == AdpcmMonoExpectedDither[0] && ADPCM_DitherState[1] == AdpcmMonoExpectedDither[1];
+        printf("Mono frame: %s\n", ok ? "ok" : "FAILED");
+        // stereo in lockstep
+        frame = adpcmFrame({left, right});
+        std::fill(dstLeft.begin(), dstLeft.end(), 0xEEEEEEEE);
+        ADPCM_DitherState[0] = AdpcmDither[0];
+        ADPCM_DitherState[1] = AdpcmDither[1];
+        Adpcm::UnCompWriteStereo32bit_8bit(frame.data(), ADPCM_FRAMEHEADER_SIZE + left.size() + right.size(), dstLeft.data(), dstRight.data());
+        bool stereoOk = isAdpcmEqual(dstLeft, AdpcmStereoLeftExpected, AdpcmSamples) && isAdpcmEqual(dstRight, AdpcmStereoRightExpected, AdpcmSamples);
+        stereoOk = stereoOk && ADPCM_DitherState[0] == AdpcmStereoExpectedDither[0] && ADPCM_DitherState[1] == AdpcmStereoExpectedDither[1];
+        printf("Stereo frame: %s\n", stereoOk ? "ok" : "FAILED");
+        ok = ok && stereoOk;
+        // largest steps in one direction must saturate at the 16 bit limits
+        std::vector<uint8_t> up = {0xFF, 0x7F, 88, 0};
+        std::vector<uint8_t> down = {0x00, 0x80, 88, 0};
+        up.insert(up.end(), 8, 0x77);
+        down.insert(down.end(), 8, 0xFF);
+        frame = adpcmFrame({up, down});
+        std::fill(dstLeft.begin(), dstLeft.end(), 0xEEEEEEEE);
+        std::fill(dstRight.begin(), dstRight.end(), 0xEEEEEEEE);
+        Adpcm::UnCompWriteStereo32bit_8bit(frame.data(), ADPCM_FRAMEHEADER_SIZE + up.size() + down.size(), dstLeft.data(), dstRight.data());
+        const std::vector<uint8_t> maximum(AdpcmSamples, 0x7F);
+        const std::vector<uint8_t> minimum(AdpcmSamples, 0x80);
+        const bool saturateOk = isAdpcmEqual(dstLeft, maximum.data(), AdpcmSamples) && isAdpcmEqual(dstRight, minimum.data(), AdpcmSamples);
+        printf("Saturation: %s\n", saturateOk ? "ok" : "FAILED");
+        ok = ok && saturateOk;
+        // encoded streams must decode back to the source within dither and 8 bit truncation error, plus a bit of ADPCM error
+        for (uint32_t nrOfChannels = 1; nrOfChannels <= 2; ++nrOfChannels)
+        {
+            uint32_t maxError = 0;
+            double averageError = 0;
+            const bool streamOk = checkAdpcmStream(nrOfChannels, maxError, averageError) && maxError <= 4 && averageError < 1;
+            printf("Encoded %s stream: max. error %u, avg. error %.2f: %s\n", nrOfChannels == 1 ? "mono" : "stereo", maxError, averageError, streamOk ? "ok" : "FAILED");
+            ok = ok && streamOk;
+        }
+        printf("Results: %s\n", ok ? "ok" : "FAILED");
+    }
+
+}
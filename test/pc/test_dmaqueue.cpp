@@ -0,0 +1,59 @@
+#include <memory/dmaqueue.h>
+
+#include <cstdio>
+
+namespace Test
+{
+
+    void dmaqueue()
+    {
+        printf("DMA queue tests...\n");
+        static uint16_t source[4096];
+        static uint16_t destination[4096];
+        for (uint32_t i = 0; i < 4096; ++i)
+        {
+            source[i] = i;
+            destination[i] = 0;
+        }
+        DMA::clearQueue();
+        DMA::resetQueueStats();
+        DMA::setQueueBudget(1024);
+        // misaligned transfers are rejected
+        bool ok = !DMA::enqueue(reinterpret_cast<uint8_t *>(destination) + 1, source, 16);
+        ok = ok && !DMA::enqueue(destination, source, 15);
+        // high priority transfers go first, transfers larger than the budget are split.
+        // word-aligned transfers are split on word boundaries, so 1022 of 1024 bytes are used
+        ok = ok && DMA::enqueue(destination, source, 2048, DMA::Priority::Low);
+        ok = ok && DMA::enqueue(destination + 2048, source + 2048, 512, DMA::Priority::High);
+        ok = ok && DMA::enqueue(destination + 3000, source + 3000, 6);
+        auto stats = DMA::queueStats();
+        ok = ok && stats.depth == 3 && stats.pendingBytes == 2048 + 512 + 6;
+        DMA::processQueue();
+        stats = DMA::queueStats();
+        ok = ok && stats.lastBytes == 1022 && stats.depth == 1 && stats.deferred == 1;
+        ok = ok && destination[2048] == 2048 && destination[2303] == 2303 && destination[3002] == 3002;
+        ok = ok && destination[0] == 0 && destination[251] == 251 && destination[252] == 0;
+        DMA::processQueue();
+        DMA::processQueue();
+        stats = DMA::queueStats();
+        ok = ok && stats.depth == 0 && stats.pendingBytes == 0 && stats.deferred == 2;
+        for (uint32_t i = 0; i < 1024; ++i)
+        {
+            ok = ok && destination[i] == source[i];
+        }
+        printf("Priorities and budget: %s\n", ok ? "ok" : "FAILED");
+        // full queue drops transfers
+        uint32_t nrOfQueued = 0;
+        for (uint32_t i = 0; i < DMA::MaxQueuedTransfers + 8; ++i)
+        {
+            nrOfQueued += DMA::enqueue(destination + i * 4, source + i * 4, 8) ? 1 : 0;
+        }
+        stats = DMA::queueStats();
+        ok = nrOfQueued == DMA::MaxQueuedTransfers && stats.dropped == 8 && stats.maxDepth == DMA::MaxQueuedTransfers;
+        DMA::flushQueue();
+        ok = ok && DMA::queueStats().depth == 0;
+        printf("Dropped transfers and flush: %s\n", ok ? "ok" : "FAILED");
+        DMA::setQueueBudget(DMA::DefaultQueueBudget);
+    }
+
+} // namespace Test
@@ -0,0 +1,125 @@
+#include <compression/adpcm.h>
+#include <compression/adpcm_structs.h>
+#include <compression/adpcm_tables.h>
+#include <compression/lz4.h>
+#include <compression/lz4stream.h>
+#include <compression/rans.h>
+
+#include "../../tools/fuzzpack/fuzzgenerator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace Test
+{
+
+    // Decode ADPCM case number caseIndex into dst in the reference layout: output buffers padded to 4 bytes, then the dither state
+    void fuzzDecodeAdpcm(const Fuzz::CaseHeader *caseHeader, const uint32_t *input, uint32_t caseIndex, uint32_t *dst)
+    {
+        const uint32_t nrOfChannels = caseHeader->type == Fuzz::CaseType::AdpcmMono ? 1 : 2;
+        const uint32_t channelWords = (2 * (caseHeader->inputSize / nrOfChannels - 4) + 3) / 4;
+        std::vector<uint32_t> frame(1 + (caseHeader->inputSize + 3) / 4);
+        frame[0] = (nrOfChannels << 5) | (16 << 7);
+        memcpy(frame.data() + 1, input, caseHeader->inputSize);
+        const uint32_t frameSize = ADPCM_FRAMEHEADER_SIZE + caseHeader->inputSize;
+        Fuzz::getAdpcmDitherState(caseIndex, ADPCM_DitherState);
+        if (caseHeader->type == Fuzz::CaseType::AdpcmStereo)
+        {
+            Adpcm::UnCompWriteStereo32bit_8bit(frame.data(), frameSize, dst, dst + channelWords);
+        }
+        else
+        {
+            Adpcm::UnCompWrite32bit_8bit(frame.data(), frameSize, dst);
+        }
+        dst[nrOfChannels * channelWords] = ADPCM_DitherState[0];
+        dst[nrOfChannels * channelWords + 1] = ADPCM_DitherState[1];
+    }
+
+    // Decode case input with the C decoders available on PC. Returns false if the type has no PC decoder
+    bool fuzzDecode(const Fuzz::CaseHeader *caseHeader, const uint32_t *input, uint32_t caseIndex, uint32_t *dst, uint32_t streamChunkSize)
+    {
+        std::vector<uint32_t> tables(Compression::RANSTableSize / 4);
+        switch (caseHeader->type)
+        {
+        case Fuzz::CaseType::LZ4:
+            if (streamChunkSize > 0)
+            {
+                Compression::LZ4StreamState state;
+                Compression::LZ4StreamInit(state, input, dst);
+                while (!Compression::LZ4StreamDone(state))
+                {
+                    Compression::LZ4StreamDecode(state, streamChunkSize);
+                }
+            }
+            else
+            {
+                Compression::LZ4UnCompWrite8bit(input, dst);
+            }
+            return true;
+        case Fuzz::CaseType::RANS:
+            Compression::RANSUnCompWrite8bit(input, dst, tables.data());
+            return true;
+        case Fuzz::CaseType::RANSLZ4:
+        {
+            std::vector<uint32_t> lz4(Compression::RANSUnCompGetSize(input + 1) / 4 + 1);
+            Compression::RANSUnCompWrite8bit(input + 1, lz4.data(), tables.data());
+            Compression::LZ4UnCompWrite8bit(lz4.data(), dst);
+            return true;
+        }
+        case Fuzz::CaseType::AdpcmMono:
+        case Fuzz::CaseType::AdpcmStereo:
+        case Fuzz::CaseType::AdpcmPlanar:
+            fuzzDecodeAdpcm(caseHeader, input, caseIndex, dst);
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void fuzz()
+    {
+        printf("Decoder fuzz tests...\n");
+        // walk the vector file the same way Test::fuzz() in test/gba does
+        const auto bytes = Fuzz::writeVectors(Fuzz::generateCases(1, 32), 1);
+        std::vector<uint32_t> vectors(bytes.size() / 4);
+        std::copy(bytes.cbegin(), bytes.cend(), reinterpret_cast<uint8_t *>(vectors.data()));
+        auto header = reinterpret_cast<const Fuzz::VectorHeader *>(vectors.data());
+        bool ok = (bytes.size() & 3) == 0 && header->magic == Fuzz::VectorMagic && header->seed == 1;
+        auto current = reinterpret_cast<const uint8_t *>(header + 1);
+        uint32_t nrOfChecked = 0;
+        for (uint32_t i = 0; ok && i < header->nrOfCases; ++i)
+        {
+            auto caseHeader = reinterpret_cast<const Fuzz::CaseHeader *>(current);
+            auto input = reinterpret_cast<const uint32_t *>(caseHeader + 1);
+            auto reference = reinterpret_cast<const uint8_t *>(input) + ((caseHeader->inputSize + 3) & ~3);
+            current = reference + ((caseHeader->referenceSize + 3) & ~3);
+            // C decoder and streaming decoder with a chunk size that splits literals and matches everywhere
+            for (const uint32_t chunkSize : {0, 97})
+            {
+                std::vector<uint32_t> dst(caseHeader->referenceSize / 4 + 2, Fuzz::OutputGuard);
+                if (!fuzzDecode(caseHeader, input, i, dst.data(), chunkSize))
+                {
+                    break;
+                }
+                auto dst8 = reinterpret_cast<const uint8_t *>(dst.data());
+                const bool caseOk = std::equal(reference, reference + caseHeader->referenceSize, dst8) && dst8[caseHeader->referenceSize] == 0xEE;
+                if (!caseOk)
+                {
+                    printf("Case %u, type %x, kind %u, %u bytes: FAILED\n", i, static_cast<uint32_t>(caseHeader->type), static_cast<uint32_t>(caseHeader->kind), caseHeader->referenceSize);
+                }
+                ok = ok && caseOk;
+                nrOfChecked += chunkSize == 0 ? 1 : 0;
+                if (caseHeader->type != Fuzz::CaseType::LZ4)
+                {
+                    break;
+                }
+            }
+        }
+        ok = ok && current == reinterpret_cast<const uint8_t *>(vectors.data() + vectors.size());
+        printf("%u of %u cases checked, ADPCM streams only run on GBA\n", nrOfChecked, header->nrOfCases);
+        printf("Results: %s\n", ok ? "ok" : "FAILED");
+    }
+
+}
@@ -0,0 +1,114 @@
+#include <compression/lz4.h>
+#include <compression/lz4stream.h>
+
+#include "../../tools/lz4pack/lz4encoder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace Test
+{
+
+    // Decode with the C decoders and compare to the original data
+    bool lz4RoundTrip(const std::vector<uint8_t> &data, const std::vector<uint8_t> &compressed)
+    {
+        // decoders read words from 4-byte-aligned buffers
+        std::vector<uint32_t> src((compressed.size() + 3) / 4 + 1, 0);
+        std::copy(compressed.cbegin(), compressed.cend(), reinterpret_cast<uint8_t *>(src.data()));
+        std::vector<uint32_t> dst(data.size() / 4 + 2, 0xEEEEEEEE);
+        Compression::LZ4UnCompWrite8bit(src.data(), dst.data());
+        bool ok = Compression::LZ4UnCompGetSize(src.data()) == data.size() && std::equal(data.cbegin(), data.cend(), reinterpret_cast<const uint8_t *>(dst.data()));
+        // check that nothing was written past the end
+        ok = ok && reinterpret_cast<const uint8_t *>(dst.data())[data.size()] == 0xEE;
+        std::vector<uint32_t> streamed(data.size() / 4 + 2, 0xEEEEEEEE);
+        Compression::LZ4StreamState state;
+        ok = ok && Compression::LZ4StreamInit(state, src.data(), streamed.data());
+        while (ok && !Compression::LZ4StreamDone(state))
+        {
+            Compression::LZ4StreamDecode(state, 777);
+        }
+        return ok && memcmp(streamed.data(), dst.data(), dst.size() * 4) == 0;
+    }
+
+    void lz4encoder()
+    {
+        printf("LZ4 encoder tests...\n");
+        std::vector<std::pair<const char *, std::vector<uint8_t>>> inputs;
+        uint32_t seed = 0x1234567;
+        auto random = [&seed]()
+        {
+            seed = seed * 1664525 + 1013904223;
+            return seed >> 24;
+        };
+        inputs.push_back({"empty", {}});
+        inputs.push_back({"1 byte", {42}});
+        inputs.push_back({"7 bytes", {1, 1, 1, 1, 1, 1, 1}});
+        inputs.push_back({"zeros", std::vector<uint8_t>(100000, 0)});
+        std::vector<uint8_t> noise(5000);
+        for (auto &v : noise)
+        {
+            v = random();
+        }
+        inputs.push_back({"noise", noise});
+        // tile-like data with flat areas, repeated patterns, some noise and far repeats
+        std::vector<uint8_t> image(76800);
+        for (uint32_t i = 0; i < image.size(); ++i)
+        {
+            const uint32_t x = i % 240;
+            const uint32_t y = i / 240;
+            image[i] = ((x >> 3) ^ (y >> 2)) * 17 + (random() < 8 ? random() : 0);
+        }
+        inputs.push_back({"image", image});
+        std::vector<uint8_t> text;
+        const char *words[] = {"the ", "quick ", "brown ", "fox ", "jumps ", "over ", "lazy ", "dog ", "\n"};
+        while (text.size() < 20000)
+        {
+            const char *word = words[random() % 9];
+            text.insert(text.end(), word, word + strlen(word));
+        }
+        inputs.push_back({"text", text});
+        // round-trips for different speed weights and candidate counts
+        const double speedWeights[] = {0, 0.05, 0.2, 1};
+        bool allOk = true;
+        for (const auto &input : inputs)
+        {
+            bool ok = true;
+            for (const auto weight : speedWeights)
+            {
+                Compression::LZ4EncodeOptions options;
+                options.speedWeight = weight;
+                const auto compressed = Compression::LZ4Compress(input.second, options);
+                ok = ok && (compressed.size() & 3) == 0 && lz4RoundTrip(input.second, compressed);
+            }
+            Compression::LZ4EncodeOptions fast;
+            fast.maxCandidates = 4;
+            ok = ok && lz4RoundTrip(input.second, Compression::LZ4Compress(input.second, fast));
+            printf("Round-trip %s (%u bytes): %s\n", input.first, static_cast<uint32_t>(input.second.size()), ok ? "ok" : "FAILED");
+            allOk = allOk && ok;
+        }
+        // all-zero data must compress to almost nothing
+        const auto zeros = Compression::LZ4Compress(inputs[3].second);
+        printf("Zeros compressed to %u bytes: %s\n", static_cast<uint32_t>(zeros.size()), zeros.size() < 420 ? "ok" : "FAILED");
+        // report size vs. estimated decode cycles
+        printf("Size vs. estimated LZ4UnCompWrite8bit_ASM cycles:\n");
+        for (const auto &input : inputs)
+        {
+            if (input.second.size() < 1000)
+            {
+                continue;
+            }
+            for (const auto weight : speedWeights)
+            {
+                Compression::LZ4EncodeOptions options;
+                options.speedWeight = weight;
+                const auto compressed = Compression::LZ4Compress(input.second, options);
+                const double cycles = Compression::LZ4EstimateDecodeCycles(compressed);
+                printf("  %s, speed weight %.2f: %u bytes, %.0f cycles, %.2f cycles/byte\n", input.first, weight, static_cast<uint32_t>(compressed.size()), cycles, cycles / input.second.size());
+            }
+        }
+        printf("LZ4 encoder: %s\n", allOk ? "ok" : "FAILED");
+    }
+
+} // namespace Test
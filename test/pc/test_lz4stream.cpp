@@ -0,0 +1,152 @@
+#include <compression/lz4.h>
+#include <compression/lz4stream.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace Test
+{
+
+    // Greedy LZ4 40h compression of data to dst. Returns compressed size
+    uint32_t compressLZ4Greedy(const uint8_t *src, uint32_t size, uint8_t *dst)
+    {
+        auto writeLength = [](uint8_t *out, uint32_t length)
+        {
+            for (length -= 15; length >= 255; length -= 255)
+            {
+                *out++ = 255;
+            }
+            *out++ = length;
+            return out;
+        };
+        auto writeSequence = [&](uint8_t *out, const uint8_t *literals, uint32_t literalLength, uint32_t distance, uint32_t matchLength)
+        {
+            const uint32_t matchCode = matchLength > 0 ? matchLength - 3 : 0;
+            *out++ = ((literalLength < 15 ? literalLength : 15) << 4) | (matchCode < 15 ? matchCode : 15);
+            out = literalLength >= 15 ? writeLength(out, literalLength) : out;
+            for (uint32_t i = 0; i < literalLength; ++i)
+            {
+                *out++ = literals[i];
+            }
+            if (matchLength > 0)
+            {
+                *out++ = distance >> 8;
+                *out++ = distance & 0xFF;
+                out = matchCode >= 15 ? writeLength(out, matchCode) : out;
+            }
+            return out;
+        };
+        *reinterpret_cast<uint32_t *>(dst) = 0x40 | (size << 8);
+        auto out = dst + 4;
+        uint32_t pos = 0;
+        uint32_t literalStart = 0;
+        while (pos < size)
+        {
+            // find longest match in window
+            uint32_t bestLength = 0;
+            uint32_t bestDistance = 0;
+            for (uint32_t distance = 1; distance <= 1024 && distance <= pos; ++distance)
+            {
+                uint32_t length = 0;
+                while (length < 600 && pos + length < size && src[pos + length] == src[pos + length - distance])
+                {
+                    length++;
+                }
+                if (length > bestLength)
+                {
+                    bestLength = length;
+                    bestDistance = distance;
+                }
+            }
+            if (bestLength >= 4)
+            {
+                out = writeSequence(out, src + literalStart, pos - literalStart, bestDistance, bestLength);
+                pos += bestLength;
+                literalStart = pos;
+            }
+            else
+            {
+                pos++;
+            }
+        }
+        if (literalStart < size)
+        {
+            out = writeSequence(out, src + literalStart, size - literalStart, 0, 0);
+        }
+        return out - dst;
+    }
+
+    void lz4stream()
+    {
+        printf("LZ4 streaming decoder tests...\n");
+        constexpr uint32_t Size = 16384;
+        static uint8_t original[Size];
+        static uint32_t compressed[Size / 2];
+        static uint8_t reference[Size + 16];
+        static uint8_t streamed[Size + 16];
+        // mix of long runs, repeated patterns, long literal runs and noise
+        uint32_t seed = 0x1234567;
+        for (uint32_t i = 0; i < Size; ++i)
+        {
+            seed = seed * 1664525 + 1013904223;
+            const uint32_t block = (i >> 10) & 3;
+            original[i] = block == 0 ? 0x55 : (block == 1 ? (i & 31) : (block == 2 ? (seed >> 24) : ((i >> 3) ^ (seed >> 30))));
+        }
+        compressLZ4Greedy(original, Size, reinterpret_cast<uint8_t *>(compressed));
+        memset(reference, 0, sizeof(reference));
+        Compression::LZ4UnCompWrite8bit(compressed, reinterpret_cast<uint32_t *>(reference));
+        bool ok = memcmp(reference, original, Size) == 0;
+        printf("Reference decoder: %s\n", ok ? "ok" : "FAILED");
+        // decode with different budgets, including budgets that split literals, matches and match headers
+        const uint32_t budgets[] = {1, 2, 3, 7, 16, 255, 1000, 4096, Size, Size * 2};
+        for (const auto budget : budgets)
+        {
+            memset(streamed, 0, sizeof(streamed));
+            Compression::LZ4StreamState state;
+            ok = Compression::LZ4StreamInit(state, compressed, reinterpret_cast<uint32_t *>(streamed));
+            uint32_t nrOfCalls = 0;
+            uint32_t total = 0;
+            while (ok && !Compression::LZ4StreamDone(state))
+            {
+                const uint32_t written = Compression::LZ4StreamDecode(state, budget);
+                ok = written <= budget && (written == budget || Compression::LZ4StreamDone(state));
+                total += written;
+                nrOfCalls++;
+            }
+            ok = ok && total == Size && Compression::LZ4StreamDecode(state, budget) == 0;
+            ok = ok && memcmp(streamed, reference, sizeof(streamed)) == 0;
+            printf("Budget %u, %u calls: %s\n", budget, nrOfCalls, ok ? "ok" : "FAILED");
+        }
+        // decode through a double-buffered window, like the movie literal decoder and LZ4UnCompWriteDMA() do. matches are read from the previous window and output
+        const uint32_t windowSizes[] = {4, 60, 256, 1024};
+        for (const auto windowSize : windowSizes)
+        {
+            memset(streamed, 0, sizeof(streamed));
+            static uint32_t window[2][1024 / 4];
+            Compression::LZ4StreamState state;
+            ok = Compression::LZ4StreamInit(state, compressed, reinterpret_cast<uint32_t *>(streamed));
+            auto out8 = streamed;
+            const uint32_t *previous = nullptr;
+            uint32_t previousSize = 0;
+            for (uint32_t i = 0; ok && !Compression::LZ4StreamDone(state); i ^= 1)
+            {
+                // clear window, so stale data is not used by accident
+                memset(window[i], 0xEE, sizeof(window[i]));
+                Compression::LZ4StreamSetWindow(state, window[i], previous, previousSize, reinterpret_cast<const uint32_t *>(out8 - previousSize));
+                const uint32_t written = Compression::LZ4StreamDecode(state, windowSize);
+                memcpy(out8, window[i], written);
+                out8 += written;
+                previous = window[i];
+                previousSize = written;
+            }
+            ok = ok && out8 == streamed + Size && memcmp(streamed, reference, sizeof(streamed)) == 0;
+            printf("Window %u: %s\n", windowSize, ok ? "ok" : "FAILED");
+        }
+        // invalid header is rejected
+        const uint32_t invalid[2] = {0x10 | (16 << 8), 0};
+        Compression::LZ4StreamState state;
+        ok = !Compression::LZ4StreamInit(state, invalid, reinterpret_cast<uint32_t *>(streamed)) && Compression::LZ4StreamDone(state);
+        printf("Invalid header: %s\n", ok ? "ok" : "FAILED");
+    }
+
+} // namespace Test
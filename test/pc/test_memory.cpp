@@ -0,0 +1,438 @@
+#include "timer.h"
+
+#include <memory/arena.h>
+#include <memory/heap.h>
+#include <memory/pool.h>
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace Test
+{
+
+    // First-fit allocator as used by Memory::malloc_internal before the TLSF heap.
+    // Kept here as a reference to compare the TLSF heap against.
+    class FirstFitHeap
+    {
+    public:
+        FirstFitHeap(uint8_t *start, uint32_t nrOfBytes)
+            : m_start(reinterpret_cast<MemoryBlock *>(start))
+        {
+            m_start->size = nrOfBytes - sizeof(MemoryBlock);
+            m_start->free = true;
+            m_start->previous = nullptr;
+            m_start->next = nullptr;
+        }
+
+        void *malloc(uint32_t size)
+        {
+            size = (size + 3) & 0xFFFFFFFC;
+            const uint32_t combinedSizeNeeded = size + sizeof(MemoryBlock);
+            MemoryBlock *currentBlock = m_start;
+            do
+            {
+                if (currentBlock->free && currentBlock->size >= combinedSizeNeeded)
+                {
+                    if (currentBlock->size - combinedSizeNeeded > sizeof(MemoryBlock))
+                    {
+                        MemoryBlock *freeBlock = reinterpret_cast<MemoryBlock *>(reinterpret_cast<uint8_t *>(currentBlock) + combinedSizeNeeded);
+                        freeBlock->size = currentBlock->size - combinedSizeNeeded;
+                        freeBlock->free = true;
+                        freeBlock->previous = currentBlock;
+                        freeBlock->next = currentBlock->next;
+                        if (freeBlock->next)
+                        {
+                            freeBlock->next->previous = freeBlock;
+                        }
+                        currentBlock->next = freeBlock;
+                    }
+                    currentBlock->size = size;
+                    currentBlock->free = false;
+                    return reinterpret_cast<uint8_t *>(currentBlock) + sizeof(MemoryBlock);
+                }
+                currentBlock = currentBlock->next;
+            } while (currentBlock != nullptr);
+            return nullptr;
+        }
+
+        void free(void *address)
+        {
+            MemoryBlock *currentBlock = reinterpret_cast<MemoryBlock *>(static_cast<uint8_t *>(address) - sizeof(MemoryBlock));
+            if (!currentBlock->free)
+            {
+                currentBlock->free = true;
+                while (currentBlock->next != nullptr && currentBlock->next->free)
+                {
+                    currentBlock->size += currentBlock->next->size + sizeof(MemoryBlock);
+                    currentBlock->next = currentBlock->next->next;
+                    if (currentBlock->next)
+                    {
+                        currentBlock->next->previous = currentBlock;
+                    }
+                }
+                while (currentBlock->previous != nullptr && currentBlock->previous->free)
+                {
+                    currentBlock->previous->size += currentBlock->size + sizeof(MemoryBlock);
+                    currentBlock->previous->next = currentBlock->next;
+                    if (currentBlock->previous->next)
+                    {
+                        currentBlock->next->previous = currentBlock->previous;
+                    }
+                    currentBlock = currentBlock->previous;
+                }
+            }
+        }
+
+    private:
+        struct MemoryBlock
+        {
+            struct
+            {
+                unsigned int size : 24;
+                unsigned int free : 8;
+            };
+            MemoryBlock *previous;
+            MemoryBlock *next;
+        } __attribute__((aligned(4), packed));
+
+        MemoryBlock *m_start;
+    };
+
+    struct Allocation
+    {
+        uint8_t *address = nullptr;
+        uint32_t size = 0;
+    };
+
+    // Fill allocation with a pattern derived from its index, so we can detect overlapping blocks
+    void fillPattern(const Allocation &a, uint32_t index)
+    {
+        memset(a.address, static_cast<int>(index & 0xFF), a.size);
+    }
+
+    bool checkPattern(const Allocation &a, uint32_t index)
+    {
+        for (uint32_t i = 0; i < a.size; ++i)
+        {
+            if (a.address[i] != (index & 0xFF))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Allocate many small blocks like a scene setup would, then free them in random order, then run random churn.
+    // Returns the time taken in microseconds and the number of failed allocations.
+    template <typename HEAP>
+    std::pair<int64_t, uint32_t> runAllocations(HEAP &heap, uint32_t nrOfAllocations, uint32_t seed, bool &valid)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<uint32_t> sizeDist(4, 96);
+        std::vector<Allocation> allocations(nrOfAllocations);
+        uint32_t failed = 0;
+        const int64_t start = microseconds();
+        for (uint32_t round = 0; round < 16; ++round)
+        {
+            for (uint32_t i = 0; i < nrOfAllocations; ++i)
+            {
+                auto &a = allocations[i];
+                if (a.address == nullptr)
+                {
+                    a.size = sizeDist(rng);
+                    a.address = static_cast<uint8_t *>(heap.malloc(a.size));
+                    failed += a.address == nullptr ? 1 : 0;
+                }
+            }
+            // free about half of the blocks
+            for (uint32_t i = 0; i < nrOfAllocations; ++i)
+            {
+                auto &a = allocations[rng() % nrOfAllocations];
+                if (a.address != nullptr)
+                {
+                    heap.free(a.address);
+                    a.address = nullptr;
+                }
+            }
+        }
+        for (auto &a : allocations)
+        {
+            if (a.address != nullptr)
+            {
+                heap.free(a.address);
+                a.address = nullptr;
+            }
+        }
+        const int64_t end = microseconds();
+        // run again and check that no blocks overlap
+        valid = true;
+        for (uint32_t i = 0; i < nrOfAllocations; ++i)
+        {
+            auto &a = allocations[i];
+            a.size = sizeDist(rng);
+            a.address = static_cast<uint8_t *>(heap.malloc(a.size));
+            if (a.address != nullptr)
+            {
+                valid = valid && (reinterpret_cast<uintptr_t>(a.address) & 3) == 0;
+                fillPattern(a, i);
+            }
+        }
+        for (uint32_t i = 0; i < nrOfAllocations; ++i)
+        {
+            auto &a = allocations[i];
+            if (a.address != nullptr)
+            {
+                valid = valid && checkPattern(a, i);
+                heap.free(a.address);
+            }
+        }
+        return std::make_pair(end - start, failed);
+    }
+
+    // Object roughly the size of an animation keyframe
+    struct SmallObject
+    {
+        uint32_t data[3];
+    };
+
+    // Acquire / release small objects in random order from a heap or a pool.
+    // Returns the time taken in microseconds and counts the number of failed allocations.
+    template <typename ALLOCATE, typename RELEASE>
+    int64_t runSmallObjects(std::vector<SmallObject *> &objects, ALLOCATE allocate, RELEASE release, uint32_t &failed)
+    {
+        std::mt19937 rng(4321);
+        const int64_t start = microseconds();
+        for (uint32_t round = 0; round < 64; ++round)
+        {
+            for (auto &o : objects)
+            {
+                if (o == nullptr)
+                {
+                    o = allocate();
+                    failed += o == nullptr ? 1 : 0;
+                }
+            }
+            for (uint32_t i = 0; i < objects.size() / 2; ++i)
+            {
+                auto &o = objects[rng() % objects.size()];
+                release(o);
+                o = nullptr;
+            }
+        }
+        for (auto &o : objects)
+        {
+            release(o);
+            o = nullptr;
+        }
+        return microseconds() - start;
+    }
+
+    // Blocks for compaction test. The first word of each block stores its index, like Memory::malloc_Handle() does
+    std::vector<Allocation> movableBlocks;
+
+    bool canMoveBlock(void *)
+    {
+        return true;
+    }
+
+    void movedBlock(void *, void *to)
+    {
+        movableBlocks[*static_cast<uint32_t *>(to)].address = static_cast<uint8_t *>(to);
+    }
+
+    // Fill heap with movable blocks, free random half of them, then try to allocate a large block before and after compaction
+    template <typename HEAP, typename COMPACT>
+    void *allocateAfterChurn(HEAP &heap, uint32_t largeSize, COMPACT compact, bool &valid)
+    {
+        std::mt19937 rng(5678);
+        std::uniform_int_distribution<uint32_t> sizeDist(64, 2048);
+        movableBlocks.clear();
+        while (true)
+        {
+            Allocation a;
+            a.size = sizeDist(rng) & ~3;
+            a.address = static_cast<uint8_t *>(heap.malloc(a.size));
+            if (a.address == nullptr)
+            {
+                break;
+            }
+            movableBlocks.push_back(a);
+        }
+        for (uint32_t i = 0; i < movableBlocks.size(); ++i)
+        {
+            auto &a = movableBlocks[i];
+            if (rng() & 1)
+            {
+                heap.free(a.address);
+                a.address = nullptr;
+            }
+            else
+            {
+                fillPattern(a, i);
+                *reinterpret_cast<uint32_t *>(a.address) = i;
+            }
+        }
+        compact(heap);
+        void *large = heap.malloc(largeSize);
+        // check that block contents survived
+        valid = true;
+        for (uint32_t i = 0; i < movableBlocks.size(); ++i)
+        {
+            auto &a = movableBlocks[i];
+            if (a.address != nullptr)
+            {
+                valid = valid && *reinterpret_cast<uint32_t *>(a.address) == i;
+                *reinterpret_cast<uint32_t *>(a.address) = (i & 0xFF) * 0x01010101;
+                valid = valid && checkPattern(a, i);
+            }
+        }
+        return large;
+    }
+
+    void memory()
+    {
+        printf("Memory manager tests...\n");
+        constexpr uint32_t HeapSize = 256 * 1024 - 4096; // roughly the EWRAM heap size
+        std::vector<uint32_t> memory(HeapSize / 4);
+        auto memory8 = reinterpret_cast<uint8_t *>(memory.data());
+        // check basic TLSF heap operation
+        auto heap = Memory::Heap::create(memory8, HeapSize);
+        bool ok = heap != nullptr;
+        auto a = heap->malloc(7);
+        auto b = heap->malloc(128);
+        auto c = heap->malloc(1024);
+        ok = ok && a != nullptr && b != nullptr && c != nullptr;
+        ok = ok && heap->contains(a) && heap->contains(c) && !heap->contains(memory8 + HeapSize);
+        ok = ok && heap->malloc(0) == nullptr && heap->malloc(Memory::Heap::MaxAllocationSize + 1) == nullptr;
+        auto stats = heap->stats();
+        const uint32_t usedAfterMalloc = stats.used;
+        ok = ok && stats.usedBlocks == 3 && usedAfterMalloc >= 7 + 128 + 1024 && stats.freeBlocks == 1 && stats.largestFree == stats.free;
+        heap->free(b);
+        heap->free(b); // double free must be ignored
+        stats = heap->stats();
+        ok = ok && stats.usedBlocks == 2 && stats.freeBlocks == 2 && stats.largestFree < stats.free && stats.highWatermark == usedAfterMalloc;
+        heap->free(a);
+        heap->free(c);
+        stats = heap->stats();
+        ok = ok && stats.used == 0 && stats.usedBlocks == 0 && stats.freeBlocks == 1;
+        // after freeing everything we must be able to allocate one big block again
+        auto big = heap->malloc(HeapSize / 2);
+        ok = ok && big != nullptr;
+        heap->free(big);
+        printf("Basic TLSF malloc/free: %s\n", ok ? "ok" : "FAILED");
+        // compare TLSF heap to first-fit heap with increasing numbers of live blocks
+        printf("Live blocks | first-fit [us] | failed | TLSF [us] | failed | valid\n");
+        for (uint32_t nrOfAllocations : {64, 256, 1024, 2048})
+        {
+            bool validFirstFit = false;
+            FirstFitHeap firstFit(memory8, HeapSize);
+            const auto resultFirstFit = runAllocations(firstFit, nrOfAllocations, 1234, validFirstFit);
+            bool validTlsf = false;
+            auto tlsf = Memory::Heap::create(memory8, HeapSize);
+            const auto resultTlsf = runAllocations(*tlsf, nrOfAllocations, 1234, validTlsf);
+            printf("%11u | %14lld | %6u | %9lld | %6u | %s\n", nrOfAllocations,
+                   static_cast<long long>(resultFirstFit.first), resultFirstFit.second,
+                   static_cast<long long>(resultTlsf.first), resultTlsf.second,
+                   validFirstFit && validTlsf ? "ok" : "FAILED");
+        }
+        // check scratch arena
+        Memory::Arena arena;
+        arena.init(memory8 + 1, 1024 + 3);
+        ok = arena.size() == 1024 && (reinterpret_cast<uintptr_t>(arena.malloc(1)) & 3) == 0;
+        auto words = arena.malloc<uint32_t>(100);
+        ok = ok && words != nullptr && arena.used() == 4 + 400;
+        ok = ok && arena.malloc(1024) == nullptr && arena.used() == 404;
+        arena.reset();
+        ok = ok && arena.used() == 0 && arena.highWatermark() == 404;
+        ok = ok && arena.malloc<uint8_t>(1024) != nullptr && arena.malloc(1) == nullptr && arena.highWatermark() == 1024;
+        arena.reset();
+        arena.resetHighWatermark();
+        ok = ok && arena.highWatermark() == 0;
+        // check that compaction lets large allocations succeed after churn
+        {
+            constexpr uint32_t CompactHeapSize = 64 * 1024;
+            constexpr uint32_t LargeSize = CompactHeapSize / 3;
+            auto noCompaction = [](auto &) {};
+            auto compaction = [](Memory::Heap &heap)
+            {
+                for (auto &a : movableBlocks)
+                {
+                    if (a.address != nullptr)
+                    {
+                        heap.setMovable(a.address);
+                    }
+                }
+                heap.compact(canMoveBlock, movedBlock);
+            };
+            bool validFirstFit = false;
+            FirstFitHeap firstFit(memory8, CompactHeapSize);
+            const bool firstFitOk = allocateAfterChurn(firstFit, LargeSize, noCompaction, validFirstFit) != nullptr;
+            bool validTlsf = false;
+            const bool tlsfOk = allocateAfterChurn(*Memory::Heap::create(memory8, CompactHeapSize), LargeSize, noCompaction, validTlsf) != nullptr;
+            bool validCompact = false;
+            auto compactHeap = Memory::Heap::create(memory8, CompactHeapSize);
+            const bool compactOk = allocateAfterChurn(*compactHeap, LargeSize, compaction, validCompact) != nullptr;
+            const auto stats = compactHeap->stats();
+            printf("Allocating %u bytes after churn: first-fit %s, TLSF %s, TLSF + compact %s (%u free blocks left)\n", LargeSize,
+                   firstFitOk ? "ok" : "failed", tlsfOk ? "ok" : "failed", compactOk ? "ok" : "failed", stats.freeBlocks);
+            printf("Heap compaction: %s\n", compactOk && validFirstFit && validTlsf && validCompact ? "ok" : "FAILED");
+        }
+        printf("Scratch arena malloc/reset: %s\n", ok ? "ok" : "FAILED");
+        // check object pool
+        constexpr uint32_t NrOfObjects = 1024;
+        static Memory::Pool<SmallObject, NrOfObjects> pool;
+        ok = pool.available() == NrOfObjects;
+        std::vector<SmallObject *> objects(NrOfObjects, nullptr);
+        for (auto &o : objects)
+        {
+            o = pool.acquire();
+            ok = ok && o != nullptr && pool.contains(o) && (reinterpret_cast<uintptr_t>(o) & 3) == 0;
+        }
+        ok = ok && pool.acquire() == nullptr && pool.used() == NrOfObjects;
+        pool.release(objects[10]);
+        ok = ok && pool.acquire() == objects[10];
+        pool.clear();
+        ok = ok && pool.used() == 0;
+        printf("Object pool acquire/release: %s\n", ok ? "ok" : "FAILED");
+        // compare pool against heaps for small objects. footprint is the memory used per object incl. management data
+        printf("Allocator | bytes / %u byte object | time [us] | failed\n", uint32_t(sizeof(SmallObject)));
+        {
+            uint32_t failed = 0;
+            FirstFitHeap firstFit(memory8, HeapSize);
+            std::vector<SmallObject *> all(NrOfObjects, nullptr);
+            const auto time = runSmallObjects(all, [&]()
+                                              { return static_cast<SmallObject *>(firstFit.malloc(sizeof(SmallObject))); },
+                                              [&](SmallObject *o)
+                                              { if (o) firstFit.free(o); },
+                                              failed);
+            auto first = static_cast<uint8_t *>(firstFit.malloc(sizeof(SmallObject)));
+            auto second = static_cast<uint8_t *>(firstFit.malloc(sizeof(SmallObject)));
+            printf("first-fit | %22d | %9lld | %6u\n", int(second - first), static_cast<long long>(time), failed);
+        }
+        {
+            uint32_t failed = 0;
+            auto tlsf = Memory::Heap::create(memory8, HeapSize);
+            std::vector<SmallObject *> all(NrOfObjects, nullptr);
+            const auto time = runSmallObjects(all, [&]()
+                                              { return static_cast<SmallObject *>(tlsf->malloc(sizeof(SmallObject))); },
+                                              [&](SmallObject *o)
+                                              { if (o) tlsf->free(o); },
+                                              failed);
+            auto first = static_cast<uint8_t *>(tlsf->malloc(sizeof(SmallObject)));
+            auto second = static_cast<uint8_t *>(tlsf->malloc(sizeof(SmallObject)));
+            printf("TLSF      | %22d | %9lld | %6u\n", int(second - first), static_cast<long long>(time), failed);
+        }
+        {
+            uint32_t failed = 0;
+            const auto time = runSmallObjects(objects, [&]()
+                                              { return pool.acquire(); },
+                                              [&](SmallObject *o)
+                                              { pool.release(o); },
+                                              failed);
+            printf("Pool      | %22d | %9lld | %6u\n", int(sizeof(pool) / NrOfObjects), static_cast<long long>(time), failed);
+        }
+    }
+
+} // namespace Test
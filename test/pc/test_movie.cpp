@@ -0,0 +1,110 @@
+#include <movie.h>
+
+#include "../../tools/moviepack/movieencoder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace Test
+{
+
+    // Frames with a scrolling background, a moving box and a noisy area, so all block types are used
+    std::vector<std::vector<uint8_t>> movieFrames(uint32_t width, uint32_t height, uint32_t bytesPerPixel, uint32_t nrOfFrames)
+    {
+        std::vector<std::vector<uint8_t>> frames;
+        uint32_t seed = 0x1234567;
+        for (uint32_t n = 0; n < nrOfFrames; ++n)
+        {
+            std::vector<uint8_t> frame(width * height * bytesPerPixel);
+            for (uint32_t y = 0; y < height; ++y)
+            {
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    uint32_t color = ((x + 4 * n) / 16 + y / 16) & 7;
+                    if (x >= 8 + 3 * n && x < 40 + 3 * n && y >= 24 + n && y < 56 + n)
+                    {
+                        color = 9 + (y & 1);
+                    }
+                    if (y >= height - 16 && x < 32 && (n & 3) == 0)
+                    {
+                        seed = seed * 1664525 + 1013904223;
+                        color = seed >> 24;
+                    }
+                    for (uint32_t i = 0; i < bytesPerPixel; ++i)
+                    {
+                        frame[(y * width + x) * bytesPerPixel + i] = color * (i + 1);
+                    }
+                }
+            }
+            frames.push_back(frame);
+        }
+        return frames;
+    }
+
+    // Decode movie twice in a row like looped playback and compare every frame to the original
+    bool movieRoundTrip(const std::vector<std::vector<uint8_t>> &frames, const std::vector<uint8_t> &data, uint32_t nrOfBuffers)
+    {
+        std::vector<uint32_t> movie((data.size() + 3) / 4);
+        std::copy(data.cbegin(), data.cend(), reinterpret_cast<uint8_t *>(movie.data()));
+        auto header = reinterpret_cast<const Movie::MovieHeader *>(movie.data());
+        const uint32_t frameWords = frames.front().size() / 4;
+        // buffers start with garbage, which must never show up in the frames
+        std::vector<std::vector<uint32_t>> buffers(nrOfBuffers, std::vector<uint32_t>(frameWords, 0xEEEEEEEE));
+        std::vector<uint32_t> literalBuffer(2 * Movie::LiteralBufferSize / 4);
+        bool ok = header->magic == Movie::MovieMagic && header->nrOfFrames == frames.size();
+        const Movie::FrameHeader *frame = nullptr;
+        for (uint32_t n = 0; ok && n < 2 * frames.size(); ++n)
+        {
+            if (n % frames.size() == 0)
+            {
+                // all frames must have been read when looping
+                ok = n == 0 || reinterpret_cast<const uint8_t *>(frame) == reinterpret_cast<const uint8_t *>(movie.data()) + data.size();
+                frame = Movie::firstFrame(header);
+            }
+            auto &back = buffers[n % nrOfBuffers];
+            const auto &front = buffers[(n + 1) % nrOfBuffers];
+            frame = Movie::decodeFrame(header, frame, back.data(), front.data(), literalBuffer.data());
+            ok = ok && memcmp(back.data(), frames[n % frames.size()].data(), frameWords * 4) == 0;
+        }
+        return ok;
+    }
+
+    void movie()
+    {
+        printf("Movie codec tests...\n");
+        struct Config
+        {
+            uint32_t bytesPerPixel;
+            uint32_t blockSize;
+            uint32_t nrOfBuffers;
+        };
+        const Config configs[] = {{1, 8, 2}, {1, 4, 2}, {2, 8, 1}, {2, 4, 1}, {2, 8, 2}};
+        bool ok = true;
+        for (const auto &config : configs)
+        {
+            Movie::EncodeOptions options;
+            options.bytesPerPixel = config.bytesPerPixel;
+            options.blockSize = config.blockSize;
+            options.nrOfBuffers = config.nrOfBuffers;
+            const auto frames = movieFrames(options.width, options.height, options.bytesPerPixel, 12);
+            const std::vector<uint16_t> palette = config.bytesPerPixel == 1 ? std::vector<uint16_t>{0, 0x7FFF, 0x001F} : std::vector<uint16_t>();
+            Movie::EncodeStats stats;
+            const auto data = Movie::encodeMovie(frames, palette, options, &stats);
+            // first frame can not use skip or copy blocks, the following ones must
+            bool configOk = !data.empty() && stats.skipBlocks > 0 && stats.copyBlocks > 0 && stats.literalBlocks > 0;
+            configOk = configOk && movieRoundTrip(frames, data, config.nrOfBuffers);
+            const uint32_t rawSize = frames.size() * frames.front().size();
+            printf("%u bpp, %ux%u blocks, %u buffers: %u -> %u bytes, %u skip, %u copy, %u literal: %s\n", 8 * config.bytesPerPixel, config.blockSize, config.blockSize, config.nrOfBuffers,
+                   rawSize, static_cast<uint32_t>(data.size()), stats.skipBlocks, stats.copyBlocks, stats.literalBlocks, configOk ? "ok" : "FAILED");
+            ok = ok && configOk;
+        }
+        // invalid options
+        Movie::EncodeOptions options;
+        options.blockSize = 5;
+        ok = ok && Movie::encodeMovie(movieFrames(240, 160, 1, 1), {}, options).empty();
+        printf("Results: %s\n", ok ? "ok" : "FAILED");
+    }
+
+}
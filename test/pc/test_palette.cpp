@@ -0,0 +1,49 @@
+#include <palettebanks.h>
+
+#include <cstdio>
+
+namespace Test
+{
+
+    void palette()
+    {
+        printf("Palette bank tests...\n");
+        Palette::Palette16 a;
+        Palette::Palette16 b;
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            a[i] = i;
+            b[i] = 0x7FFF - i;
+        }
+        Palette::clearBanks();
+        // identical palettes share a bank
+        const auto bankA = Palette::acquireBank(Palette::BankTarget::Sprite, a);
+        const auto bankB = Palette::acquireBank(Palette::BankTarget::Sprite, b);
+        bool ok = bankA >= 0 && bankB >= 0 && bankA != bankB;
+        ok = ok && Palette::acquireBank(Palette::BankTarget::Sprite, a) == bankA;
+        ok = ok && Palette::usedBanks(Palette::BankTarget::Sprite) == 2 && Palette::usedBanks(Palette::BankTarget::Background) == 0;
+        // bank is free after all users released it
+        Palette::releaseBank(Palette::BankTarget::Sprite, bankA);
+        ok = ok && Palette::usedBanks(Palette::BankTarget::Sprite) == 2;
+        Palette::releaseBank(Palette::BankTarget::Sprite, bankA);
+        ok = ok && Palette::usedBanks(Palette::BankTarget::Sprite) == 1;
+        // reacquiring a palette still in a free bank reuses the bank
+        ok = ok && Palette::acquireBank(Palette::BankTarget::Sprite, a) == bankA;
+        // reserved banks are not shared
+        const auto effectBank = Palette::reserveBank(Palette::BankTarget::Sprite);
+        Palette::updateBank(Palette::BankTarget::Sprite, effectBank, b);
+        ok = ok && effectBank >= 0 && Palette::acquireBank(Palette::BankTarget::Sprite, b) == bankB;
+        // all banks can be used up
+        uint32_t nrOfAcquired = 0;
+        for (uint32_t i = 0; i < 32; ++i)
+        {
+            Palette::Palette16 c = {static_cast<color16>(i + 100)};
+            nrOfAcquired += Palette::acquireBank(Palette::BankTarget::Background, c) >= 0 ? 1 : 0;
+        }
+        ok = ok && nrOfAcquired == Palette::NrOfBanks;
+        Palette::clearBanks();
+        ok = ok && Palette::usedBanks(Palette::BankTarget::Background) == 0;
+        printf("Bank sharing and reference counting: %s\n", ok ? "ok" : "FAILED");
+    }
+
+} // namespace Test
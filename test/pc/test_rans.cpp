@@ -0,0 +1,90 @@
+#include <compression/lz4.h>
+#include <compression/rans.h>
+
+#include "../../tools/ranspack/ransencoder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace Test
+{
+
+    // Decode with the C decoder and compare to the original data
+    bool ransRoundTrip(const std::vector<uint8_t> &data, const std::vector<uint8_t> &compressed)
+    {
+        // decoders read words from 4-byte-aligned buffers
+        std::vector<uint32_t> src((compressed.size() + 3) / 4, 0);
+        std::copy(compressed.cbegin(), compressed.cend(), reinterpret_cast<uint8_t *>(src.data()));
+        std::vector<uint32_t> dst(data.size() / 4 + 2, 0xEEEEEEEE);
+        std::vector<uint32_t> tables(Compression::RANSTableSize / 4);
+        bool ok = (compressed.size() & 3) == 0 && Compression::RANSUnCompGetSize(src.data()) == data.size();
+        if (compressed[0] == Compression::RANSLZ4TypeMarker)
+        {
+            // decode rANS to LZ4 data, then LZ4 data to the original
+            std::vector<uint32_t> lz4(Compression::RANSUnCompGetSize(src.data() + 1) / 4 + 1, 0);
+            Compression::RANSUnCompWrite8bit(src.data() + 1, lz4.data(), tables.data());
+            Compression::LZ4UnCompWrite8bit(lz4.data(), dst.data());
+        }
+        else
+        {
+            Compression::RANSUnCompWrite8bit(src.data(), dst.data(), tables.data());
+        }
+        ok = ok && std::equal(data.cbegin(), data.cend(), reinterpret_cast<const uint8_t *>(dst.data()));
+        // check that nothing was written past the end
+        return ok && reinterpret_cast<const uint8_t *>(dst.data())[data.size()] == 0xEE;
+    }
+
+    void rans()
+    {
+        printf("rANS encoder tests...\n");
+        std::vector<std::pair<const char *, std::vector<uint8_t>>> inputs;
+        uint32_t seed = 0x1234567;
+        auto random = [&seed]()
+        {
+            seed = seed * 1664525 + 1013904223;
+            return seed >> 24;
+        };
+        inputs.push_back({"empty", {}});
+        inputs.push_back({"1 byte", {42}});
+        inputs.push_back({"zeros", std::vector<uint8_t>(100000, 0)});
+        std::vector<uint8_t> noise(5000);
+        for (auto &v : noise)
+        {
+            v = random();
+        }
+        inputs.push_back({"noise", noise});
+        // few symbols with very different probabilities. needs 2 byte frequencies and runs of unused symbols
+        std::vector<uint8_t> skewed(20000);
+        for (auto &v : skewed)
+        {
+            const uint32_t r = random();
+            v = r < 200 ? 7 : (r < 250 ? 100 + (r & 3) : 255);
+        }
+        inputs.push_back({"skewed", skewed});
+        // tile-like data with flat areas, repeated patterns and noise
+        std::vector<uint8_t> image(76800);
+        for (uint32_t i = 0; i < image.size(); ++i)
+        {
+            const uint32_t x = i % 240;
+            const uint32_t y = i / 240;
+            image[i] = ((x / 8) ^ (y / 8)) & 15;
+            image[i] = (random() < 16) ? random() : image[i];
+        }
+        inputs.push_back({"image", image});
+        bool ok = true;
+        for (const auto &input : inputs)
+        {
+            const auto rans = Compression::RANSCompress(input.second);
+            const auto ransLz4 = Compression::RANSLZ4Compress(input.second);
+            const bool inputOk = ransRoundTrip(input.second, rans) && ransRoundTrip(input.second, ransLz4);
+            printf("%s: %u bytes, rANS %u bytes, LZ4 + rANS %u bytes: %s\n", input.first, static_cast<uint32_t>(input.second.size()),
+                   static_cast<uint32_t>(rans.size()), static_cast<uint32_t>(ransLz4.size()), inputOk ? "ok" : "FAILED");
+            ok = ok && inputOk;
+        }
+        // entropy coding must beat plain LZ4 on noisy data with a skewed distribution
+        ok = ok && Compression::RANSCompress(skewed).size() < Compression::LZ4Compress(skewed).size();
+        printf("Results: %s\n", ok ? "ok" : "FAILED");
+    }
+
+}
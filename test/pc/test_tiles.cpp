@@ -0,0 +1,88 @@
+#include <tileallocator.h>
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace Test
+{
+
+    void printReport(const char *name, const Tiles::Allocator::Stats &stats)
+    {
+        printf("%s: %u/%u slots used, largest free range %u, %u free ranges\n", name, stats.usedSlots, stats.nrOfSlots, stats.largestFree, stats.nrOfFreeRanges);
+    }
+
+    void tiles()
+    {
+        printf("Tile allocator tests...\n");
+        // basic allocation, alignment and freeing
+        Tiles::Allocator allocator;
+        allocator.init(64);
+        bool ok = allocator.allocate(3) == 0;
+        ok = ok && allocator.allocate(2, 2) == 4;
+        ok = ok && allocator.allocate(1) == 3;
+        ok = ok && allocator.allocate(40, 8) == 8;
+        ok = ok && allocator.allocate(17) == -1 && allocator.allocate(16) == 48;
+        ok = ok && allocator.stats().usedSlots == 62 && allocator.stats().nrOfFreeRanges == 1;
+        allocator.free(8, 40);
+        ok = ok && allocator.isFree(6, 42) && !allocator.isFree(5, 2);
+        ok = ok && allocator.allocate(33, 32) == -1 && allocator.allocate(32, 8) == 8;
+        printf("Basic allocation: %s\n", ok ? "ok" : "FAILED");
+        // sprite tiles. 256 color tiles must start on even indices
+        Tiles::resetSpriteTiles();
+        ok = Tiles::allocateSpriteTiles(Sprites::SizeCode::Size8x8, Sprites::ColorDepth::Depth16) == 0;
+        ok = ok && Tiles::allocateSpriteTiles(Sprites::SizeCode::Size8x8, Sprites::ColorDepth::Depth256) == 2;
+        ok = ok && Tiles::allocateSpriteTiles(Sprites::SizeCode::Size64x64, Sprites::ColorDepth::Depth256, 7) == 4;
+        ok = ok && Tiles::allocateSpriteTiles(Sprites::SizeCode::Size64x64, Sprites::ColorDepth::Depth256) == -1;
+        Tiles::freeSpriteTiles(4, Sprites::SizeCode::Size64x64, Sprites::ColorDepth::Depth256, 7);
+        ok = ok && Tiles::spriteTileStats().usedSlots == 3;
+        Tiles::resetSpriteTiles(true);
+        ok = ok && Tiles::allocateSpriteTiles(Sprites::SizeCode::Size8x8, Sprites::ColorDepth::Depth16) == 512;
+        printf("Sprite tiles: %s\n", ok ? "ok" : "FAILED");
+        // background tiles. indices are relative to the tile base, screen blocks are reserved
+        Tiles::resetBackgroundTiles();
+        Tiles::reserveBackgroundScreen(Tiles::ScreenBase::Base0000, 2);
+        ok = Tiles::allocateBackgroundTiles(Tiles::TileBase::Base0000, 10, Backgrounds::ColorDepth::Depth16) == 128;
+        ok = ok && Tiles::allocateBackgroundTiles(Tiles::TileBase::Base0000, 10, Backgrounds::ColorDepth::Depth256) == 69;
+        ok = ok && Tiles::allocateBackgroundTiles(Tiles::TileBase::Base4000, 512, Backgrounds::ColorDepth::Depth16) == 0;
+        ok = ok && Tiles::allocateBackgroundTiles(Tiles::TileBase::BaseC000, 600, Backgrounds::ColorDepth::Depth16) == -1;
+        ok = ok && Tiles::allocateBackgroundTiles(Tiles::TileBase::BaseC000, 256, Backgrounds::ColorDepth::Depth256) == 0;
+        printf("Background tiles: %s\n", ok ? "ok" : "FAILED");
+        // fragmentation report for a scene-like mix of sprite allocations and frees
+        Tiles::resetSpriteTiles();
+        std::mt19937 rng(42);
+        struct SpriteTiles
+        {
+            int32_t tileIndex;
+            Sprites::SizeCode size;
+            Sprites::ColorDepth depth;
+        };
+        std::vector<SpriteTiles> sprites;
+        uint32_t failed = 0;
+        for (uint32_t round = 0; round < 256; ++round)
+        {
+            SpriteTiles s;
+            s.size = static_cast<Sprites::SizeCode>(rng() % 12);
+            s.depth = (rng() & 1) ? Sprites::ColorDepth::Depth256 : Sprites::ColorDepth::Depth16;
+            s.tileIndex = Tiles::allocateSpriteTiles(s.size, s.depth);
+            if (s.tileIndex >= 0)
+            {
+                sprites.push_back(s);
+            }
+            else
+            {
+                failed++;
+            }
+            if (sprites.size() > 24)
+            {
+                const uint32_t index = rng() % sprites.size();
+                Tiles::freeSpriteTiles(sprites[index].tileIndex, sprites[index].size, sprites[index].depth);
+                sprites.erase(sprites.begin() + index);
+            }
+        }
+        printf("%u of 256 random sprite allocations failed\n", failed);
+        printReport("Sprite tiles", Tiles::spriteTileStats());
+        printReport("Background tiles", Tiles::backgroundTileStats());
+    }
+
+} // namespace Test
@@ -5,5 +5,15 @@ namespace Test
 
     void math_fp32();
     void math_vec();
+    void memory();
+    void tiles();
+    void palette();
+    void dmaqueue();
+    void lz4stream();
+    void lz4encoder();
+    void movie();
+    void rans();
+    void fuzz();
+    void adpcm();
 
 }
\ No newline at end of file
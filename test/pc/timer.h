@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <sys/time.h>
+
+namespace Test
+{
+
+    /// @brief Get wall clock time in microseconds for benchmarking on the host.
+    /// @note We can't use <chrono> here, because src/time.h shadows the system <time.h>.
+    inline int64_t microseconds()
+    {
+        timeval now;
+        gettimeofday(&now, nullptr);
+        return static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_usec;
+    }
+
+} // namespace Test
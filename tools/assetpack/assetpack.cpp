@@ -0,0 +1,288 @@
+// Packs files into one asset archive for the runtime in src/assets.h and writes a header with asset ids and
+// an assembler file that puts the archive into ROM. Normally run from gba_add_assets() in cmake/AssetsGBA.cmake.
+
+#include "../lz4pack/lz4encoder.h"
+#include "../ranspack/ransencoder.h"
+
+#include <assets.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+enum class PackMode
+{
+    Raw,     // Store uncompressed
+    LZ4,     // Compress with LZ4
+    RANS,    // Entropy code with rANS
+    LZ4RANS, // Compress with LZ4, then entropy code with rANS
+    Auto,    // Compress with LZ4 if it saves at least 1/8 of the size
+    Bios     // File is already compressed with a GBA BIOS compatible header
+};
+
+struct Asset
+{
+    std::string path;
+    std::string name;
+    PackMode mode = PackMode::Auto;
+    uint32_t id = 0;
+    std::vector<uint8_t> data;
+    Assets::ArchiveEntry entry = {};
+};
+
+void printUsage()
+{
+    std::cout << "Pack files into a GBA asset archive." << std::endl;
+    std::cout << "Usage: assetpack [--speed WEIGHT] OUTPUT [--raw | --lz4 | --rans | --lz4rans | --auto | --bios] FILE[=NAME]..." << std::endl;
+    std::cout << "--speed WEIGHT: LZ4 speed weight, see lz4pack (default: 0)." << std::endl;
+    std::cout << "OUTPUT: Output path and name. Writes OUTPUT.bin, OUTPUT.h and OUTPUT.s. For OUTPUT = path/NAME" << std::endl;
+    std::cout << "the archive symbol is NAME_archive and the asset ids in OUTPUT.h are in namespace NAME." << std::endl;
+    std::cout << "--raw, --lz4, --rans, --lz4rans, --auto, --bios: How to store the following files (default: --auto)." << std::endl;
+    std::cout << "--rans entropy codes with rANS 50h, --lz4rans compresses with LZ4 and entropy codes that (rANS 51h), see ranspack." << std::endl;
+    std::cout << "--auto uses LZ4 if it saves at least 1/8 of the size. --bios stores files that are already" << std::endl;
+    std::cout << "compressed to LZ77 10h, RL 30h, LZ4 40h or rANS 50h / 51h, e.g. with gbalzss, grit or ranspack." << std::endl;
+    std::cout << "FILE[=NAME]: Input file. The asset name defaults to the file name without extension." << std::endl;
+}
+
+// Turn a string into a C++ identifier
+std::string toIdentifier(const std::string &name)
+{
+    std::string result;
+    for (auto c : name)
+    {
+        result += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+    if (result.empty() || std::isdigit(static_cast<unsigned char>(result.front())))
+    {
+        result = "_" + result;
+    }
+    return result;
+}
+
+std::string baseName(const std::string &path, bool removeExtension)
+{
+    const auto slash = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    const auto dot = name.find_last_of('.');
+    return (removeExtension && dot != std::string::npos && dot > 0) ? name.substr(0, dot) : name;
+}
+
+bool packAsset(Asset &asset, double speedWeight, std::vector<uint8_t> &stored)
+{
+    asset.entry.id = asset.id;
+    asset.entry.uncompressedSize = asset.data.size();
+    if (asset.mode == PackMode::Bios)
+    {
+        const uint8_t type = asset.data.empty() ? 0 : asset.data[0];
+        if (asset.data.size() < 4 || (type != 0x10 && type != 0x30 && type != 0x40 && type != 0x50 && type != 0x51))
+        {
+            std::cerr << asset.path << " has no LZ77 10h, RL 30h, LZ4 40h or rANS 50h / 51h header" << std::endl;
+            return false;
+        }
+        asset.entry.codec = static_cast<Assets::Codec>(type);
+        asset.entry.uncompressedSize = asset.data[1] | (asset.data[2] << 8) | (asset.data[3] << 16);
+        stored = asset.data;
+        return true;
+    }
+    stored = asset.data;
+    asset.entry.codec = Assets::Codec::Raw;
+    Compression::LZ4EncodeOptions options;
+    options.speedWeight = speedWeight;
+    if (asset.mode == PackMode::RANS)
+    {
+        stored = Compression::RANSCompress(asset.data);
+        asset.entry.codec = Assets::Codec::RANS;
+    }
+    else if (asset.mode == PackMode::LZ4RANS)
+    {
+        stored = Compression::RANSLZ4Compress(asset.data, options);
+        asset.entry.codec = Assets::Codec::RANSLZ4;
+    }
+    else if (asset.mode != PackMode::Raw && !asset.data.empty())
+    {
+        auto compressed = Compression::LZ4Compress(asset.data, options);
+        if (asset.mode == PackMode::LZ4 || compressed.size() <= asset.data.size() - asset.data.size() / 8)
+        {
+            stored = std::move(compressed);
+            asset.entry.codec = Assets::Codec::LZ4;
+        }
+    }
+    return true;
+}
+
+const char *codecName(Assets::Codec codec)
+{
+    switch (codec)
+    {
+    case Assets::Codec::LZ77:
+        return "LZ77";
+    case Assets::Codec::RL:
+        return "RL";
+    case Assets::Codec::LZ4:
+        return "LZ4";
+    case Assets::Codec::RANS:
+        return "rANS";
+    case Assets::Codec::RANSLZ4:
+        return "LZ4 + rANS";
+    default:
+        return "raw";
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    double speedWeight = 0;
+    std::string output;
+    PackMode mode = PackMode::Auto;
+    std::vector<Asset> assets;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+        {
+            speedWeight = strtod(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--raw") == 0)
+        {
+            mode = PackMode::Raw;
+        }
+        else if (strcmp(argv[i], "--lz4") == 0)
+        {
+            mode = PackMode::LZ4;
+        }
+        else if (strcmp(argv[i], "--rans") == 0)
+        {
+            mode = PackMode::RANS;
+        }
+        else if (strcmp(argv[i], "--lz4rans") == 0)
+        {
+            mode = PackMode::LZ4RANS;
+        }
+        else if (strcmp(argv[i], "--auto") == 0)
+        {
+            mode = PackMode::Auto;
+        }
+        else if (strcmp(argv[i], "--bios") == 0)
+        {
+            mode = PackMode::Bios;
+        }
+        else if (output.empty())
+        {
+            output = argv[i];
+        }
+        else
+        {
+            Asset asset;
+            const std::string arg = argv[i];
+            const auto equals = arg.find('=');
+            asset.path = arg.substr(0, equals);
+            asset.name = equals != std::string::npos ? arg.substr(equals + 1) : baseName(asset.path, true);
+            asset.mode = mode;
+            asset.id = Assets::id(asset.name.c_str());
+            assets.push_back(asset);
+        }
+    }
+    if (output.empty() || assets.empty())
+    {
+        printUsage();
+        return 1;
+    }
+    // read files and check for duplicate names and ids
+    std::sort(assets.begin(), assets.end(), [](const Asset &a, const Asset &b)
+              { return a.id < b.id; });
+    for (uint32_t i = 0; i < assets.size(); ++i)
+    {
+        if (i > 0 && assets[i].id == assets[i - 1].id)
+        {
+            std::cerr << "Assets " << assets[i - 1].name << " and " << assets[i].name << " have the same id" << std::endl;
+            return 1;
+        }
+        std::ifstream file(assets[i].path, std::ios::binary);
+        if (!file.is_open())
+        {
+            std::cerr << "Failed to open " << assets[i].path << std::endl;
+            return 1;
+        }
+        assets[i].data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        if (assets[i].data.size() >= (1 << 24))
+        {
+            std::cerr << assets[i].path << " must be smaller than 16 MB" << std::endl;
+            return 1;
+        }
+    }
+    // build archive: header, sorted index, data aligned to 4 bytes
+    std::vector<uint8_t> archive(sizeof(Assets::ArchiveHeader) + assets.size() * sizeof(Assets::ArchiveEntry), 0);
+    for (auto &asset : assets)
+    {
+        std::vector<uint8_t> stored;
+        if (!packAsset(asset, speedWeight, stored))
+        {
+            return 1;
+        }
+        asset.entry.offset = archive.size();
+        asset.entry.storedSize = stored.size();
+        archive.insert(archive.end(), stored.cbegin(), stored.cend());
+        archive.resize((archive.size() + 3) & ~3, 0);
+    }
+    const Assets::ArchiveHeader header = {Assets::ArchiveMagic, static_cast<uint32_t>(assets.size())};
+    memcpy(archive.data(), &header, sizeof(header));
+    for (uint32_t i = 0; i < assets.size(); ++i)
+    {
+        memcpy(archive.data() + sizeof(header) + i * sizeof(Assets::ArchiveEntry), &assets[i].entry, sizeof(Assets::ArchiveEntry));
+    }
+    // write archive, header with ids and assembler file
+    const std::string name = toIdentifier(baseName(output, false));
+    const std::string symbol = name + "_archive";
+    std::ofstream binFile(output + ".bin", std::ios::binary);
+    if (!binFile.is_open() || !binFile.write(reinterpret_cast<const char *>(archive.data()), archive.size()))
+    {
+        std::cerr << "Failed to write " << output << ".bin" << std::endl;
+        return 1;
+    }
+    std::ofstream headerFile(output + ".h");
+    std::ofstream asmFile(output + ".s");
+    if (!headerFile.is_open() || !asmFile.is_open())
+    {
+        std::cerr << "Failed to write " << output << ".h / .s" << std::endl;
+        return 1;
+    }
+    headerFile << "#pragma once" << std::endl
+               << std::endl
+               << "// Generated by assetpack. Do not edit." << std::endl
+               << std::endl
+               << "#include <cstdint>" << std::endl
+               << std::endl
+               << "/// @brief Asset archive. Pass to Assets::init()" << std::endl
+               << "extern \"C\" const uint32_t " << symbol << "[];" << std::endl
+               << std::endl
+               << "/// @brief Asset ids for Assets::get()" << std::endl
+               << "namespace " << name << std::endl
+               << "{" << std::endl;
+    uint32_t totalStored = 0;
+    uint32_t totalSize = 0;
+    for (const auto &asset : assets)
+    {
+        char id[16];
+        snprintf(id, sizeof(id), "0x%08X", asset.id);
+        headerFile << "    constexpr uint32_t " << toIdentifier(asset.name) << " = " << id << "; // "
+                   << codecName(asset.entry.codec) << ", " << asset.entry.uncompressedSize << " bytes" << std::endl;
+        printf("%s: %s, %u -> %u bytes\n", asset.name.c_str(), codecName(asset.entry.codec), asset.entry.uncompressedSize, asset.entry.storedSize);
+        totalStored += asset.entry.storedSize;
+        totalSize += asset.entry.uncompressedSize;
+    }
+    headerFile << "}" << std::endl;
+    asmFile << "@ Generated by assetpack. Do not edit." << std::endl
+            << ".section .rodata" << std::endl
+            << ".align 2" << std::endl
+            << ".global " << symbol << std::endl
+            << symbol << ":" << std::endl
+            << ".incbin \"" << output << ".bin\"" << std::endl;
+    printf("Packed %u assets, %u -> %u bytes, archive %u bytes\n", static_cast<uint32_t>(assets.size()), totalSize, totalStored, static_cast<uint32_t>(archive.size()));
+    return 0;
+}
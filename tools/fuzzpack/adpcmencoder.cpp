@@ -0,0 +1,127 @@
+#include "adpcmencoder.h"
+
+#include "compression/adpcm_structs.h"
+#include "compression/adpcm_tables.h"
+#include "sound/adpcmplayer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace Audio
+{
+    int32_t clampSample(int32_t sample)
+    {
+        return std::min(std::max(sample, -32768), 32767);
+    }
+
+    // Apply nibble to predicted sample and step index like the decoders do
+    void applyNibble(int32_t &predicted, int32_t &index, uint32_t nibble)
+    {
+        const int32_t delta = ADPCM_DeltaTable_4bit[index][nibble & 7];
+        predicted = clampSample((nibble & 8) ? predicted - delta : predicted + delta);
+        index = std::min(std::max(index + ADPCM_IndexTable_4bit[nibble & 7], 0), 88);
+    }
+
+    // Encode samplesPerFrame samples of one channel starting at samples[start] into a channel block.
+    // Returns the sum of absolute errors
+    uint64_t encodeBlock(std::vector<uint8_t> &block, const std::vector<int16_t> &samples, uint32_t start, uint32_t samplesPerFrame, int32_t &index)
+    {
+        auto sampleAt = [&samples](uint32_t i) -> int32_t
+        { return i < samples.size() ? samples[i] : 0; };
+        // first sample is stored verbatim
+        int32_t predicted = sampleAt(start);
+        block.push_back(predicted & 0xFF);
+        block.push_back((predicted >> 8) & 0xFF);
+        block.push_back(index);
+        block.push_back(0);
+        // two nibbles per byte, low nibble first. the high nibble of the last byte stays 0
+        std::vector<uint8_t> nibbles(samplesPerFrame / 2, 0);
+        uint64_t totalError = 0;
+        for (uint32_t i = 1; i < samplesPerFrame; ++i)
+        {
+            const int32_t target = sampleAt(start + i);
+            uint32_t bestNibble = 0;
+            int32_t bestError = INT32_MAX;
+            for (uint32_t nibble = 0; nibble < 16; ++nibble)
+            {
+                int32_t candidate = predicted;
+                int32_t candidateIndex = index;
+                applyNibble(candidate, candidateIndex, nibble);
+                const int32_t error = std::abs(target - candidate);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestNibble = nibble;
+                }
+            }
+            applyNibble(predicted, index, bestNibble);
+            totalError += bestError;
+            nibbles[(i - 1) / 2] |= bestNibble << (((i - 1) & 1) * 4);
+        }
+        block.insert(block.end(), nibbles.cbegin(), nibbles.cend());
+        return totalError;
+    }
+
+    // Encode the first block of a channel. There is no step index to carry over yet, so use the one with the smallest error
+    void encodeFirstBlock(std::vector<uint8_t> &block, const std::vector<int16_t> &samples, uint32_t samplesPerFrame, int32_t &index)
+    {
+        int32_t bestIndex = 0;
+        uint64_t bestError = UINT64_MAX;
+        for (int32_t startIndex = 0; startIndex <= 88; ++startIndex)
+        {
+            std::vector<uint8_t> candidate;
+            int32_t candidateIndex = startIndex;
+            const uint64_t error = encodeBlock(candidate, samples, 0, samplesPerFrame, candidateIndex);
+            if (error < bestError)
+            {
+                bestError = error;
+                bestIndex = startIndex;
+            }
+        }
+        index = bestIndex;
+        encodeBlock(block, samples, 0, samplesPerFrame, index);
+    }
+
+    auto AdpcmEncodeStream(const std::vector<std::vector<int16_t>> &channels, uint32_t sampleRate, uint32_t samplesPerFrame) -> std::vector<uint8_t>
+    {
+        const uint32_t nrOfChannels = channels.size();
+        if (nrOfChannels < 1 || nrOfChannels > 2 || (nrOfChannels == 2 && channels[0].size() != channels[1].size()) ||
+            samplesPerFrame < 32 || samplesPerFrame > AdpcmPlayer::MaxSamplesPerFrame || (samplesPerFrame & 15) != 0 || sampleRate == 0)
+        {
+            return {};
+        }
+        const uint32_t nrOfSamples = channels[0].size();
+        AdpcmPlayer::StreamHeader header = {};
+        header.magic = AdpcmPlayer::StreamMagic;
+        header.sampleRate = sampleRate;
+        header.nrOfFrames = (nrOfSamples + samplesPerFrame - 1) / samplesPerFrame;
+        header.frameSize = ADPCM_FRAMEHEADER_SIZE + nrOfChannels * (4 + samplesPerFrame / 2);
+        header.samplesPerFrame = samplesPerFrame;
+        header.nrOfChannels = nrOfChannels;
+        std::vector<uint8_t> result(sizeof(header));
+        memcpy(result.data(), &header, sizeof(header));
+        int32_t index[2] = {0, 0};
+        for (uint32_t frame = 0; frame < header.nrOfFrames; ++frame)
+        {
+            // frame header: channels, 16 bits per source sample, source size in bytes
+            const uint32_t frameHeader = (nrOfChannels << 5) | (16 << 7) | ((samplesPerFrame * nrOfChannels * 2) << 16);
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                result.push_back((frameHeader >> (8 * i)) & 0xFF);
+            }
+            for (uint32_t channel = 0; channel < nrOfChannels; ++channel)
+            {
+                if (frame == 0)
+                {
+                    encodeFirstBlock(result, channels[channel], samplesPerFrame, index[channel]);
+                }
+                else
+                {
+                    encodeBlock(result, channels[channel], frame * samplesPerFrame, samplesPerFrame, index[channel]);
+                }
+            }
+        }
+        return result;
+    }
+}
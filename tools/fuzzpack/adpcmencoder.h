@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Audio
+{
+    /// @brief Encode 16-bit PCM to an IMA ADPCM stream for AdpcmPlayer::play(). Every frame stores one block per channel
+    /// with the first sample verbatim and the step index carried over from the previous frame. Nibbles are picked to
+    /// minimize the error of the next sample. The last frame is padded with silence.
+    /// @param channels PCM samples per channel. 1 or 2 channels of the same length
+    /// @param sampleRate Samples per second and channel
+    /// @param samplesPerFrame Samples per channel in a frame. Multiple of 16, 32 - AdpcmPlayer::MaxSamplesPerFrame
+    /// @return Stream data starting with an AdpcmPlayer::StreamHeader. Empty if the arguments are invalid
+    auto AdpcmEncodeStream(const std::vector<std::vector<int16_t>> &channels, uint32_t sampleRate, uint32_t samplesPerFrame) -> std::vector<uint8_t>;
+}
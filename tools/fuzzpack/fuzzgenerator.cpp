@@ -0,0 +1,419 @@
+#include "fuzzgenerator.h"
+
+#include "../lz4pack/lz4encoder.h"
+#include "../ranspack/ransencoder.h"
+#include "adpcmencoder.h"
+
+#include "compression/adpcm.h"
+#include "compression/adpcm_structs.h"
+#include "compression/adpcm_tables.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Fuzz
+{
+    // xorshift32. Generates the same sequence on every platform, unlike the std distributions
+    class Random
+    {
+    public:
+        explicit Random(uint32_t seed) : m_state(seed != 0 ? seed : 0x9E3779B9) {}
+
+        uint32_t next()
+        {
+            m_state ^= m_state << 13;
+            m_state ^= m_state >> 17;
+            m_state ^= m_state << 5;
+            return m_state;
+        }
+
+        // Random value in [0, range)
+        uint32_t below(uint32_t range) { return range > 0 ? next() % range : 0; }
+
+        // Random value in [first, last]
+        uint32_t between(uint32_t first, uint32_t last) { return first + below(last - first + 1); }
+
+        // Random value in [1, max] with a uniformly distributed number of bits, so small values are as common as large ones
+        uint32_t logUniform(uint32_t max)
+        {
+            uint32_t bits = 0;
+            while ((1U << bits) < max)
+            {
+                bits++;
+            }
+            return between(1, std::min(max, 1U << below(bits + 1)));
+        }
+
+    private:
+        uint32_t m_state;
+    };
+
+    void appendWord(std::vector<uint8_t> &data, uint32_t value)
+    {
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            data.push_back((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    void padTo4(std::vector<uint8_t> &data)
+    {
+        while ((data.size() & 3) != 0)
+        {
+            data.push_back(0);
+        }
+    }
+
+    std::vector<uint8_t> randomBytes(Random &random, uint32_t size)
+    {
+        std::vector<uint8_t> data(size);
+        for (auto &v : data)
+        {
+            v = random.next() >> 24;
+        }
+        return data;
+    }
+
+    // Data with a skewed byte distribution, runs and repeats of earlier data at random distances, like real assets
+    std::vector<uint8_t> randomData(Random &random, uint32_t size)
+    {
+        std::vector<uint8_t> data;
+        const uint32_t alphabet = random.between(2, 256);
+        while (data.size() < size)
+        {
+            const uint32_t length = std::min<uint32_t>(random.logUniform(300), size - data.size());
+            const uint32_t mode = random.below(4);
+            if (mode == 0 && !data.empty())
+            {
+                // repeat earlier data. distances < length overlap
+                const uint32_t distance = random.logUniform(std::min<uint32_t>(data.size(), 65535));
+                for (uint32_t i = 0; i < length; ++i)
+                {
+                    data.push_back(data[data.size() - distance]);
+                }
+            }
+            else if (mode == 1)
+            {
+                data.insert(data.end(), length, random.below(alphabet));
+            }
+            else
+            {
+                for (uint32_t i = 0; i < length; ++i)
+                {
+                    // squaring makes small symbols more likely
+                    const uint32_t r = random.below(alphabet);
+                    data.push_back((r * r) / alphabet);
+                }
+            }
+        }
+        return data;
+    }
+
+    // Builds LZ4 40h data sequence by sequence and tracks the decoded output as reference.
+    // Can produce token and length byte combinations LZ4Compress() never emits
+    class LZ4Builder
+    {
+    public:
+        // Append literals, then a match of length bytes at distance. length = 0 for no match, else length >= 4 and 1 <= distance <= min(size(), 65535)
+        void sequence(const std::vector<uint8_t> &literals, uint32_t distance = 0, uint32_t length = 0)
+        {
+            const uint32_t literalLength = literals.size();
+            const uint32_t matchCode = length > 0 ? length - 3 : 0;
+            m_stream.push_back((std::min<uint32_t>(literalLength, 15) << 4) | std::min<uint32_t>(matchCode, 15));
+            if (literalLength >= 15)
+            {
+                writeLength(literalLength - 15);
+            }
+            m_stream.insert(m_stream.end(), literals.cbegin(), literals.cend());
+            m_output.insert(m_output.end(), literals.cbegin(), literals.cend());
+            if (length > 0)
+            {
+                m_stream.push_back(distance >> 8);
+                m_stream.push_back(distance & 0xFF);
+                if (matchCode >= 15)
+                {
+                    writeLength(matchCode - 15);
+                }
+                // copy byte by byte, so overlapping matches repeat the data
+                for (uint32_t i = 0; i < length; ++i)
+                {
+                    m_output.push_back(m_output[m_output.size() - distance]);
+                }
+            }
+        }
+
+        uint32_t size() const { return m_output.size(); }
+
+        Case build(CaseKind kind) const
+        {
+            Case result = {CaseType::LZ4, kind, {}, m_output};
+            appendWord(result.input, static_cast<uint32_t>(CaseType::LZ4) | (size() << 8));
+            result.input.insert(result.input.end(), m_stream.cbegin(), m_stream.cend());
+            padTo4(result.input);
+            return result;
+        }
+
+    private:
+        void writeLength(uint32_t length)
+        {
+            for (; length >= 255; length -= 255)
+            {
+                m_stream.push_back(255);
+            }
+            m_stream.push_back(length);
+        }
+
+        std::vector<uint8_t> m_stream;
+        std::vector<uint8_t> m_output;
+    };
+
+    void addLZ4Cases(std::vector<Case> &cases, Random &random, uint32_t nrOfRandomCases, uint32_t maxSize)
+    {
+        // runs and repeating patterns of every short distance with lengths around the token and extension boundaries
+        const uint32_t Distances[] = {1, 2, 3, 4, 5, 6, 7, 8, 15, 16, 17, 31, 32, 33};
+        const uint32_t Lengths[] = {4, 5, 6, 7, 8, 17, 18, 19, 20, 31, 32, 33, 272, 273, 274, 1000};
+        for (const auto distance : Distances)
+        {
+            LZ4Builder builder;
+            builder.sequence(randomBytes(random, distance));
+            for (uint32_t i = 0; i < sizeof(Lengths) / sizeof(Lengths[0]); ++i)
+            {
+                // 0-3 literals in between, so matches start at every destination alignment
+                builder.sequence(randomBytes(random, i & 3), distance, Lengths[i]);
+            }
+            cases.push_back(builder.build(CaseKind::OverlappingMatch));
+        }
+        // literal-only data, up to runs that need hundreds of extension bytes
+        const uint32_t LiteralLengths[] = {14, 15, 16, 269, 270, 271, 524, 525, 526, 65535, 70000};
+        for (const auto length : LiteralLengths)
+        {
+            LZ4Builder builder;
+            builder.sequence(randomBytes(random, length));
+            cases.push_back(builder.build(CaseKind::LiteralRun));
+        }
+        // literal and match lengths whose extension bytes end in 0 after 255s, plus sequences without literals
+        {
+            const uint32_t ExtremeLiterals[] = {0, 15, 16, 269, 270, 271, 525};
+            const uint32_t ExtremeMatches[] = {18, 19, 272, 273, 274, 528, 529};
+            LZ4Builder builder;
+            builder.sequence(randomBytes(random, 1));
+            for (const auto literals : ExtremeLiterals)
+            {
+                for (const auto length : ExtremeMatches)
+                {
+                    builder.sequence(randomBytes(random, literals), random.between(1, std::min<uint32_t>(builder.size(), 65535)), length);
+                }
+            }
+            cases.push_back(builder.build(CaseKind::ExtremeLength));
+        }
+        // matches at the largest distances the 16 bit offset can hold
+        {
+            LZ4Builder builder;
+            builder.sequence(randomBytes(random, 65535));
+            builder.sequence({}, 65535, 4);
+            builder.sequence(randomBytes(random, 1), 65535, 300);
+            builder.sequence({}, 65534, 19);
+            builder.sequence({}, 256, 16);
+            builder.sequence({}, 255, 5);
+            cases.push_back(builder.build(CaseKind::FarMatch));
+        }
+        // empty data, 1-8 literals and the smallest match
+        for (uint32_t size = 0; size <= 8; ++size)
+        {
+            LZ4Builder builder;
+            if (size > 0)
+            {
+                builder.sequence(randomBytes(random, size));
+            }
+            cases.push_back(builder.build(CaseKind::Tiny));
+        }
+        {
+            LZ4Builder builder;
+            builder.sequence(randomBytes(random, 1), 1, 4);
+            cases.push_back(builder.build(CaseKind::Tiny));
+        }
+        // random sequences, then encoder output for random data
+        for (uint32_t i = 0; i < nrOfRandomCases; ++i)
+        {
+            const uint32_t size = random.logUniform(maxSize);
+            if (i & 1)
+            {
+                const auto data = randomData(random, size);
+                cases.push_back({CaseType::LZ4, CaseKind::Random, Compression::LZ4Compress(data), data});
+                continue;
+            }
+            LZ4Builder builder;
+            builder.sequence(randomBytes(random, random.logUniform(40)));
+            while (builder.size() < size)
+            {
+                const uint32_t literals = random.below(3) == 0 ? 0 : random.logUniform(300);
+                const uint32_t distance = random.logUniform(std::min<uint32_t>(builder.size(), 65535));
+                builder.sequence(randomBytes(random, literals), distance, 3 + random.logUniform(600));
+            }
+            cases.push_back(builder.build(CaseKind::Random));
+        }
+    }
+
+    void addRANSCases(std::vector<Case> &cases, Random &random, uint32_t nrOfRandomCases, uint32_t maxSize)
+    {
+        for (uint32_t size = 1; size <= 5; ++size)
+        {
+            const auto data = randomBytes(random, size);
+            cases.push_back({CaseType::RANS, CaseKind::Tiny, Compression::RANSCompress(data), data});
+        }
+        // one symbol with all of the probability
+        const std::vector<uint8_t> run(10000, random.next() >> 24);
+        cases.push_back({CaseType::RANS, CaseKind::LiteralRun, Compression::RANSCompress(run), run});
+        for (uint32_t i = 0; i < nrOfRandomCases; ++i)
+        {
+            const auto data = randomData(random, random.logUniform(maxSize));
+            if (i & 1)
+            {
+                cases.push_back({CaseType::RANSLZ4, CaseKind::Random, Compression::RANSLZ4Compress(data), data});
+            }
+            else
+            {
+                cases.push_back({CaseType::RANS, CaseKind::Random, Compression::RANSCompress(data), data});
+            }
+        }
+    }
+
+    // ADPCM channel block: initial sample, index, then blockSize - 4 bytes of nibbles
+    std::vector<uint8_t> adpcmBlock(int16_t sample, uint16_t index, const std::vector<uint8_t> &nibbles)
+    {
+        std::vector<uint8_t> block = {static_cast<uint8_t>(sample & 0xFF), static_cast<uint8_t>((sample >> 8) & 0xFF), static_cast<uint8_t>(index), 0};
+        block.insert(block.end(), nibbles.cbegin(), nibbles.cend());
+        return block;
+    }
+
+    // References are added by generateCases()
+    void addAdpcmCase(std::vector<Case> &cases, CaseKind kind, const std::vector<uint8_t> &left, const std::vector<uint8_t> &right)
+    {
+        cases.push_back({CaseType::AdpcmMono, kind, left, {}});
+        auto stereo = left;
+        stereo.insert(stereo.end(), right.cbegin(), right.cend());
+        cases.push_back({CaseType::AdpcmStereo, kind, stereo, {}});
+        cases.push_back({CaseType::AdpcmPlanar, kind, stereo, {}});
+    }
+
+    void addAdpcmCases(std::vector<Case> &cases, Random &random, uint32_t nrOfRandomCases)
+    {
+        // climb to and stay at the limits with the largest steps
+        addAdpcmCase(cases, CaseKind::Saturate, adpcmBlock(32767, 88, std::vector<uint8_t>(256, 0x77)), adpcmBlock(-32768, 88, std::vector<uint8_t>(256, 0xFF)));
+        addAdpcmCase(cases, CaseKind::Saturate, adpcmBlock(-32000, 60, std::vector<uint8_t>(256, 0xFF)), adpcmBlock(32000, 60, std::vector<uint8_t>(256, 0x77)));
+        // swing between the limits
+        addAdpcmCase(cases, CaseKind::Saturate, adpcmBlock(0, 88, std::vector<uint8_t>(256, 0xF7)), adpcmBlock(0, 88, std::vector<uint8_t>(256, 0x7F)));
+        // step index below 0, then up to and above 88, then down again
+        {
+            std::vector<uint8_t> nibbles(40, 0x80);
+            nibbles.insert(nibbles.end(), 40, 0x77);
+            nibbles.insert(nibbles.end(), 40, 0x08);
+            std::vector<uint8_t> reversed(nibbles.crbegin(), nibbles.crend());
+            addAdpcmCase(cases, CaseKind::IndexLimits, adpcmBlock(0, 0, nibbles), adpcmBlock(0, 88, reversed));
+        }
+        // blocks with 1 and 2 bytes of nibbles
+        addAdpcmCase(cases, CaseKind::Tiny, adpcmBlock(1234, 10, {0x3C}), adpcmBlock(-1234, 20, {0xC3}));
+        addAdpcmCase(cases, CaseKind::Tiny, adpcmBlock(-1, 88, {0x77, 0x77}), adpcmBlock(0, 0, {0x00, 0x88}));
+        for (uint32_t i = 0; i < nrOfRandomCases; ++i)
+        {
+            const uint32_t nrOfNibbleBytes = random.between(1, 1024);
+            const int16_t leftSample = random.next() >> 16;
+            const int16_t rightSample = random.next() >> 16;
+            addAdpcmCase(cases, CaseKind::Random, adpcmBlock(leftSample, random.below(89), randomBytes(random, nrOfNibbleBytes)), adpcmBlock(rightSample, random.below(89), randomBytes(random, nrOfNibbleBytes)));
+        }
+    }
+
+    // Decode ADPCM case number caseIndex with the C decoders. See fuzzvectors.h for the reference layout
+    std::vector<uint8_t> adpcmReference(const Case &c, uint32_t caseIndex)
+    {
+        const uint32_t nrOfChannels = c.type == CaseType::AdpcmMono ? 1 : 2;
+        const uint32_t channelSize = 2 * (c.input.size() / nrOfChannels - 4);
+        const uint32_t paddedSize = (channelSize + 3) & ~3;
+        // frame header with 16 bits per sample, then the channel blocks
+        std::vector<uint32_t> frame(1 + (c.input.size() + 3) / 4, 0);
+        frame[0] = (nrOfChannels << 5) | (16 << 7);
+        memcpy(frame.data() + 1, c.input.data(), c.input.size());
+        const uint32_t frameSize = ADPCM_FRAMEHEADER_SIZE + c.input.size();
+        std::vector<uint32_t> output(nrOfChannels * paddedSize / 4, OutputGuard);
+        getAdpcmDitherState(caseIndex, ADPCM_DitherState);
+        if (c.type == CaseType::AdpcmStereo)
+        {
+            Adpcm::UnCompWriteStereo32bit_8bit(frame.data(), frameSize, output.data(), output.data() + paddedSize / 4);
+        }
+        else
+        {
+            Adpcm::UnCompWrite32bit_8bit(frame.data(), frameSize, output.data());
+        }
+        std::vector<uint8_t> reference(output.size() * 4);
+        memcpy(reference.data(), output.data(), reference.size());
+        appendWord(reference, ADPCM_DitherState[0]);
+        appendWord(reference, ADPCM_DitherState[1]);
+        return reference;
+    }
+
+    // Sine tone of frequency Hz with amplitude at sampleRate
+    std::vector<int16_t> tone(uint32_t nrOfSamples, uint32_t sampleRate, double frequency, double amplitude)
+    {
+        std::vector<int16_t> samples(nrOfSamples);
+        for (uint32_t i = 0; i < nrOfSamples; ++i)
+        {
+            samples[i] = static_cast<int16_t>(std::lround(amplitude * std::sin(2 * M_PI * frequency * i / sampleRate)));
+        }
+        return samples;
+    }
+
+    void addAdpcmStreamCases(std::vector<Case> &cases)
+    {
+        // short mono and stereo streams for AdpcmPlayer. the last frame is only partially filled
+        constexpr uint32_t SampleRate = 16384;
+        constexpr uint32_t SamplesPerFrame = 256;
+        constexpr uint32_t NrOfSamples = 7 * SamplesPerFrame + 100;
+        const auto mono = Audio::AdpcmEncodeStream({tone(NrOfSamples, SampleRate, 440, 12000)}, SampleRate, SamplesPerFrame);
+        cases.push_back({CaseType::AdpcmStream, CaseKind::Tone, mono, {}});
+        const auto stereo = Audio::AdpcmEncodeStream({tone(NrOfSamples, SampleRate, 440, 12000), tone(NrOfSamples, SampleRate, 660, 20000)}, SampleRate, SamplesPerFrame);
+        cases.push_back({CaseType::AdpcmStream, CaseKind::Tone, stereo, {}});
+    }
+
+    auto generateCases(uint32_t seed, uint32_t nrOfRandomCases, uint32_t maxSize) -> std::vector<Case>
+    {
+        Random random(seed);
+        std::vector<Case> cases;
+        addLZ4Cases(cases, random, nrOfRandomCases, maxSize);
+        addRANSCases(cases, random, nrOfRandomCases, maxSize);
+        addAdpcmCases(cases, random, nrOfRandomCases);
+        addAdpcmStreamCases(cases);
+        // the dither state depends on the case number, so references can only be computed once all cases are there
+        for (uint32_t i = 0; i < cases.size(); ++i)
+        {
+            const auto type = cases[i].type;
+            if (type == CaseType::AdpcmMono || type == CaseType::AdpcmStereo || type == CaseType::AdpcmPlanar)
+            {
+                cases[i].reference = adpcmReference(cases[i], i);
+            }
+        }
+        return cases;
+    }
+
+    auto writeVectors(const std::vector<Case> &cases, uint32_t seed) -> std::vector<uint8_t>
+    {
+        std::vector<uint8_t> result;
+        appendWord(result, VectorMagic);
+        appendWord(result, cases.size());
+        appendWord(result, seed);
+        for (const auto &c : cases)
+        {
+            result.push_back(static_cast<uint8_t>(c.type));
+            result.push_back(static_cast<uint8_t>(c.kind));
+            result.push_back(0);
+            result.push_back(0);
+            appendWord(result, c.input.size());
+            appendWord(result, c.reference.size());
+            result.insert(result.end(), c.input.cbegin(), c.input.cend());
+            padTo4(result);
+            result.insert(result.end(), c.reference.cbegin(), c.reference.cend());
+            padTo4(result);
+        }
+        return result;
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "fuzzvectors.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Fuzz
+{
+    /// @brief Test case for the decoders
+    struct Case
+    {
+        CaseType type;
+        CaseKind kind;
+        std::vector<uint8_t> input;     // Compressed data or ADPCM channel blocks
+        std::vector<uint8_t> reference; // Expected output. Empty for ADPCM streams
+    };
+
+    /// @brief Generate the fixed pathological cases and nrOfRandomCases random cases.
+    /// The output only depends on the arguments, so vectors can be regenerated from the seed
+    /// @param seed Random seed
+    /// @param nrOfRandomCases Number of random cases per data type
+    /// @param maxSize Maximum uncompressed size of random cases in bytes
+    auto generateCases(uint32_t seed, uint32_t nrOfRandomCases, uint32_t maxSize = 16384) -> std::vector<Case>;
+
+    /// @brief Build vector file from cases. See fuzzvectors.h for the format
+    auto writeVectors(const std::vector<Case> &cases, uint32_t seed) -> std::vector<uint8_t>;
+}
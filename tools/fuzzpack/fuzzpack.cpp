@@ -0,0 +1,100 @@
+// Generates random and pathological test vectors for the LZ4, rANS and ADPCM decoders and writes them as a ROM file
+// for Test::fuzz() in test/gba. Normally run from gba_add_fuzz_vectors() in cmake/FuzzGBA.cmake.
+
+#include "fuzzgenerator.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+void printUsage()
+{
+    std::cout << "Generate decoder test vectors for the GBA." << std::endl;
+    std::cout << "Usage: fuzzpack [--seed SEED] [--count COUNT] [--size SIZE] OUTPUT" << std::endl;
+    std::cout << "--seed SEED: Random seed. The same seed always generates the same vectors (default: 1)." << std::endl;
+    std::cout << "--count COUNT: Number of random cases per data type in addition to the fixed cases (default: 32)." << std::endl;
+    std::cout << "--size SIZE: Maximum uncompressed size of random cases in bytes (default: 16384)." << std::endl;
+    std::cout << "OUTPUT: Output path and name. Writes OUTPUT.bin, OUTPUT.h and OUTPUT.s. For OUTPUT = path/NAME" << std::endl;
+    std::cout << "the vector symbol is NAME_vectors." << std::endl;
+}
+
+int main(int argc, const char *argv[])
+{
+    uint32_t seed = 1;
+    uint32_t count = 32;
+    uint32_t maxSize = 16384;
+    std::string output;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = strtoul(argv[++i], nullptr, 0);
+        }
+        else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+        {
+            count = strtoul(argv[++i], nullptr, 0);
+        }
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+        {
+            maxSize = strtoul(argv[++i], nullptr, 0);
+        }
+        else if (output.empty())
+        {
+            output = argv[i];
+        }
+        else
+        {
+            output.clear();
+            break;
+        }
+    }
+    if (output.empty() || maxSize == 0 || maxSize >= (1 << 24))
+    {
+        printUsage();
+        return 1;
+    }
+    const auto cases = Fuzz::generateCases(seed, count, maxSize);
+    const auto vectors = Fuzz::writeVectors(cases, seed);
+    // write vectors, header and assembler file
+    const auto slash = output.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? output : output.substr(slash + 1);
+    for (auto &c : name)
+    {
+        c = isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+    const std::string symbol = name + "_vectors";
+    std::ofstream binFile(output + ".bin", std::ios::binary);
+    if (!binFile.is_open() || !binFile.write(reinterpret_cast<const char *>(vectors.data()), vectors.size()))
+    {
+        std::cerr << "Failed to write " << output << ".bin" << std::endl;
+        return 1;
+    }
+    std::ofstream headerFile(output + ".h");
+    std::ofstream asmFile(output + ".s");
+    if (!headerFile.is_open() || !asmFile.is_open())
+    {
+        std::cerr << "Failed to write " << output << ".h / .s" << std::endl;
+        return 1;
+    }
+    headerFile << "#pragma once" << std::endl
+               << std::endl
+               << "// Generated by fuzzpack. Do not edit." << std::endl
+               << std::endl
+               << "#include <cstdint>" << std::endl
+               << std::endl
+               << "/// @brief Decoder test vectors, " << cases.size() << " cases, seed " << seed << ". See tools/fuzzpack/fuzzvectors.h" << std::endl
+               << "extern \"C\" const uint32_t " << symbol << "[];" << std::endl;
+    asmFile << "@ Generated by fuzzpack. Do not edit." << std::endl
+            << ".section .rodata" << std::endl
+            << ".align 2" << std::endl
+            << ".global " << symbol << std::endl
+            << symbol << ":" << std::endl
+            << ".incbin \"" << output << ".bin\"" << std::endl;
+    printf("Generated %u cases with seed %u, %u bytes\n", static_cast<uint32_t>(cases.size()), seed, static_cast<uint32_t>(vectors.size()));
+    return 0;
+}
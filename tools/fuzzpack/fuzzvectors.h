@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+
+// Decoder test vectors generated by fuzzpack and run by Test::fuzz() in test/gba.
+// A vector file is a VectorHeader followed by nrOfCases cases. Every case is a CaseHeader followed by the input data
+// and the reference output, both padded to a multiple of 4 bytes.
+// ADPCM cases are decoded from a frame with a 4 byte frame header and the input as channel blocks. Their reference is
+// the output of the C decoders per output buffer, each padded to 4 bytes, followed by the two words of
+// ADPCM_DitherState after decoding. Decoding starts with the dither state from getAdpcmDitherState().
+namespace Fuzz
+{
+    /// @brief Vector file magic "FUZZ"
+    constexpr uint32_t VectorMagic = 0x5A5A5546;
+
+    /// @brief Value output buffers are filled with before decoding. Bytes the decoders skip, like the padding between
+    /// planar stereo channels, have this value in the reference output too
+    constexpr uint32_t OutputGuard = 0xEEEEEEEE;
+
+    /// @brief Data type of a case. Decides which decoders run on it
+    enum class CaseType : uint8_t
+    {
+        LZ4 = 0x40,        // LZ4 40h data. Reference is the uncompressed data
+        RANS = 0x50,       // rANS 50h data. Reference is the uncompressed data
+        RANSLZ4 = 0x51,     // LZ4 + rANS 51h data. Reference is the uncompressed data
+        AdpcmMono = 0xA1,   // One ADPCM channel block: Initial sample, index and nibbles. Reference is one output buffer
+        AdpcmStereo = 0xA2, // Two ADPCM channel blocks of the same size decoded in lockstep. Reference is the left and right output buffer
+        AdpcmStream = 0xA3, // ADPCM stream for AdpcmPlayer::play() starting with an AdpcmPlayer::StreamHeader. No reference
+        AdpcmPlanar = 0xA4  // Two ADPCM channel blocks like AdpcmStereo, decoded planar by the mono decoders. Reference is one output
+                            // buffer with the right channel at the next word boundary after the left channel
+    };
+
+    /// @brief What a case stresses
+    enum class CaseKind : uint8_t
+    {
+        Random = 0,           // Random data or random sequences
+        OverlappingMatch = 1, // Long matches with a distance smaller than the length, e.g. runs
+        LiteralRun = 2,       // Long literal runs without matches
+        ExtremeLength = 3,    // Length extension bytes of 0 and 255 around the 15 / 270 boundaries
+        FarMatch = 4,         // Matches at distances up to 65535
+        Tiny = 5,             // Smallest possible data
+        Saturate = 6,         // ADPCM data driving the predictor into the 16 bit limits
+        IndexLimits = 7,      // ADPCM data driving the step index into 0 and 88
+        Tone = 8              // Encoded sine tones
+    };
+
+    /// @brief Number of case kinds
+    constexpr uint32_t NrOfCaseKinds = 9;
+
+    /// @brief Vector file header
+    struct VectorHeader
+    {
+        uint32_t magic;     // VectorMagic
+        uint32_t nrOfCases; // Number of cases following
+        uint32_t seed;      // Random seed the vectors were generated with
+    } __attribute__((aligned(4), packed));
+
+    /// @brief Case header. Followed by input data and reference output
+    struct CaseHeader
+    {
+        CaseType type;
+        CaseKind kind;
+        uint16_t padding;
+        uint32_t inputSize;     // Size of input data in bytes, without padding
+        uint32_t referenceSize; // Size of reference output in bytes, without padding. 0 for ADPCM streams
+    } __attribute__((aligned(4), packed));
+
+    /// @brief Get the dither state the ADPCM decoders start with for case number caseIndex
+    inline void getAdpcmDitherState(uint32_t caseIndex, uint32_t state[2])
+    {
+        state[0] = caseIndex & 0xFF;
+        state[1] = caseIndex * 0x9E3779B9;
+    }
+}
@@ -0,0 +1,280 @@
+#include "lz4encoder.h"
+
+#include "compression/lz4_constants.h"
+
+#include <limits>
+
+namespace Compression
+{
+    constexpr uint32_t MaxMatchDistance = 65535;
+    constexpr uint32_t HashBits = 16;
+    // Matches at least this long are only tried at full length and short lengths and no matches are searched inside them,
+    // so long runs don't make parsing quadratic
+    constexpr uint32_t SufficientMatchLength = 256;
+
+    // Number of extra length bytes for a literal or match length nibble value
+    inline uint32_t extraLengthBytes(uint32_t length)
+    {
+        return length < Lz4Constants::LENGTH_MASK ? 0 : (length - Lz4Constants::LENGTH_MASK) / 255 + 1;
+    }
+
+    inline uint32_t hash4(const uint8_t *data)
+    {
+        const uint32_t value = data[0] | (data[1] << 8) | (data[2] << 16) | (uint32_t(data[3]) << 24);
+        return (value * 2654435761U) >> (32 - HashBits);
+    }
+
+    // Cost of a literal run of length literalLength, excluding the token
+    inline double literalRunCost(uint32_t literalLength, const LZ4EncodeOptions &options)
+    {
+        if (literalLength == 0)
+        {
+            return 0;
+        }
+        const auto &model = options.costModel;
+        const uint32_t extraBytes = extraLengthBytes(literalLength);
+        const double bytes = literalLength + extraBytes;
+        const double cycles = model.literalRunCycles + literalLength * model.literalByteCycles + extraBytes * model.extraLengthByteCycles;
+        return bytes + options.speedWeight * cycles;
+    }
+
+    // Cost of a match including its token
+    inline double matchCost(uint32_t length, uint32_t distance, const LZ4EncodeOptions &options)
+    {
+        const auto &model = options.costModel;
+        const uint32_t extraBytes = extraLengthBytes(length - (Lz4Constants::MIN_MATCH_LENGTH - 1));
+        const double bytes = 1 + 2 + extraBytes;
+        const double byteCycles = distance <= 2 ? model.runByteCycles : model.matchByteCycles;
+        const double cycles = model.tokenCycles + model.matchCycles + length * byteCycles + extraBytes * model.extraLengthByteCycles;
+        return bytes + options.speedWeight * cycles;
+    }
+
+    uint8_t *writeLength(uint8_t *out, uint32_t length)
+    {
+        for (length -= Lz4Constants::LENGTH_MASK; length >= 255; length -= 255)
+        {
+            *out++ = 255;
+        }
+        *out++ = length;
+        return out;
+    }
+
+    auto LZ4Compress(const std::vector<uint8_t> &data, const LZ4EncodeOptions &options) -> std::vector<uint8_t>
+    {
+        const uint32_t size = data.size();
+        const uint32_t maxDistance = options.maxDistance < MaxMatchDistance ? options.maxDistance : MaxMatchDistance;
+        // find optimal parse. node i is reached with a literal run of literalLength bytes, or by a match ending at i.
+        // the cost of a literal run depends on its length, so when appending a literal the whole run is re-priced
+        struct Node
+        {
+            double cost = std::numeric_limits<double>::max();
+            uint32_t literalLength = 0; // Literal run length before this node, if reached by literal
+            uint32_t matchLength = 0;   // Length of match ending here, 0 if reached by literal
+            uint32_t matchDistance = 0; // Distance of match ending here
+            double costBeforeRun = 0;   // Cost at start of literal run
+        };
+        std::vector<Node> nodes(size + 1);
+        nodes[0].cost = 0;
+        // hash chains of positions with the same 4 byte prefix
+        std::vector<int32_t> head(1 << HashBits, -1);
+        std::vector<int32_t> chain(size, -1);
+        uint32_t skipUntil = 0;
+        for (uint32_t pos = 0; pos < size; ++pos)
+        {
+            const auto &node = nodes[pos];
+            // append a literal to the run ending here
+            {
+                const uint32_t runLength = node.matchLength > 0 || pos == 0 ? 1 : node.literalLength + 1;
+                const double runStart = node.matchLength > 0 || pos == 0 ? node.cost : node.costBeforeRun;
+                const double cost = runStart + literalRunCost(runLength, options);
+                auto &next = nodes[pos + 1];
+                if (cost < next.cost)
+                {
+                    next.cost = cost;
+                    next.literalLength = runLength;
+                    next.matchLength = 0;
+                    next.costBeforeRun = runStart;
+                }
+            }
+            if (pos + Lz4Constants::MIN_MATCH_LENGTH > size)
+            {
+                continue;
+            }
+            const uint32_t hash = hash4(&data[pos]);
+            if (pos < skipUntil)
+            {
+                chain[pos] = head[hash];
+                head[hash] = pos;
+                continue;
+            }
+            // matches start a new sequence, so the cost of the preceding literal run is already in node.cost
+            uint32_t bestLength = Lz4Constants::MIN_MATCH_LENGTH - 1;
+            uint32_t nrOfCandidates = 0;
+            for (int32_t candidate = head[hash]; candidate >= 0 && pos - candidate <= maxDistance && nrOfCandidates < options.maxCandidates; candidate = chain[candidate], ++nrOfCandidates)
+            {
+                if (pos + bestLength >= size || data[candidate + bestLength] != data[pos + bestLength])
+                {
+                    continue;
+                }
+                uint32_t length = 0;
+                while (pos + length < size && data[candidate + length] == data[pos + length])
+                {
+                    length++;
+                }
+                if (length <= bestLength)
+                {
+                    continue;
+                }
+                // candidates are visited closest first, so every length up to bestLength already has a closer match
+                const uint32_t distance = pos - candidate;
+                for (uint32_t matchLength = bestLength + 1; matchLength <= length; ++matchLength)
+                {
+                    if (length >= SufficientMatchLength && matchLength > 18 && matchLength < length)
+                    {
+                        matchLength = length;
+                    }
+                    const double cost = node.cost + matchCost(matchLength, distance, options);
+                    auto &next = nodes[pos + matchLength];
+                    if (cost < next.cost)
+                    {
+                        next.cost = cost;
+                        next.literalLength = 0;
+                        next.matchLength = matchLength;
+                        next.matchDistance = distance;
+                    }
+                }
+                bestLength = length;
+                if (pos + bestLength >= size || bestLength >= SufficientMatchLength)
+                {
+                    skipUntil = bestLength >= SufficientMatchLength ? pos + bestLength : skipUntil;
+                    break;
+                }
+            }
+            chain[pos] = head[hash];
+            head[hash] = pos;
+        }
+        // backtrack to get sequences as (literal length, match length, match distance)
+        struct Sequence
+        {
+            uint32_t literalLength;
+            uint32_t matchLength;
+            uint32_t matchDistance;
+        };
+        std::vector<Sequence> sequences;
+        uint32_t pos = size;
+        uint32_t pendingLiterals = 0;
+        Sequence sequence = {0, 0, 0};
+        while (pos > 0)
+        {
+            const auto &node = nodes[pos];
+            if (node.matchLength > 0)
+            {
+                if (sequence.matchLength > 0 || pendingLiterals > 0)
+                {
+                    sequence.literalLength = pendingLiterals;
+                    sequences.push_back(sequence);
+                }
+                sequence = {0, node.matchLength, node.matchDistance};
+                pendingLiterals = 0;
+                pos -= node.matchLength;
+            }
+            else
+            {
+                pendingLiterals += node.literalLength;
+                pos -= node.literalLength;
+            }
+        }
+        if (sequence.matchLength > 0 || pendingLiterals > 0)
+        {
+            sequence.literalLength = pendingLiterals;
+            sequences.push_back(sequence);
+        }
+        // write header and sequences in reverse order
+        std::vector<uint8_t> result(4 + size + size / 255 + 16 + sequences.size() * 8);
+        result[0] = Lz4Constants::TYPE_MARKER;
+        result[1] = size & 0xFF;
+        result[2] = (size >> 8) & 0xFF;
+        result[3] = (size >> 16) & 0xFF;
+        auto out = result.data() + 4;
+        const uint8_t *literals = data.data();
+        for (auto it = sequences.rbegin(); it != sequences.rend(); ++it)
+        {
+            const uint32_t matchCode = it->matchLength > 0 ? it->matchLength - (Lz4Constants::MIN_MATCH_LENGTH - 1) : 0;
+            const uint32_t literalCode = it->literalLength < Lz4Constants::LENGTH_MASK ? it->literalLength : Lz4Constants::LENGTH_MASK;
+            *out++ = (literalCode << Lz4Constants::LITERAL_LENGTH_SHIFT) | (matchCode < Lz4Constants::LENGTH_MASK ? matchCode : Lz4Constants::LENGTH_MASK);
+            if (it->literalLength >= Lz4Constants::LENGTH_MASK)
+            {
+                out = writeLength(out, it->literalLength);
+            }
+            for (uint32_t i = 0; i < it->literalLength; ++i)
+            {
+                *out++ = *literals++;
+            }
+            if (it->matchLength > 0)
+            {
+                *out++ = it->matchDistance >> 8;
+                *out++ = it->matchDistance & 0xFF;
+                if (matchCode >= Lz4Constants::LENGTH_MASK)
+                {
+                    out = writeLength(out, matchCode);
+                }
+                literals += it->matchLength;
+            }
+        }
+        // pad to multiple of 4 bytes
+        while ((out - result.data()) & 3)
+        {
+            *out++ = 0;
+        }
+        result.resize(out - result.data());
+        return result;
+    }
+
+    auto LZ4EstimateDecodeCycles(const std::vector<uint8_t> &compressed, const LZ4CostModel &costModel) -> double
+    {
+        if (compressed.size() < 4 || compressed[0] != Lz4Constants::TYPE_MARKER)
+        {
+            return 0;
+        }
+        int32_t remaining = compressed[1] | (compressed[2] << 8) | (compressed[3] << 16);
+        auto readLength = [&](uint32_t &pos, uint32_t length, double &cycles)
+        {
+            if (length == Lz4Constants::LENGTH_MASK)
+            {
+                uint8_t extraLength = 0;
+                do
+                {
+                    extraLength = pos < compressed.size() ? compressed[pos++] : 0;
+                    length += extraLength;
+                    cycles += costModel.extraLengthByteCycles;
+                } while (extraLength == 255);
+            }
+            return length;
+        };
+        double cycles = 0;
+        uint32_t pos = 4;
+        while (remaining > 0 && pos < compressed.size())
+        {
+            const uint8_t token = compressed[pos++];
+            cycles += costModel.tokenCycles;
+            uint32_t literalLength = (token >> Lz4Constants::LITERAL_LENGTH_SHIFT) & Lz4Constants::LENGTH_MASK;
+            if (literalLength > 0)
+            {
+                literalLength = readLength(pos, literalLength, cycles);
+                cycles += costModel.literalRunCycles + literalLength * costModel.literalByteCycles;
+                pos += literalLength;
+                remaining -= literalLength;
+            }
+            uint32_t matchLength = token & Lz4Constants::LENGTH_MASK;
+            if (matchLength > 0 && pos + 2 <= compressed.size())
+            {
+                const uint32_t distance = (compressed[pos] << 8) | compressed[pos + 1];
+                pos += 2;
+                matchLength = readLength(pos, matchLength, cycles) + (Lz4Constants::MIN_MATCH_LENGTH - 1);
+                cycles += costModel.matchCycles + matchLength * (distance <= 2 ? costModel.runByteCycles : costModel.matchByteCycles);
+                remaining -= matchLength;
+            }
+        }
+        return cycles;
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Compression
+{
+    /// @brief Estimated decoding cost of LZ4 variant 40h data for LZ4UnCompWrite8bit_ASM running from IWRAM.
+    /// Numbers are ARM7TDMI cycles derived from the instruction sequences in lz4_asm.s, not measurements
+    struct LZ4CostModel
+    {
+        double tokenCycles = 14;           // Read token, check for literals and match, loop
+        double literalRunCycles = 20;      // Call LZ4_MemCopy16 for a literal run and align source / destination
+        double literalByteCycles = 2.5;    // Copy one literal byte. Mixed halfword / word copies
+        double matchCycles = 28;           // Read match offset, call LZ4_MemCopy16 and restore source
+        double matchByteCycles = 2;        // Copy one match byte
+        double runByteCycles = 0.75;       // Copy one match byte for distance 1 or 2. Filled with word stores
+        double extraLengthByteCycles = 6;  // Read one extra literal or match length byte
+    };
+
+    /// @brief LZ4 variant 40h encoder options
+    struct LZ4EncodeOptions
+    {
+        /// @brief Weight of decoding cycles vs. compressed size. Parsing minimizes bytes + speedWeight * cycles.
+        /// 0 = smallest output. Larger values trade size for faster decoding, e.g. by avoiding short matches and tiny literal runs
+        double speedWeight = 0;
+        /// @brief Maximum number of match candidates checked per position. Higher is slower, but can compress better
+        uint32_t maxCandidates = 256;
+        /// @brief Maximum distance of a match from the current position. Lower it if the decoder only keeps a small window, e.g. Movie::LiteralBufferSize
+        uint32_t maxDistance = 65535;
+        /// @brief Decode cost model used for parsing
+        LZ4CostModel costModel;
+    };
+
+    /// @brief Compress data to LZ4 variant 40h with optimal parsing. Output is padded to a multiple of 4 bytes
+    /// @param data Uncompressed data. Must be < 16 MB
+    /// @param options Encoder options
+    /// @return Compressed data including 4 byte header
+    auto LZ4Compress(const std::vector<uint8_t> &data, const LZ4EncodeOptions &options = LZ4EncodeOptions()) -> std::vector<uint8_t>;
+
+    /// @brief Estimate cycles for decoding LZ4 variant 40h data with LZ4UnCompWrite8bit_ASM
+    /// @param compressed Compressed data including 4 byte header
+    /// @param costModel Decode cost model
+    /// @return Estimated cycles, 0 if the data is not LZ4 variant 40h data
+    auto LZ4EstimateDecodeCycles(const std::vector<uint8_t> &compressed, const LZ4CostModel &costModel = LZ4CostModel()) -> double;
+}
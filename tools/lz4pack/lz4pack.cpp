@@ -0,0 +1,92 @@
+// Compresses files to the LZ4 variant 40h decoded by Compression::LZ4UnCompWrite8bit / 16bit and their ASM versions.
+// Uses optimal parsing with a cost model of the ARM decoder, so you can trade compressed size for decoding speed.
+
+#include "lz4encoder.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+void printUsage()
+{
+    std::cout << "Compress data to LZ4 variant 40h for the GBA decoders." << std::endl;
+    std::cout << "Usage: lz4pack [--speed WEIGHT] [--candidates N] [--report] INPUT_FILE OUTPUT_FILE" << std::endl;
+    std::cout << "--speed WEIGHT: Weight of estimated decoding cycles vs. compressed bytes (default: 0 = smallest size)." << std::endl;
+    std::cout << "Try values from 0.01 to 1. Larger values avoid short matches and tiny literal runs." << std::endl;
+    std::cout << "--candidates N: Maximum match candidates checked per position (default: 256)." << std::endl;
+    std::cout << "--report: Print compressed size and estimated decoding cycles for a range of speed weights." << std::endl;
+}
+
+void printResult(const std::vector<uint8_t> &data, const std::vector<uint8_t> &compressed, double speedWeight)
+{
+    const double cycles = Compression::LZ4EstimateDecodeCycles(compressed);
+    printf("Speed weight %.3f: %u -> %u bytes (%.1f%%), ~%.0f decode cycles (%.2f cycles/byte)\n",
+           speedWeight, static_cast<uint32_t>(data.size()), static_cast<uint32_t>(compressed.size()),
+           data.empty() ? 0.0 : 100.0 * compressed.size() / data.size(), cycles, data.empty() ? 0.0 : cycles / data.size());
+}
+
+int main(int argc, const char *argv[])
+{
+    Compression::LZ4EncodeOptions options;
+    bool report = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+        {
+            options.speedWeight = strtod(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--candidates") == 0 && i + 1 < argc)
+        {
+            options.maxCandidates = strtoul(argv[++i], nullptr, 0);
+        }
+        else if (strcmp(argv[i], "--report") == 0)
+        {
+            report = true;
+        }
+        else
+        {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.size() != 2 || options.speedWeight < 0 || options.maxCandidates == 0)
+    {
+        printUsage();
+        return 1;
+    }
+    std::ifstream inFile(files[0], std::ios::binary);
+    if (!inFile.is_open())
+    {
+        std::cerr << "Failed to open " << files[0] << std::endl;
+        return 1;
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+    if (data.size() >= (1 << 24))
+    {
+        std::cerr << "Input must be smaller than 16 MB" << std::endl;
+        return 1;
+    }
+    if (report)
+    {
+        for (const double weight : {0.0, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0})
+        {
+            auto reportOptions = options;
+            reportOptions.speedWeight = weight;
+            printResult(data, Compression::LZ4Compress(data, reportOptions), weight);
+        }
+    }
+    const auto compressed = Compression::LZ4Compress(data, options);
+    printResult(data, compressed, options.speedWeight);
+    std::ofstream outFile(files[1], std::ios::binary);
+    if (!outFile.is_open() || !outFile.write(reinterpret_cast<const char *>(compressed.data()), compressed.size()))
+    {
+        std::cerr << "Failed to write " << files[1] << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,181 @@
+// Replays allocation traces recorded with TRACE_MEMORY (see src/memory/memory.cpp) against the heap allocator.
+// Use this to find out how big the heaps need to be and how badly they fragment without running the ROM.
+// Record a trace on the GBA with Memory::tracePrint() and pass the emulator log to this tool.
+
+#include <memory/heap.h>
+#include <memory/memory.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct Region
+{
+    const char *name;
+    uint32_t size;
+    std::vector<uint32_t> memory;
+    Memory::Heap *heap = nullptr;
+    uint32_t nrOfMallocs = 0;
+    uint32_t failedOnTarget = 0;
+    uint32_t failedInReplay = 0;
+    uint32_t minLargestFree = 0;
+    uint16_t maxFreeBlocks = 0;
+
+    Region(const char *regionName, uint32_t regionSize)
+        : name(regionName), size(regionSize)
+    {
+    }
+
+    void reset()
+    {
+        // the heap structure has 64-bit pointers on the host. make the region bigger by the difference, so all blocks get the same offsets as on the target
+        const uint32_t hostSize = size + sizeof(Memory::Heap) - Memory::Heap::TargetSize;
+        memory.assign(hostSize / 4, 0);
+        heap = Memory::Heap::create(memory.data(), hostSize);
+        minLargestFree = heap != nullptr ? heap->stats().largestFree : 0;
+        maxFreeBlocks = 0;
+    }
+
+    void updateFragmentation()
+    {
+        const auto stats = heap->stats();
+        minLargestFree = stats.largestFree < minLargestFree ? stats.largestFree : minLargestFree;
+        maxFreeBlocks = stats.freeBlocks > maxFreeBlocks ? stats.freeBlocks : maxFreeBlocks;
+    }
+
+    void print() const
+    {
+        const auto stats = heap->stats();
+        printf("%s heap, %u bytes:\n", name, size);
+        printf("  Allocations: %u, failed on target: %u, failed in replay: %u\n", nrOfMallocs, failedOnTarget, failedInReplay);
+        printf("  Still allocated: %u bytes in %u blocks, free: %u bytes in %u blocks\n", stats.used, stats.usedBlocks, stats.free, stats.freeBlocks);
+        printf("  High watermark: %u bytes\n", stats.highWatermark);
+        printf("  Smallest largest free block: %u bytes, most free blocks: %u\n", minLargestFree, maxFreeBlocks);
+    }
+};
+
+void printUsage()
+{
+    std::cout << "Replay GBA allocation traces against the heap allocator." << std::endl;
+    std::cout << "Usage: memtrace [--iwram BYTES] [--ewram BYTES] TRACE_FILE" << std::endl;
+    std::cout << "--iwram BYTES: Size of IWRAM heap region (default: 16384)." << std::endl;
+    std::cout << "--ewram BYTES: Size of EWRAM heap region (default: 258048)." << std::endl;
+    std::cout << "TRACE_FILE: Text file containing lines \"memtrace <address> <info>\" as printed by Memory::tracePrint()." << std::endl;
+    std::cout << "Other lines, e.g. emulator log output, are ignored." << std::endl;
+}
+
+int main(int argc, const char *argv[])
+{
+    Region iwram{"IWRAM", 16384};
+    Region ewram{"EWRAM", 256 * 1024 - 4096};
+    std::string traceFile;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--iwram") == 0 && i + 1 < argc)
+        {
+            iwram.size = strtoul(argv[++i], nullptr, 0);
+        }
+        else if (strcmp(argv[i], "--ewram") == 0 && i + 1 < argc)
+        {
+            ewram.size = strtoul(argv[++i], nullptr, 0);
+        }
+        else
+        {
+            traceFile = argv[i];
+        }
+    }
+    if (traceFile.empty())
+    {
+        printUsage();
+        return 1;
+    }
+    std::ifstream file(traceFile);
+    if (!file.is_open())
+    {
+        std::cerr << "Failed to open " << traceFile << std::endl;
+        return 1;
+    }
+    iwram.reset();
+    ewram.reset();
+    if (iwram.heap == nullptr || ewram.heap == nullptr)
+    {
+        std::cerr << "Heap size too small" << std::endl;
+        return 1;
+    }
+    // map target addresses to replay addresses, so we can free the right blocks
+    std::unordered_map<uint32_t, void *> addresses;
+    uint32_t nrOfEntries = 0;
+    uint32_t nrOfLostEntries = 0;
+    uint32_t nrOfUnmatchedFrees = 0;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        const auto pos = line.find("memtrace ");
+        if (pos != std::string::npos && sscanf(line.c_str() + pos + 9, "lost %u", &nrOfLostEntries) == 1)
+        {
+            std::cerr << "Warning: " << nrOfLostEntries << " trace entries were lost on the target. Replay starts in the middle of the trace" << std::endl;
+            continue;
+        }
+        Memory::TraceEntry entry;
+        if (pos == std::string::npos || sscanf(line.c_str() + pos + 9, "%x %x", &entry.address, &entry.info) != 2)
+        {
+            continue;
+        }
+        nrOfEntries++;
+        const auto op = static_cast<Memory::TraceOp>(entry.info >> 24);
+        const uint32_t size = entry.info & 0xFFFFFF;
+        switch (op)
+        {
+        case Memory::TraceOp::Init:
+            iwram.reset();
+            ewram.reset();
+            addresses.clear();
+            break;
+        case Memory::TraceOp::MallocIWRAM:
+        case Memory::TraceOp::MallocEWRAM:
+        {
+            auto &region = op == Memory::TraceOp::MallocIWRAM ? iwram : ewram;
+            region.nrOfMallocs++;
+            region.failedOnTarget += entry.address == 0 ? 1 : 0;
+            void *address = region.heap->malloc(size);
+            region.failedInReplay += address == nullptr ? 1 : 0;
+            if (entry.address != 0 && address != nullptr)
+            {
+                addresses[entry.address] = address;
+            }
+            region.updateFragmentation();
+            break;
+        }
+        case Memory::TraceOp::Free:
+        {
+            auto it = addresses.find(entry.address);
+            if (it != addresses.end())
+            {
+                auto &region = iwram.heap->contains(it->second) ? iwram : ewram;
+                region.heap->free(it->second);
+                region.updateFragmentation();
+                addresses.erase(it);
+            }
+            else
+            {
+                // allocation was lost from the trace, failed in replay or the address was freed twice
+                std::cerr << "Warning: Free of 0x" << std::hex << entry.address << std::dec << " without matching allocation" << std::endl;
+                nrOfUnmatchedFrees++;
+            }
+            break;
+        }
+        default:
+            std::cerr << "Unknown trace operation " << (entry.info >> 24) << std::endl;
+            break;
+        }
+    }
+    printf("Replayed %u trace entries, %u lost on target, %u frees without matching allocation\n", nrOfEntries, nrOfLostEntries, nrOfUnmatchedFrees);
+    iwram.print();
+    ewram.print();
+    return 0;
+}
@@ -0,0 +1,238 @@
+#include "movieencoder.h"
+
+#include "movie.h"
+
+#include <cstdlib>
+
+namespace Movie
+{
+    // Rough ARM7TDMI decoding cost of Movie::decodeFrame running from IWRAM, not measurements
+    constexpr double BlockCycles = 12;            // Read block type, loop
+    constexpr double CopyBlockCycles = 20;        // Read motion vector, compute source address
+    constexpr double CopyWordCycles = 6;          // Copy one word from VRAM to VRAM
+    constexpr double LiteralWordCycles = 5;       // Copy one word from IWRAM to VRAM
+    constexpr double LiteralStreamCostFactor = 2; // LZ4StreamDecode in C vs. the LZ4UnCompWrite8bit_ASM cost model
+
+    // Simulated frame buffer of the decoder. Pixels written before the first frame are unknown, because the buffers
+    // hold whatever was on screen before or the end of the movie when looping
+    struct Buffer
+    {
+        std::vector<uint8_t> pixels;
+        std::vector<bool> known; // One flag per byte
+    };
+
+    template <typename T>
+    void append(std::vector<uint8_t> &data, const T &value)
+    {
+        auto bytes = reinterpret_cast<const uint8_t *>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+
+    void padTo4(std::vector<uint8_t> &data)
+    {
+        while ((data.size() & 3) != 0)
+        {
+            data.push_back(0);
+        }
+    }
+
+    // Check if all bytes of a block are known and equal to the frame
+    bool isBlockEqual(const Buffer &buffer, const std::vector<uint8_t> &frame, uint32_t offset, uint32_t rowBytes, uint32_t rows, uint32_t stride)
+    {
+        for (uint32_t y = 0; y < rows; ++y)
+        {
+            for (uint32_t x = 0; x < rowBytes; ++x)
+            {
+                const uint32_t i = offset + y * stride + x;
+                if (!buffer.known[i] || buffer.pixels[i] != frame[i])
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Check if a block copied from source is equal to the frame. Source bytes must be known
+    bool isCopyEqual(const Buffer &source, const std::vector<uint8_t> &frame, uint32_t dstOffset, uint32_t srcOffset, uint32_t rowBytes, uint32_t rows, uint32_t stride)
+    {
+        for (uint32_t y = 0; y < rows; ++y)
+        {
+            for (uint32_t x = 0; x < rowBytes; ++x)
+            {
+                const uint32_t i = srcOffset + y * stride + x;
+                if (!source.known[i] || source.pixels[i] != frame[dstOffset + y * stride + x])
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Copy a block of the simulated buffers. Source and destination never overlap
+    void copyBlock(Buffer &dst, const Buffer &src, uint32_t dstOffset, uint32_t srcOffset, uint32_t rowBytes, uint32_t rows, uint32_t stride)
+    {
+        for (uint32_t y = 0; y < rows; ++y)
+        {
+            for (uint32_t x = 0; x < rowBytes; ++x)
+            {
+                dst.pixels[dstOffset + y * stride + x] = src.pixels[srcOffset + y * stride + x];
+                dst.known[dstOffset + y * stride + x] = src.known[srcOffset + y * stride + x];
+            }
+        }
+    }
+
+    auto encodeMovie(const std::vector<std::vector<uint8_t>> &frames, const std::vector<uint16_t> &palette, const EncodeOptions &options, EncodeStats *stats) -> std::vector<uint8_t>
+    {
+        const uint32_t bpp = options.bytesPerPixel;
+        const uint32_t blockSize = options.blockSize;
+        const uint32_t stride = options.width * bpp;
+        const uint32_t frameBytes = stride * options.height;
+        if ((bpp != 1 && bpp != 2) || (blockSize != 4 && blockSize != 8) || (options.nrOfBuffers != 1 && options.nrOfBuffers != 2) ||
+            options.width == 0 || options.height == 0 || options.width > 0xFFFF || options.height > 0xFFFF ||
+            (options.width % blockSize) != 0 || (options.height % blockSize) != 0 ||
+            options.framesPerSecond == 0 || options.framesPerSecond > 60 || options.motionRange > uint32_t(MaxMotion) ||
+            frames.empty() || frames.size() > 0xFFFF || palette.size() > 256 || (bpp == 2 && !palette.empty()))
+        {
+            return {};
+        }
+        for (const auto &frame : frames)
+        {
+            if (frame.size() != frameBytes)
+            {
+                return {};
+            }
+        }
+        const uint32_t rowBytes = blockSize * bpp;
+        const uint32_t blocksX = options.width / blockSize;
+        const uint32_t blocksY = options.height / blockSize;
+        const int32_t dxStep = 4 / bpp;
+        auto lz4Options = options.lz4Options;
+        lz4Options.maxDistance = lz4Options.maxDistance < LiteralBufferSize ? lz4Options.maxDistance : LiteralBufferSize;
+        EncodeStats encodeStats;
+        // header and palette
+        std::vector<uint8_t> data;
+        MovieHeader header = {MovieMagic, uint16_t(options.width), uint16_t(options.height), uint16_t(frames.size()), uint16_t(palette.size()),
+                              uint8_t(options.framesPerSecond), uint8_t(bpp), uint8_t(blockSize), uint8_t(options.nrOfBuffers)};
+        append(data, header);
+        for (auto color : palette)
+        {
+            append(data, color);
+        }
+        padTo4(data);
+        // with two buffers frame n is decoded into buffer n % 2 and copies from the other one
+        std::vector<Buffer> buffers(options.nrOfBuffers, Buffer{std::vector<uint8_t>(frameBytes, 0), std::vector<bool>(frameBytes, false)});
+        for (uint32_t n = 0; n < frames.size(); ++n)
+        {
+            const auto &frame = frames[n];
+            auto &back = buffers[n % options.nrOfBuffers];
+            const auto &front = buffers[(n + 1) % options.nrOfBuffers];
+            std::vector<uint32_t> types((blocksX * blocksY + 15) / 16, 0);
+            std::vector<int8_t> motion;
+            std::vector<uint8_t> literals;
+            for (uint32_t by = 0; by < blocksY; ++by)
+            {
+                for (uint32_t bx = 0; bx < blocksX; ++bx)
+                {
+                    const uint32_t block = by * blocksX + bx;
+                    const uint32_t offset = by * blockSize * stride + bx * rowBytes;
+                    BlockType type = BlockType::Literal;
+                    if (isBlockEqual(back, frame, offset, rowBytes, blockSize, stride))
+                    {
+                        type = BlockType::Skip;
+                    }
+                    else
+                    {
+                        // use the nearest matching motion offset, so static content stays static
+                        const int32_t range = options.motionRange;
+                        int32_t bestDx = 0;
+                        int32_t bestDy = 0;
+                        int32_t bestDistance = -1;
+                        for (int32_t dy = -range; dy <= range; ++dy)
+                        {
+                            const int32_t y = int32_t(by * blockSize) + dy;
+                            if (y < 0 || y + int32_t(blockSize) > int32_t(options.height))
+                            {
+                                continue;
+                            }
+                            for (int32_t dx = -(range / dxStep) * dxStep; dx <= range; dx += dxStep)
+                            {
+                                const int32_t x = int32_t(bx * blockSize) + dx;
+                                const int32_t distance = std::abs(dx) + std::abs(dy);
+                                if (x < 0 || x + int32_t(blockSize) > int32_t(options.width) || (bestDistance >= 0 && distance >= bestDistance))
+                                {
+                                    continue;
+                                }
+                                // with one buffer the decoder copies within the back buffer. don't let source and
+                                // destination overlap, so the result does not depend on the copy order
+                                if (options.nrOfBuffers == 1 && std::abs(dx) < int32_t(blockSize) && std::abs(dy) < int32_t(blockSize))
+                                {
+                                    continue;
+                                }
+                                if (isCopyEqual(front, frame, offset, y * stride + x * bpp, rowBytes, blockSize, stride))
+                                {
+                                    bestDx = dx;
+                                    bestDy = dy;
+                                    bestDistance = distance;
+                                }
+                            }
+                        }
+                        if (bestDistance >= 0)
+                        {
+                            type = BlockType::Copy;
+                            motion.push_back(bestDx);
+                            motion.push_back(bestDy);
+                            copyBlock(back, front, offset, (by * blockSize + bestDy) * stride + (bx * blockSize + bestDx) * bpp, rowBytes, blockSize, stride);
+                        }
+                    }
+                    if (type == BlockType::Literal)
+                    {
+                        for (uint32_t y = 0; y < blockSize; ++y)
+                        {
+                            for (uint32_t x = 0; x < rowBytes; ++x)
+                            {
+                                const uint32_t i = offset + y * stride + x;
+                                literals.push_back(frame[i]);
+                                back.pixels[i] = frame[i];
+                                back.known[i] = true;
+                            }
+                        }
+                    }
+                    types[block / 16] |= uint32_t(type) << (2 * (block % 16));
+                    encodeStats.skipBlocks += type == BlockType::Skip ? 1 : 0;
+                    encodeStats.copyBlocks += type == BlockType::Copy ? 1 : 0;
+                    encodeStats.literalBlocks += type == BlockType::Literal ? 1 : 0;
+                }
+            }
+            // frame header, block types, motion vectors, literal data
+            const uint32_t frameStart = data.size();
+            const uint32_t nrOfLiteralBlocks = literals.size() / (rowBytes * blockSize);
+            FrameHeader frameHeader = {0, uint16_t(motion.size() / 2), uint16_t(nrOfLiteralBlocks)};
+            append(data, frameHeader);
+            for (auto bits : types)
+            {
+                append(data, bits);
+            }
+            data.insert(data.end(), motion.cbegin(), motion.cend());
+            padTo4(data);
+            double cycles = blocksX * blocksY * BlockCycles + frameHeader.nrOfCopyBlocks * (CopyBlockCycles + CopyWordCycles * rowBytes * blockSize / 4);
+            if (!literals.empty())
+            {
+                const auto compressed = Compression::LZ4Compress(literals, lz4Options);
+                data.insert(data.end(), compressed.cbegin(), compressed.cend());
+                cycles += LiteralStreamCostFactor * Compression::LZ4EstimateDecodeCycles(compressed, lz4Options.costModel) + LiteralWordCycles * literals.size() / 4;
+            }
+            padTo4(data);
+            const uint32_t frameSize = data.size() - frameStart;
+            *reinterpret_cast<uint32_t *>(&data[frameStart]) = frameSize;
+            encodeStats.maxFrameSize = frameSize > encodeStats.maxFrameSize ? frameSize : encodeStats.maxFrameSize;
+            encodeStats.maxFrameCycles = cycles > encodeStats.maxFrameCycles ? cycles : encodeStats.maxFrameCycles;
+        }
+        if (stats != nullptr)
+        {
+            *stats = encodeStats;
+        }
+        return data;
+    }
+}
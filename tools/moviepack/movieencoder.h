@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../lz4pack/lz4encoder.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Movie
+{
+    /// @brief Movie encoder options
+    struct EncodeOptions
+    {
+        uint32_t width = 240;          // Frame width in pixels
+        uint32_t height = 160;         // Frame height in pixels
+        uint32_t bytesPerPixel = 1;    // 1 for paletted mode 4 frames, 2 for BGR555 mode 3 / 5 frames
+        uint32_t blockSize = 8;        // Block width and height in pixels. 4 or 8
+        uint32_t nrOfBuffers = 2;      // Frame buffers of the graphics mode. 2 for mode 4 and 5, 1 for mode 3
+        uint32_t framesPerSecond = 30; // Playback rate
+        uint32_t motionRange = 16;     // Maximum motion offset searched for copy blocks in pixels. Up to Movie::MaxMotion
+        /// @brief Options for compressing literal blocks. maxDistance is limited to Movie::LiteralBufferSize
+        Compression::LZ4EncodeOptions lz4Options;
+    };
+
+    /// @brief Encoder statistics
+    struct EncodeStats
+    {
+        uint32_t skipBlocks = 0;    // Number of blocks kept from the back buffer
+        uint32_t copyBlocks = 0;    // Number of blocks copied from the previous frame
+        uint32_t literalBlocks = 0; // Number of blocks stored as LZ4 literal data
+        uint32_t maxFrameSize = 0;  // Size of the largest frame in bytes
+        double maxFrameCycles = 0;  // Estimated decoding cycles of the most expensive frame
+    };
+
+    /// @brief Encode frames losslessly to a movie for Movie::play(). The encoder simulates the frame buffers of the
+    /// decoder, so blocks are only skipped or copied if the decoder ends up with exactly the same pixels.
+    /// @param frames Frames of width * height pixels with bytesPerPixel bytes each
+    /// @param palette Palette colors for 8-bit pixels. Empty for 16-bit pixels. Up to 256 colors
+    /// @param options Encoder options
+    /// @param stats If not nullptr, receives encoder statistics
+    /// @return Movie data starting with a Movie::MovieHeader. Empty if the options or frames are invalid
+    auto encodeMovie(const std::vector<std::vector<uint8_t>> &frames, const std::vector<uint16_t> &palette, const EncodeOptions &options = EncodeOptions(), EncodeStats *stats = nullptr) -> std::vector<uint8_t>;
+}
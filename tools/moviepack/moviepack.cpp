@@ -0,0 +1,145 @@
+// Encodes raw frames to the block-based delta video played by Movie::play().
+// Frames are split into blocks that are skipped, copied from the previous frame with a motion offset or stored as LZ4 data.
+
+#include "movieencoder.h"
+
+#include "movie.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+void printUsage()
+{
+    std::cout << "Encode raw frames to a movie for Movie::play()." << std::endl;
+    std::cout << "Usage: moviepack [--size WIDTHxHEIGHT] [--bpp 1|2] [--palette FILE] [--block 4|8] [--buffers 1|2] [--fps N] [--range N] [--speed WEIGHT] INPUT_FILE OUTPUT_FILE" << std::endl;
+    std::cout << "INPUT_FILE: Concatenated raw frames, 8-bit palette indices or 16-bit BGR555 pixels, e.g. from" << std::endl;
+    std::cout << "ffmpeg -i in.mp4 -vf scale=240:160 -r 30 -pix_fmt bgr555le -f rawvideo frames.raw" << std::endl;
+    std::cout << "--size WIDTHxHEIGHT: Frame size in pixels (default: 240x160)." << std::endl;
+    std::cout << "--bpp 1|2: Bytes per pixel. 1 for mode 4, 2 for mode 3 and 5 (default: 1)." << std::endl;
+    std::cout << "--palette FILE: Raw BGR555 palette for 8-bit frames, up to 256 colors." << std::endl;
+    std::cout << "--block 4|8: Block size in pixels (default: 8). 4 finds more skip and copy blocks, 8 decodes faster." << std::endl;
+    std::cout << "--buffers 1|2: Frame buffers of the graphics mode. 2 for mode 4 and 5, 1 for mode 3 (default: 2)." << std::endl;
+    std::cout << "--fps N: Playback rate in frames per second (default: 30)." << std::endl;
+    std::cout << "--range N: Maximum motion offset searched in pixels, up to " << Movie::MaxMotion << " (default: 16)." << std::endl;
+    std::cout << "--speed WEIGHT: LZ4 decoding speed vs. size weight for literal blocks, see lz4pack (default: 0)." << std::endl;
+}
+
+bool readFile(const std::string &fileName, std::vector<uint8_t> &data)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Failed to open " << fileName << std::endl;
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+int main(int argc, const char *argv[])
+{
+    Movie::EncodeOptions options;
+    std::string paletteFile;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+        {
+            char *end = nullptr;
+            options.width = strtoul(argv[++i], &end, 0);
+            options.height = (*end == 'x') ? strtoul(end + 1, nullptr, 0) : 0;
+        }
+        else if (strcmp(argv[i], "--bpp") == 0 && i + 1 < argc)
+        {
+            options.bytesPerPixel = strtoul(argv[++i], nullptr, 0);
+        }
+        else if (strcmp(argv[i], "--palette") == 0 && i + 1 < argc)
+        {
+            paletteFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--block") == 0 && i + 1 < argc)
+        {
+            options.blockSize = strtoul(argv[++i], nullptr, 0);
+        }
+        else if (strcmp(argv[i], "--buffers") == 0 && i + 1 < argc)
+        {
+            options.nrOfBuffers = strtoul(argv[++i], nullptr, 0);
+        }
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+        {
+            options.framesPerSecond = strtoul(argv[++i], nullptr, 0);
+        }
+        else if (strcmp(argv[i], "--range") == 0 && i + 1 < argc)
+        {
+            options.motionRange = strtoul(argv[++i], nullptr, 0);
+        }
+        else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+        {
+            options.lz4Options.speedWeight = strtod(argv[++i], nullptr);
+        }
+        else
+        {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.size() != 2 || options.lz4Options.speedWeight < 0)
+    {
+        printUsage();
+        return 1;
+    }
+    std::vector<uint16_t> palette;
+    if (!paletteFile.empty())
+    {
+        std::vector<uint8_t> paletteData;
+        if (!readFile(paletteFile, paletteData))
+        {
+            return 1;
+        }
+        for (uint32_t i = 0; i + 1 < paletteData.size(); i += 2)
+        {
+            palette.push_back(paletteData[i] | (paletteData[i + 1] << 8));
+        }
+    }
+    std::vector<uint8_t> data;
+    if (!readFile(files[0], data))
+    {
+        return 1;
+    }
+    const uint32_t frameBytes = options.width * options.height * options.bytesPerPixel;
+    if (frameBytes == 0 || data.empty() || (data.size() % frameBytes) != 0)
+    {
+        std::cerr << "Input size must be a multiple of the frame size" << std::endl;
+        return 1;
+    }
+    std::vector<std::vector<uint8_t>> frames;
+    for (uint32_t offset = 0; offset < data.size(); offset += frameBytes)
+    {
+        frames.emplace_back(data.cbegin() + offset, data.cbegin() + offset + frameBytes);
+    }
+    Movie::EncodeStats stats;
+    const auto movie = Movie::encodeMovie(frames, palette, options, &stats);
+    if (movie.empty())
+    {
+        std::cerr << "Invalid options or frames" << std::endl;
+        printUsage();
+        return 1;
+    }
+    const uint32_t nrOfBlocks = stats.skipBlocks + stats.copyBlocks + stats.literalBlocks;
+    printf("%u frames: %u -> %u bytes (%.1f%%), %.1f KB/s\n", static_cast<uint32_t>(frames.size()), static_cast<uint32_t>(data.size()),
+           static_cast<uint32_t>(movie.size()), 100.0 * movie.size() / data.size(), movie.size() * options.framesPerSecond / (1024.0 * frames.size()));
+    printf("Blocks: %.1f%% skip, %.1f%% copy, %.1f%% literal\n", 100.0 * stats.skipBlocks / nrOfBlocks, 100.0 * stats.copyBlocks / nrOfBlocks, 100.0 * stats.literalBlocks / nrOfBlocks);
+    printf("Largest frame: %u bytes, ~%.0f decode cycles (%.0f available per frame)\n", stats.maxFrameSize, stats.maxFrameCycles, 16777216.0 / options.framesPerSecond);
+    std::ofstream outFile(files[1], std::ios::binary);
+    if (!outFile.is_open() || !outFile.write(reinterpret_cast<const char *>(movie.data()), movie.size()))
+    {
+        std::cerr << "Failed to write " << files[1] << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include "ransencoder.h"
+
+#include "compression/rans.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Compression
+{
+    constexpr uint32_t ProbabilityScale = 1 << RANSProbabilityBits;
+
+    // Scale symbol counts to frequencies summing up to ProbabilityScale. Every used symbol keeps a frequency >= 1.
+    // Rounding errors are fixed by changing the frequencies where it costs the least bits
+    std::vector<uint32_t> normalizeFrequencies(const std::vector<uint32_t> &counts, uint32_t total)
+    {
+        std::vector<uint32_t> frequencies(256, 0);
+        int32_t sum = 0;
+        for (uint32_t s = 0; s < 256; ++s)
+        {
+            if (counts[s] > 0)
+            {
+                frequencies[s] = std::max<uint32_t>(1, static_cast<uint32_t>(static_cast<uint64_t>(counts[s]) * ProbabilityScale / total));
+                sum += frequencies[s];
+            }
+        }
+        while (sum != int32_t(ProbabilityScale))
+        {
+            const int32_t step = sum < int32_t(ProbabilityScale) ? 1 : -1;
+            int32_t best = -1;
+            double bestCost = 0;
+            for (uint32_t s = 0; s < 256; ++s)
+            {
+                if (counts[s] == 0 || (step < 0 && frequencies[s] == 1))
+                {
+                    continue;
+                }
+                // change of encoded size in bits
+                const double cost = counts[s] * std::log2(double(frequencies[s]) / double(frequencies[s] + step));
+                if (best < 0 || cost < bestCost)
+                {
+                    best = s;
+                    bestCost = cost;
+                }
+            }
+            frequencies[best] += step;
+            sum += step;
+        }
+        return frequencies;
+    }
+
+    void padTo4(std::vector<uint8_t> &data)
+    {
+        while ((data.size() & 3) != 0)
+        {
+            data.push_back(0);
+        }
+    }
+
+    void appendWord(std::vector<uint8_t> &data, uint32_t value)
+    {
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            data.push_back((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    auto RANSCompress(const std::vector<uint8_t> &data) -> std::vector<uint8_t>
+    {
+        const uint32_t size = data.size();
+        std::vector<uint8_t> result;
+        appendWord(result, RANSTypeMarker | (size << 8));
+        if (size == 0)
+        {
+            return result;
+        }
+        // symbol frequencies
+        std::vector<uint32_t> counts(256, 0);
+        for (auto symbol : data)
+        {
+            counts[symbol]++;
+        }
+        const auto frequencies = normalizeFrequencies(counts, size);
+        std::vector<uint32_t> cumulative(256, 0);
+        for (uint32_t s = 1; s < 256; ++s)
+        {
+            cumulative[s] = cumulative[s - 1] + frequencies[s - 1];
+        }
+        for (uint32_t s = 0; s < 256;)
+        {
+            const uint32_t frequency = frequencies[s];
+            if (frequency == 0)
+            {
+                // count following unused symbols
+                uint32_t zeros = 0;
+                while (s + 1 + zeros < 256 && zeros < 255 && frequencies[s + 1 + zeros] == 0)
+                {
+                    zeros++;
+                }
+                result.push_back(0);
+                result.push_back(zeros);
+                s += 1 + zeros;
+                continue;
+            }
+            if (frequency < 0x80)
+            {
+                result.push_back(frequency);
+            }
+            else
+            {
+                result.push_back(0x80 | (frequency >> 8));
+                result.push_back(frequency & 0xFF);
+            }
+            s++;
+        }
+        padTo4(result);
+        // encode backwards, so the decoder reads symbols and renormalization bytes forwards
+        std::vector<uint8_t> stream;
+        uint32_t state = RANSStateLow;
+        for (uint32_t i = size; i-- > 0;)
+        {
+            const uint32_t frequency = frequencies[data[i]];
+            const uint64_t stateMax = static_cast<uint64_t>((RANSStateLow >> RANSProbabilityBits) << 8) * frequency;
+            while (state >= stateMax)
+            {
+                stream.push_back(state & 0xFF);
+                state >>= 8;
+            }
+            state = ((state / frequency) << RANSProbabilityBits) + (state % frequency) + cumulative[data[i]];
+        }
+        appendWord(result, state);
+        result.insert(result.end(), stream.crbegin(), stream.crend());
+        padTo4(result);
+        return result;
+    }
+
+    auto RANSLZ4Compress(const std::vector<uint8_t> &data, const LZ4EncodeOptions &options) -> std::vector<uint8_t>
+    {
+        const auto lz4 = LZ4Compress(data, options);
+        const auto rans = RANSCompress(lz4);
+        std::vector<uint8_t> result;
+        appendWord(result, RANSLZ4TypeMarker | (static_cast<uint32_t>(data.size()) << 8));
+        result.insert(result.end(), rans.cbegin(), rans.cend());
+        return result;
+    }
+
+    auto RANSEstimateDecodeCycles(const std::vector<uint8_t> &compressed, const RANSCostModel &costModel) -> double
+    {
+        if (compressed.size() < 4 || compressed[0] != RANSTypeMarker)
+        {
+            return 0;
+        }
+        const uint32_t size = compressed[1] | (compressed[2] << 8) | (compressed[3] << 16);
+        if (size == 0)
+        {
+            return 0;
+        }
+        // skip frequency table to get the number of renormalization bytes
+        uint32_t pos = 4;
+        for (uint32_t s = 0; s < 256 && pos < compressed.size(); ++s)
+        {
+            uint32_t frequency = compressed[pos++];
+            if (frequency >= 0x80)
+            {
+                frequency = ((frequency & 0x7F) << 8) | compressed[pos++];
+            }
+            if (frequency == 0)
+            {
+                s += compressed[pos++];
+            }
+        }
+        pos = ((pos + 3) & ~3) + 4;
+        const double renormBytes = compressed.size() > pos ? compressed.size() - pos : 0;
+        return costModel.tableCycles + ProbabilityScale * costModel.slotCycles + size * costModel.symbolCycles + renormBytes * costModel.renormByteCycles;
+    }
+}
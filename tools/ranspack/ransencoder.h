@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../lz4pack/lz4encoder.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Compression
+{
+    /// @brief Estimated decoding cost of rANS variant 50h data for RANSUnCompWrite8bit_ASM running from IWRAM.
+    /// Numbers are ARM7TDMI cycles derived from the instruction sequences in rans_asm.s, not measurements
+    struct RANSCostModel
+    {
+        double tableCycles = 600;    // Read frequencies and store symbol info, call overhead
+        double slotCycles = 1.5;     // Fill one frequency slot with its symbol. Mostly word stores
+        double symbolCycles = 24;    // Decode one symbol, including loop overhead
+        double renormByteCycles = 4; // Read one renormalization byte
+    };
+
+    /// @brief Compress data to rANS variant 50h. Output is padded to a multiple of 4 bytes
+    /// @param data Uncompressed data. Must be < 16 MB
+    /// @return Compressed data including 4 byte header
+    auto RANSCompress(const std::vector<uint8_t> &data) -> std::vector<uint8_t>;
+
+    /// @brief Compress data to LZ4 variant 40h, then entropy code that with rANS to variant 51h
+    /// @param data Uncompressed data. Must be < 16 MB
+    /// @param options LZ4 encoder options
+    /// @return Compressed data including 4 byte header
+    auto RANSLZ4Compress(const std::vector<uint8_t> &data, const LZ4EncodeOptions &options = LZ4EncodeOptions()) -> std::vector<uint8_t>;
+
+    /// @brief Estimate cycles for decoding rANS variant 50h data with RANSUnCompWrite8bit_ASM
+    /// @param compressed Compressed data including 4 byte header
+    /// @param costModel Decode cost model
+    /// @return Estimated cycles, 0 if the data is not rANS variant 50h data
+    auto RANSEstimateDecodeCycles(const std::vector<uint8_t> &compressed, const RANSCostModel &costModel = RANSCostModel()) -> double;
+}
@@ -0,0 +1,96 @@
+// Compresses files to the rANS variants 50h / 51h decoded by Compression::RANSUnCompWrite8bit_ASM / RANSUnCompWrite8bitIWRAM.
+// rANS 50h is order-0 entropy coding, rANS 51h entropy codes LZ4 40h data.
+
+#include "ransencoder.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+void printUsage()
+{
+    std::cout << "Compress data to rANS variant 50h or 51h for the GBA decoders." << std::endl;
+    std::cout << "Usage: ranspack [--lz4] [--speed WEIGHT] [--report] INPUT_FILE OUTPUT_FILE" << std::endl;
+    std::cout << "--lz4: Compress with LZ4 first, then entropy code the LZ4 data (variant 51h)." << std::endl;
+    std::cout << "--speed WEIGHT: LZ4 speed weight, see lz4pack (default: 0)." << std::endl;
+    std::cout << "--report: Print compressed size and estimated decoding cycles for LZ4, rANS and LZ4 + rANS." << std::endl;
+}
+
+void printResult(const char *name, const std::vector<uint8_t> &data, const std::vector<uint8_t> &compressed, double cycles)
+{
+    printf("%s: %u -> %u bytes (%.1f%%), ~%.0f decode cycles (%.2f cycles/byte)\n", name,
+           static_cast<uint32_t>(data.size()), static_cast<uint32_t>(compressed.size()),
+           data.empty() ? 0.0 : 100.0 * compressed.size() / data.size(), cycles, data.empty() ? 0.0 : cycles / data.size());
+}
+
+int main(int argc, const char *argv[])
+{
+    Compression::LZ4EncodeOptions options;
+    bool lz4 = false;
+    bool report = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--lz4") == 0)
+        {
+            lz4 = true;
+        }
+        else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+        {
+            options.speedWeight = strtod(argv[++i], nullptr);
+        }
+        else if (strcmp(argv[i], "--report") == 0)
+        {
+            report = true;
+        }
+        else
+        {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.size() != 2 || options.speedWeight < 0)
+    {
+        printUsage();
+        return 1;
+    }
+    std::ifstream inFile(files[0], std::ios::binary);
+    if (!inFile.is_open())
+    {
+        std::cerr << "Failed to open " << files[0] << std::endl;
+        return 1;
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+    if (data.size() >= (1 << 24))
+    {
+        std::cerr << "Input must be smaller than 16 MB" << std::endl;
+        return 1;
+    }
+    // LZ4 + rANS decoding costs the rANS pass over the LZ4 data plus the LZ4 pass
+    const auto lz4Data = Compression::LZ4Compress(data, options);
+    const auto ransLz4Data = Compression::RANSCompress(lz4Data);
+    const double ransLz4Cycles = Compression::RANSEstimateDecodeCycles(ransLz4Data) + Compression::LZ4EstimateDecodeCycles(lz4Data, options.costModel);
+    if (report)
+    {
+        printResult("LZ4 40h", data, lz4Data, Compression::LZ4EstimateDecodeCycles(lz4Data, options.costModel));
+        const auto ransData = Compression::RANSCompress(data);
+        printResult("rANS 50h", data, ransData, Compression::RANSEstimateDecodeCycles(ransData));
+        printResult("LZ4 + rANS 51h", data, Compression::RANSLZ4Compress(data, options), ransLz4Cycles);
+    }
+    const auto compressed = lz4 ? Compression::RANSLZ4Compress(data, options) : Compression::RANSCompress(data);
+    if (!report)
+    {
+        printResult(lz4 ? "LZ4 + rANS 51h" : "rANS 50h", data, compressed, lz4 ? ransLz4Cycles : Compression::RANSEstimateDecodeCycles(compressed));
+    }
+    std::ofstream outFile(files[1], std::ios::binary);
+    if (!outFile.is_open() || !outFile.write(reinterpret_cast<const char *>(compressed.data()), compressed.size()))
+    {
+        std::cerr << "Failed to write " << files[1] << std::endl;
+        return 1;
+    }
+    return 0;
+}